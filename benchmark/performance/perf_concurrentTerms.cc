@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <logics/Logic.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace opensmt;
+
+namespace {
+// Builds a conjunction of equalities over applications of f; different seeds share most of their subterms
+PTRef buildFormula(Logic & logic, SymRef f, std::vector<PTRef> const & vars, int seed) {
+    int n = static_cast<int>(vars.size());
+    vec<PTRef> conjuncts;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            PTRef app = logic.mkUninterpFun(f, {vars[i], vars[(i * j + seed) % n]});
+            PTRef inner = logic.mkUninterpFun(f, {app, vars[j]});
+            conjuncts.push(logic.mkOr(logic.mkEq(inner, vars[(i + seed) % n]), logic.mkEq(app, vars[j])));
+        }
+    }
+    return logic.mkAnd(std::move(conjuncts));
+}
+} // namespace
+
+static void BM_ConcurrentConstruction(benchmark::State & st) {
+    int const numThreads = static_cast<int>(st.range(0));
+    constexpr int numFormulas = 32;
+    for (auto _ : st) {
+        st.PauseTiming();
+        Logic logic{Logic_t::QF_UF};
+        SRef U = logic.declareUninterpretedSort("U");
+        SymRef f = logic.declareFun("f", U, {U, U});
+        std::vector<PTRef> vars;
+        for (int i = 0; i < 40; ++i) {
+            vars.push_back(logic.mkVar(U, ("x" + std::to_string(i)).c_str()));
+        }
+        st.ResumeTiming();
+
+        logic.beginConcurrentConstruction(1 << 18, 1 << 20);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int k = t; k < numFormulas; k += numThreads) {
+                    benchmark::DoNotOptimize(buildFormula(logic, f, vars, k));
+                }
+            });
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+        logic.endConcurrentConstruction();
+    }
+}
+
+BENCHMARK(BM_ConcurrentConstruction)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_SequentialConstruction(benchmark::State & st) {
+    constexpr int numFormulas = 32;
+    for (auto _ : st) {
+        st.PauseTiming();
+        Logic logic{Logic_t::QF_UF};
+        SRef U = logic.declareUninterpretedSort("U");
+        SymRef f = logic.declareFun("f", U, {U, U});
+        std::vector<PTRef> vars;
+        for (int i = 0; i < 40; ++i) {
+            vars.push_back(logic.mkVar(U, ("x" + std::to_string(i)).c_str()));
+        }
+        st.ResumeTiming();
+
+        for (int k = 0; k < numFormulas; ++k) {
+            benchmark::DoNotOptimize(buildFormula(logic, f, vars, k));
+        }
+    }
+}
+
+BENCHMARK(BM_SequentialConstruction)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+#include <api/Interpret.h>
+
+#include <string>
+
+namespace {
+// (assert (let ((x1 (p x0))) (let ((x2 (p x1))) ... xn)))
+std::string letChain(int depth) {
+    std::string input = "(set-logic QF_UF)(declare-fun p (Bool) Bool)(declare-fun x0 () Bool)(assert ";
+    for (int i = 1; i <= depth; ++i) {
+        input += "(let ((x" + std::to_string(i) + " (p x" + std::to_string(i - 1) + "))) ";
+    }
+    input += "x" + std::to_string(depth);
+    input += std::string(depth, ')');
+    input += ")";
+    return input;
+}
+}
+
+class LetChain : public ::benchmark::Fixture {
+protected:
+    std::string input;
+
+public:
+    void SetUp(const ::benchmark::State& st) {
+        input = letChain(static_cast<int>(st.range(0)));
+    }
+
+    void TearDown(const ::benchmark::State&) {
+        input.clear();
+    }
+};
+
+BENCHMARK_DEFINE_F(LetChain, Interpret)(benchmark::State& st) {
+    for (auto _ : st) {
+        opensmt::SMTConfig config;
+        opensmt::Interpret interpret(config);
+        std::string content = input;
+        int res = interpret.interpFile(content.data());
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+BENCHMARK_REGISTER_F(LetChain, Interpret)->Arg(1000)->Arg(1000000)->Unit(benchmark::kMillisecond);
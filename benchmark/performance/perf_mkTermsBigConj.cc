@@ -5,11 +5,13 @@
  *
  */
 #include <benchmark/benchmark.h>
-#include <Logic.h>
+#include <logics/Logic.h>
 
 #include <algorithm>
 #include <random>
 
+using namespace opensmt;
+
 class MkTerms : public ::benchmark::Fixture {
 protected:
 
@@ -71,4 +73,47 @@ BENCHMARK_F(MkTerms, PosRand)(benchmark::State& st) {
         PTRef conj = logic.mkAnd(args);
         benchmark::DoNotOptimize(conj);
     }
-}
\ No newline at end of file
+}
+// Equalities are commutative, so the arguments of all these terms are sorted and their sums of references collide
+BENCHMARK_F(MkTerms, EqualityPairs)(benchmark::State& st) {
+    for (auto _ : st) {
+        Logic logic{opensmt::Logic_t::QF_UF};
+        SRef sort = logic.declareUninterpretedSort("U");
+        std::vector<PTRef> vars;
+        for (int i = 0; i < 300; ++i) {
+            auto name = std::string("x") + std::to_string(i);
+            vars.push_back(logic.mkVar(sort, name.c_str()));
+        }
+        for (auto i = 0u; i < vars.size(); ++i) {
+            for (auto j = i + 1; j < vars.size(); ++j) {
+                PTRef eq = logic.mkEq(vars[i], vars[j]);
+                benchmark::DoNotOptimize(eq);
+            }
+        }
+    }
+}
+
+BENCHMARK_F(MkTerms, ExistingApplications)(benchmark::State& st) {
+    Logic logic{opensmt::Logic_t::QF_UF};
+    SRef sort = logic.declareUninterpretedSort("U");
+    SymRef f = logic.declareFun("f", sort, {sort, sort, sort});
+    std::vector<PTRef> vars;
+    for (int i = 0; i < 40; ++i) {
+        auto name = std::string("x") + std::to_string(i);
+        vars.push_back(logic.mkVar(sort, name.c_str()));
+    }
+    auto mkAll = [&]() {
+        for (PTRef x : vars) {
+            for (PTRef y : vars) {
+                for (PTRef z : vars) {
+                    PTRef app = logic.mkUninterpFun(f, {x, y, z});
+                    benchmark::DoNotOptimize(app);
+                }
+            }
+        }
+    };
+    mkAll();
+    for (auto _ : st) {
+        mkAll();
+    }
+}
@@ -5,11 +5,13 @@
  *
  */
 #include <benchmark/benchmark.h>
-#include <Logic.h>
+#include <logics/Logic.h>
 
 #include <algorithm>
 #include <random>
 
+using namespace opensmt;
+
 class MkTerms : public ::benchmark::Fixture {
 protected:
 
@@ -82,3 +84,20 @@ BENCHMARK_F(MkTerms, Mix)(benchmark::State& st) {
         }
     }
 }
+
+BENCHMARK_F(MkTerms, Fresh)(benchmark::State& st) {
+    for (auto _ : st) {
+        Logic logic{opensmt::Logic_t::QF_UF};
+        std::vector<PTRef> vars;
+        for (int i = 0; i < 100; ++i) {
+            auto name = std::string("b") + std::to_string(i);
+            vars.push_back(logic.mkBoolVar(name.c_str()));
+        }
+        for (auto i = 0u; i < vars.size(); ++i) {
+            for (auto j = 0u; j < vars.size(); ++j) {
+                PTRef conj = logic.mkAnd(vars[i], logic.mkNot(vars[j]));
+                benchmark::DoNotOptimize(conj);
+            }
+        }
+    }
+}
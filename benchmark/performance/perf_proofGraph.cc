@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+#include <api/MainSolver.h>
+#include <proof/PG.h>
+#include <smtsolvers/ResolutionProof.h>
+
+#include <memory>
+#include <string>
+
+using namespace opensmt;
+
+namespace {
+class ProofSolver : public MainSolver {
+public:
+    using MainSolver::MainSolver;
+    using MainSolver::getTermMapper;
+};
+
+// An unsatisfiable pigeonhole problem solved with proof logging; its proof has some hundred thousands of nodes
+struct ProofSource {
+    static constexpr int holes = 8;
+
+    ProofSource() {
+        char const * msg = "ok";
+        config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+        solver = std::make_unique<ProofSolver>(logic, config, "proof");
+        auto in = [&](int pigeon, int hole) {
+            return logic.mkBoolVar(("p" + std::to_string(pigeon) + "h" + std::to_string(hole)).c_str());
+        };
+        for (int p = 0; p <= holes; ++p) {
+            vec<PTRef> holesOfPigeon;
+            for (int h = 0; h < holes; ++h) {
+                holesOfPigeon.push(in(p, h));
+            }
+            solver->insertFormula(logic.mkOr(std::move(holesOfPigeon)));
+        }
+        for (int h = 0; h < holes; ++h) {
+            for (int p = 0; p <= holes; ++p) {
+                for (int q = p + 1; q <= holes; ++q) {
+                    solver->insertFormula(logic.mkOr(logic.mkNot(in(p, h)), logic.mkNot(in(q, h))));
+                }
+            }
+        }
+        solver->check();
+    }
+
+    std::unique_ptr<ProofGraph> buildGraph() {
+        return std::make_unique<ProofGraph>(config, logic, solver->getTermMapper(),
+                                            solver->getSMTSolver().getResolutionProof());
+    }
+
+    Logic logic{Logic_t::QF_BOOL};
+    SMTConfig config;
+    std::unique_ptr<ProofSolver> solver;
+};
+
+ProofSource & getProofSource() {
+    static ProofSource source;
+    return source;
+}
+} // namespace
+
+static void BM_BuildProofGraph(benchmark::State & st) {
+    ProofSource & source = getProofSource();
+    for (auto _ : st) {
+        auto graph = source.buildGraph();
+        graph->fillProofGraph();
+        benchmark::DoNotOptimize(graph->getRoot());
+    }
+}
+
+BENCHMARK(BM_BuildProofGraph)->Unit(benchmark::kMillisecond);
+
+static void BM_RecyclePivots(benchmark::State & st) {
+    ProofSource & source = getProofSource();
+    for (auto _ : st) {
+        st.PauseTiming();
+        auto graph = source.buildGraph();
+        graph->fillProofGraph();
+        st.ResumeTiming();
+        graph->recyclePivotsIter();
+        graph->recycleUnits();
+    }
+}
+
+BENCHMARK(BM_RecyclePivots)->Unit(benchmark::kMillisecond);
+
+static void BM_ReductionTraversals(benchmark::State & st) {
+    ProofSource & source = getProofSource();
+    for (auto _ : st) {
+        st.PauseTiming();
+        auto graph = source.buildGraph();
+        graph->fillProofGraph();
+        ProofGraph & pg = *graph;
+        st.ResumeTiming();
+        pg.proofTransformAndRestructure(-1, 2, true, [&pg](RuleContext & ra1, RuleContext & ra2) {
+            return pg.handleRuleApplicationForReduction(ra1, ra2);
+        });
+    }
+}
+
+BENCHMARK(BM_ReductionTraversals)->Unit(benchmark::kMillisecond);
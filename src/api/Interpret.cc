@@ -29,10 +29,13 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <api/smt2tokens.h>
 #include <logics/ArithLogic.h>
 #include <logics/LogicFactory.h>
+#include <parsers/smt2new/smt2mappedlexer.h>
 #include <rewriters/Substitutor.h>
 
+#include <algorithm>
 #include <string>
 #include <sstream>
+#include <vector>
 #include <cstdarg>
 #include <unistd.h>
 
@@ -379,26 +382,6 @@ void Interpret::interp(ASTNode& n) {
     }
 }
 
-bool Interpret::addLetFrame(ASTNode const & bindingsNode, LetRecords & letRecords) {
-    std::vector<pair<PTRef, std::string>> bindings;
-
-    // First read the term declarations in the let statement
-    for (ASTNode const* vb : *bindingsNode.children) {
-        PTRef let_tr = parseTerm(**(vb->children->begin()), letRecords);
-        if (let_tr == PTRef_Undef) return false;
-        bindings.push_back({let_tr, vb->getValue()});
-    }
-    // Only then insert them to the table
-    for (auto const & [arg, name] : bindings) {
-        if (logic->hasSym(name.c_str()) and logic->getSym(logic->symNameToRef(name.c_str())[0]).noScoping()) {
-            notify_formatted(true, "Names marked as no scoping cannot be overloaded with let variables: %s", name.c_str());
-            return false;
-        }
-        letRecords.addBinding(name, arg);
-    }
-    return true;
-}
-
 //
 // Determine whether the term refers to some let definition
 //
@@ -425,125 +408,214 @@ PTRef Interpret::resolveTerm(const char* s, vec<PTRef>&& args, SRef sortRef, Sym
     return logic->resolveTerm(s, std::move(args), sortRef, symbolMatcher);
 }
 
-PTRef Interpret::parseTerm(const ASTNode& term, LetRecords& letRecords) {
+PTRef Interpret::resolveApplication(const char* name, vec<PTRef>&& args) {
+    try {
+        return resolveTerm(name, std::move(args));
+    } catch (ArithDivisionByZeroException &ex) {
+        reportError(ex.what());
+    } catch (ApiException &e) {
+        reportError(e.what());
+    }
+    return PTRef_Undef;
+}
+
+PTRef Interpret::parseIdentifier(const ASTNode& term, LetRecords const & letRecords) {
     ASTType t = term.getType();
     if (t == TERM_T) {
-        const char* name = (**(term.children->begin())).getValue();
+        ASTNode const & constant = **(term.children->begin());
+        const char* name = constant.getValue();
 //        comment_formatted("Processing term %s", name);
         PTRef tr = PTRef_Undef;
         try {
-            tr = logic->mkConst(name);
+            Number const * number = constant.getNumber();
+            if (number and (logic->hasIntegers() or logic->hasReals())) {
+                // The scanner parsed the value already
+                auto & arithLogic = static_cast<ArithLogic &>(*logic);
+                if (constant.getType() == NUM_T) {
+                    tr = logic->hasIntegers() ? arithLogic.mkIntConst(*number) : arithLogic.mkRealConst(*number);
+                } else if (logic->hasReals()) {
+                    tr = arithLogic.mkRealConst(*number);
+                } else {
+                    throw ApiException("Expected integral constant");
+                }
+            } else {
+                tr = logic->mkConst(name);
+            }
         } catch (ApiException const & e) {
             comment_formatted("While processing %s: %s", name, e.what());
         }
         return tr;
     }
 
-    else if (t == QID_T) {
-        if ((**(term.children->begin())).getType() == AS_T) {
-            auto const & as_node = **(term.children->begin());
-            ASTNode const * symbolNode = (*as_node.children)[0];
-            bool isQuoted = symbolNode->getType() == QSYM_T;
-            const char * name = (*as_node.children)[0]->getValue();
-            ASTNode const & sortNode = *(*as_node.children)[1];
-            assert(name != nullptr);
-            PTRef tr = resolveQualifiedIdentifier(name, sortNode, isQuoted);
-            return tr;
-        } else {
-            ASTNode const * symbolNode = (*(term.children->begin()));
-            char const * name = symbolNode->getValue();
-            bool isQuoted = symbolNode->getType() == QSYM_T;
-            assert(name != nullptr);
-            PTRef tr = letNameResolve(name, letRecords);
-            if (tr != PTRef_Undef) {
-                return tr;
-            }
-            try {
-                tr = resolveTerm(name, {}, SRef_Undef, isQuoted ? SymbolMatcher::Uninterpreted : SymbolMatcher::Any);
-            } catch (ApiException & e) {
-                reportError(e.what());
-            }
+    assert(t == QID_T);
+    if ((**(term.children->begin())).getType() == AS_T) {
+        auto const & as_node = **(term.children->begin());
+        ASTNode const * symbolNode = (*as_node.children)[0];
+        bool isQuoted = symbolNode->getType() == QSYM_T;
+        const char * name = (*as_node.children)[0]->getValue();
+        ASTNode const & sortNode = *(*as_node.children)[1];
+        assert(name != nullptr);
+        PTRef tr = resolveQualifiedIdentifier(name, sortNode, isQuoted);
+        return tr;
+    } else {
+        ASTNode const * symbolNode = (*(term.children->begin()));
+        char const * name = symbolNode->getValue();
+        bool isQuoted = symbolNode->getType() == QSYM_T;
+        assert(name != nullptr);
+        PTRef tr = letNameResolve(name, letRecords);
+        if (tr != PTRef_Undef) {
             return tr;
         }
-    }
-
-    else if ( t == LQID_T ) {
-        // Multi-argument term
-        auto node_iter = term.children->begin();
-        vec<PTRef> args;
-        const char* name = (**node_iter).getValue(); node_iter++;
-        // Parse the arguments
-        for (; node_iter != term.children->end(); node_iter++) {
-            PTRef arg_term = parseTerm(**node_iter, letRecords);
-            if (arg_term == PTRef_Undef)
-                return PTRef_Undef;
-            else
-                args.push(arg_term);
-        }
-        assert(args.size() > 0);
-
-        PTRef tr = PTRef_Undef;
         try {
-            tr = resolveTerm(name, std::move(args));
-        } catch (ArithDivisionByZeroException &ex) {
-            reportError(ex.what());
-        } catch (ApiException &e) {
+            tr = resolveTerm(name, {}, SRef_Undef, isQuoted ? SymbolMatcher::Uninterpreted : SymbolMatcher::Any);
+        } catch (ApiException & e) {
             reportError(e.what());
         }
         return tr;
     }
+}
 
-    else if (t == LET_T) {
-        // use RAII idiom to guard the scope of new LetFrame (and ensure the cleaup of names)
-        class Guard {
-            LetRecords& rec;
-        public:
-            Guard(LetRecords& rec): rec(rec) { rec.pushFrame(); }
-            ~Guard() { rec.popFrame(); }
-        } scopeGuard(letRecords);
-
-        auto ch = term.children->begin();
-        bool success = addLetFrame(**ch, letRecords);
-        if (not success) {
-            comment_formatted("Let name addition failed");
-            return PTRef_Undef;
+//
+// Builds the term bottom-up with an explicit stack, so that deeply nested terms and let chains
+// do not overflow the call stack
+//
+PTRef Interpret::parseTerm(const ASTNode& term, LetRecords& letRecords) {
+    struct Frame {
+        ASTNode const & node;
+        std::size_t next;     // The next child to process
+        std::size_t results;  // Where the results of the children start in `results`
+    };
+    std::vector<Frame> stack;
+    std::vector<PTRef> results;
+
+    auto enter = [&](ASTNode const & node) {
+        // The frame of a let is opened before its bindings are parsed and closed after its body
+        if (node.getType() == LET_T) { letRecords.pushFrame(); }
+        stack.push_back({node, 0, results.size()});
+    };
+    auto letBindings = [](ASTNode const & let) -> std::vector<ASTNode*> const & {
+        return *(**(let.children->begin())).children;
+    };
+
+    bool failed = false;
+    enter(term);
+    while (not stack.empty() and not failed) {
+        Frame & frame = stack.back();
+        ASTNode const & node = frame.node;
+        ASTType t = node.getType();
+
+        if (t == TERM_T or t == QID_T) {
+            PTRef tr = parseIdentifier(node, letRecords);
+            if (tr == PTRef_Undef) {
+                failed = true;
+                break;
+            }
+            stack.pop_back();
+            results.push_back(tr);
         }
-        ch++;
-        // This is now constructed with the let declarations context in let_branch
-        PTRef tr = parseTerm(**(ch), letRecords);
-        if (tr == PTRef_Undef) {
-            comment_formatted("Failed in parsing the let scoped term");
-            return PTRef_Undef;
+
+        else if (t == LQID_T) {
+            // Multi-argument term; the first child is the name
+            if (frame.next == 0) { frame.next = 1; }
+            if (frame.next < node.children->size()) {
+                enter(*(*node.children)[frame.next++]);
+                continue;
+            }
+            vec<PTRef> args;
+            for (std::size_t i = frame.results; i < results.size(); ++i) {
+                args.push(results[i]);
+            }
+            assert(args.size() > 0);
+            const char* name = (**(node.children->begin())).getValue();
+            PTRef tr = resolveApplication(name, std::move(args));
+            if (tr == PTRef_Undef) {
+                failed = true;
+                break;
+            }
+            results.resize(frame.results);
+            stack.pop_back();
+            results.push_back(tr);
         }
-        return tr;
-    }
 
-    else if (t == BANG_T) {
-        assert(term.children->size() == 2);
-        auto ch = term.children->begin();
-        ASTNode& named_term = **ch;
-        ASTNode& attr_l = **(++ ch);
-        assert(attr_l.getType() == GATTRL_T);
-        assert(attr_l.children->size() == 1);
-        ASTNode& name_attr = **(attr_l.children->begin());
+        else if (t == LET_T) {
+            auto const & bindings = letBindings(node);
+            // First read the term declarations in the let statement
+            if (frame.next < bindings.size()) {
+                enter(**(bindings[frame.next++]->children->begin()));
+                continue;
+            }
+            // Only then insert them to the table
+            if (frame.next == bindings.size()) {
+                for (std::size_t i = 0; i < bindings.size(); ++i) {
+                    const char* name = bindings[i]->getValue();
+                    if (logic->hasSym(name) and logic->getSym(logic->symNameToRef(name)[0]).noScoping()) {
+                        notify_formatted(true, "Names marked as no scoping cannot be overloaded with let variables: %s", name);
+                        failed = true;
+                        break;
+                    }
+                    letRecords.addBinding(name, results[frame.results + i]);
+                }
+                if (failed) { break; }
+                results.resize(frame.results);
+                ++frame.next;
+                // This is now constructed with the let declarations context in let_branch
+                enter(**(node.children->begin() + 1));
+                continue;
+            }
+            letRecords.popFrame();
+            stack.pop_back();
+        }
 
-        PTRef tr = parseTerm(named_term, letRecords);
-        if (tr == PTRef_Undef) return tr;
+        else if (t == BANG_T) {
+            assert(node.children->size() == 2);
+            if (frame.next == 0) {
+                ++frame.next;
+                enter(**(node.children->begin()));
+                continue;
+            }
+            PTRef tr = results.back();
+            ASTNode& attr_l = **(node.children->begin() + 1);
+            assert(attr_l.getType() == GATTRL_T);
+            assert(attr_l.children->size() == 1);
+            ASTNode& name_attr = **(attr_l.children->begin());
+
+            if (strcmp(name_attr.getValue(), ":named") == 0) {
+                auto & termNames = main_solver->getTermNames();
+                ASTNode& sym = **(name_attr.children->begin());
+                assert(sym.getType() == SYM_T or sym.getType() == QSYM_T);
+                if (termNames.contains(sym.getValue())) {
+                    notify_formatted(true, "name %s already exists", sym.getValue());
+                    failed = true;
+                    break;
+                }
+                termNames.insert(sym.getValue(), tr);
+            }
+            stack.pop_back();
+        }
 
-        if (strcmp(name_attr.getValue(), ":named") == 0) {
-            auto & termNames = main_solver->getTermNames();
-            ASTNode& sym = **(name_attr.children->begin());
-            assert(sym.getType() == SYM_T or sym.getType() == QSYM_T);
-            if (termNames.contains(sym.getValue())) {
-                notify_formatted(true, "name %s already exists", sym.getValue());
-                return PTRef_Undef;
+        else {
+            comment_formatted("Unknown term type");
+            failed = true;
+        }
+    }
+
+    if (not failed) {
+        assert(results.size() == 1);
+        return results[0];
+    }
+    // Leave the scopes of the enclosing lets, reporting the failure as each of them would
+    while (not stack.empty()) {
+        Frame const & frame = stack.back();
+        if (frame.node.getType() == LET_T) {
+            if (frame.next <= letBindings(frame.node).size()) {
+                comment_formatted("Let name addition failed");
+            } else {
+                comment_formatted("Failed in parsing the let scoped term");
             }
-            termNames.insert(sym.getValue(), tr);
+            letRecords.popFrame();
         }
-        return tr;
+        stack.pop_back();
     }
-    else
-        comment_formatted("Unknown term type");
     return PTRef_Undef;
 }
 
@@ -1113,33 +1185,102 @@ int Interpret::interpFile(char *content){
     return rval;
 }
 
+void Interpret::setStreamingHandler(Smt2newContext & context) {
+    context.setCommandHandler([this](ASTNode& command) {
+        interp(command);
+        return not f_exit;
+    });
+}
 
-// For reading from pipe
-int Interpret::interpPipe() {
+int Interpret::interpStream(FILE* in) {
+    Smt2newContext context(in);
+    setStreamingHandler(context);
+    return osmt_yyparse(&context);
+}
 
-    int buf_sz  = 16;
-    char* buf   = (char*) malloc(sizeof(char)*buf_sz);
-    int rd_head = 0;
-    int par     = 0;
-    int i       = 0;
+int Interpret::interpMapped(FILE* in, bool streaming) {
+    MappedFile file(fileno(in));
+    if (not file.isMapped()) {
+        return streaming ? interpStream(in) : interpFile(in);
+    }
+    Smt2MappedLexer lexer(file.contents());
+    Smt2newContext context(lexer);
+    if (streaming) {
+        setStreamingHandler(context);
+        return osmt_yyparse(&context);
+    }
+    int rval = osmt_yyparse(&context);
 
+    if (rval != 0) return rval;
+    const ASTNode* r = context.getRoot();
+    execute(r);
+    return rval;
+}
+
+namespace {
+// Finds the ends of top-level commands in a stream of characters, skipping comments, strings and quoted symbols.
+// The state is kept between calls, so every character is looked at only once.
+class CommandScanner {
+public:
+    // Advances pos over buf up to end; stops right after the closing parenthesis of a command and returns true then
+    bool scan(char const * buf, std::size_t & pos, std::size_t end) {
+        while (pos < end) {
+            char c = buf[pos++];
+            if (inComment) {
+                inComment = (c != '\n');
+            } else if (inQuotedSymbol) {
+                inQuotedSymbol = (c != '|');
+            } else if (inString) {
+                inString = (c != '\"');
+            } else if (c == ';') {
+                inComment = true;
+            } else if (c == '|') {
+                inQuotedSymbol = true;
+            } else if (c == '\"') {
+                inString = true;
+            } else if (c == '(') {
+                ++par;
+            } else if (c == ')') {
+                if (--par <= 0) { return true; }
+            }
+        }
+        return false;
+    }
+    bool unbalanced() const { return par < 0; }
+
+private:
+    int par = 0;
     bool inComment = false;
     bool inString = false;
     bool inQuotedSymbol = false;
+};
+}
 
-    bool done  = false;
-    buf[0] = '\0';
+// For reading from pipe.
+// Commands are parsed in place in the read buffer. The consumed prefix of the buffer is reclaimed only when a read
+// needs the space, and then only the unfinished command is moved, so the work per command does not depend on the
+// length of the session.
+int Interpret::interpPipe() {
+    std::vector<char> buf(1 << 16);
+    std::size_t cmd_start = 0; // Start of the first command not executed yet
+    std::size_t scan_pos = 0;  // Position up to which the input has been scanned
+    std::size_t rd_head = 0;   // End of the input read so far
+    CommandScanner scanner;
+
+    bool done = false;
     while (!done) {
-        assert(i >= 0 and i <= rd_head);
-        assert(buf[rd_head] == '\0');
-        assert(rd_head < buf_sz);
-        if (rd_head == buf_sz - 1) {
-            buf_sz *= 2;
-            buf = (char*) realloc(buf, sizeof(char)*buf_sz);
+        assert(cmd_start <= scan_pos and scan_pos <= rd_head and rd_head <= buf.size());
+        if (rd_head == buf.size()) {
+            if (cmd_start > 0) {
+                std::copy(buf.begin() + cmd_start, buf.begin() + rd_head, buf.begin());
+                scan_pos -= cmd_start;
+                rd_head -= cmd_start;
+                cmd_start = 0;
+            } else {
+                buf.resize(2 * buf.size());
+            }
         }
-        int rd_chunk = buf_sz - rd_head - 1;
-        assert(rd_chunk > 0);
-        int bts_rd = read(STDIN_FILENO, &buf[rd_head], rd_chunk);
+        ssize_t bts_rd = read(STDIN_FILENO, &buf[rd_head], buf.size() - rd_head);
         if (bts_rd == 0) {
             // Read EOF
             break;
@@ -1151,80 +1292,30 @@ int Interpret::interpPipe() {
             notify_formatted(true, err_str);
             break;
         }
-
         rd_head += bts_rd;
-        buf[rd_head] = '\0';
-
-        for (; i < rd_head; i++) {
 
-            char c = buf[i];
-
-            if (inComment || (not inQuotedSymbol and not inString and c == ';')) {
-                inComment = (c != '\n');
-            }
-            if (inComment) {
-                continue;
-            }
-            assert(not inComment);
-            if (inQuotedSymbol) {
-                inQuotedSymbol = (c != '|');
-            } else if (not inString and c == '|') {
-                inQuotedSymbol = true;
-            }
-            if (inQuotedSymbol) {
-                continue;
-            }
-            assert (not inComment and not inQuotedSymbol);
-            if (inString) {
-                inString = (c != '\"');
-            } else if (c == '\"') {
-                inString = true;
-            }
-            if (inString) {
-                continue;
+        while (!done and scan_pos < rd_head) {
+            if (not scanner.scan(buf.data(), scan_pos, rd_head)) {
+                break;
             }
-
-            if (c == '(') {
-                par ++;
+            if (scanner.unbalanced()) {
+                notify_formatted(true, "pipe reader: unbalanced parentheses");
+                done = true;
+                break;
             }
-            else if (c == ')') {
-                par --;
-                if (par == 0) {
-                    // prepare parse buffer
-                    char* buf_out = (char*) malloc(sizeof(char)*i+2);
-                    // copy contents to the parse buffer
-                    for (int j = 0; j <= i; j++)
-                        buf_out[j] = buf[j];
-                    buf_out[i+1] = '\0';
-
-                    // copy the part after a top-level balanced parenthesis to the start of buf
-                    for (int j = i+1; j < rd_head; j++)
-                        buf[j-i-1] = buf[j];
-                    buf[rd_head-i-1] = '\0';
-
-                    // update the end position of buf to reflect the removal of the string to be parsed
-                    rd_head = rd_head-i-1;
-
-                    i = -1; // will be incremented to 0 by the loop condition.
-                    Smt2newContext context(buf_out);
-                    int rval = osmt_yyparse(&context);
-                    if (rval != 0)
-                        notify_formatted(true, "scanner");
-                    else {
-                        const ASTNode* r = context.getRoot();
-                        execute(r);
-                        done = f_exit;
-                    }
-                    free(buf_out);
-                }
-                if (par < 0) {
-                    notify_formatted(true, "pipe reader: unbalanced parentheses");
-                    done = true;
-                }
+            Smt2MappedLexer lexer(std::string_view(&buf[cmd_start], scan_pos - cmd_start));
+            cmd_start = scan_pos;
+            Smt2newContext context(lexer, true);
+            int rval = osmt_yyparse(&context);
+            if (rval != 0)
+                notify_formatted(true, "scanner");
+            else {
+                const ASTNode* r = context.getRoot();
+                execute(r);
+                done = f_exit;
             }
         }
     }
-    free(buf);
     return 0;
 }
 
@@ -34,8 +34,11 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <api/MainSolver.h>
 #include <common/ScopedVector.h>
 
+#include <functional>
 #include <unordered_map>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace opensmt {
 
@@ -66,35 +69,33 @@ public:
     }
 };
 
-class LetBinder {
-    PTRef currentValue;
-    vec<PTRef> shadowedValues;
-public:
-    LetBinder(PTRef val) : currentValue(val) {}
-    LetBinder(const LetBinder&) = delete;
-    LetBinder& operator=(const LetBinder&) = delete;
-    LetBinder(LetBinder&&) = default;
-    LetBinder& operator=(LetBinder&&) = default;
-    PTRef getValue() const { return currentValue; }
-    bool hasShadowValue() const { return shadowedValues.size() != 0; }
-    void restoreShadowedValue() { currentValue = shadowedValues.last(); shadowedValues.pop(); }
-    void addValue(PTRef val) {
-        shadowedValues.push(currentValue);
-        currentValue = val;
-    }
-};
-
+/**
+ * Let bindings in scope while a term is being built.
+ *
+ * Binder names are interned: each name gets a small integer id the first time it is bound, and the values bound to it
+ * are kept in a stack indexed by that id, so entering and leaving a let scope does no string copying. Names are looked
+ * up without constructing a std::string.
+ */
 class LetRecords {
-    std::unordered_map<std::string, LetBinder> letBinders;
-    std::vector<std::string> knownBinders;
+    struct NameHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+    std::unordered_map<std::string, std::size_t, NameHash, std::equal_to<>> symbolIds;
+    std::vector<vec<PTRef>> values;         // Indexed by symbol id, the innermost binding is the last one
+    std::vector<std::size_t> knownBinders;  // Ids of the bound symbols, in the order they were bound
     std::vector<std::size_t> frameLimits;
 
-    bool has(std::string const & name) const { return letBinders.find(name) != letBinders.end(); }
+    std::size_t intern(std::string_view name) {
+        auto [it, inserted] = symbolIds.try_emplace(std::string(name), values.size());
+        if (inserted) { values.emplace_back(); }
+        return it->second;
+    }
 public:
     PTRef getOrUndef(const char* letSymbol) const {
-        auto it = letBinders.find(letSymbol);
-        if (it != letBinders.end()) {
-            return it->second.getValue();
+        auto it = symbolIds.find(std::string_view(letSymbol));
+        if (it != symbolIds.end() and values[it->second].size() != 0) {
+            return values[it->second].last();
         }
         return PTRef_Undef;
     }
@@ -103,15 +104,10 @@ public:
         auto limit = frameLimits.back();
         frameLimits.pop_back();
         while (knownBinders.size() > limit) {
-            std::string binder = std::move(knownBinders.back());
+            auto id = knownBinders.back();
             knownBinders.pop_back();
-            assert(this->has(binder));
-            auto& values = letBinders.at(binder);
-            if (values.hasShadowValue()) {
-                values.restoreShadowedValue();
-            } else {
-                letBinders.erase(binder);
-            }
+            assert(values[id].size() != 0);
+            values[id].pop();
         }
     }
 
@@ -120,13 +116,10 @@ public:
      * @param name
      * @param arg
      */
-    void addBinding(std::string const & name, PTRef arg) {
-        if (not this->has(name)) {
-            letBinders.insert({name, LetBinder(arg)});
-        } else {
-            letBinders.at(name).addValue(arg);
-        }
-        knownBinders.push_back(name);
+    void addBinding(std::string_view name, PTRef arg) {
+        auto id = intern(name);
+        values[id].push(arg);
+        knownBinders.push_back(id);
     }
 };
 
@@ -164,6 +157,8 @@ class Interpret {
     void                        pop(int);
 
     PTRef                       parseTerm(const ASTNode& term, LetRecords& letRecords);
+    PTRef                       parseIdentifier(const ASTNode& term, LetRecords const & letRecords);
+    PTRef                       resolveApplication(const char* name, vec<PTRef>&& args);
     PTRef                       resolveTerm(const char* s, vec<PTRef>&& args, SRef sortRef = SRef_Undef, SymbolMatcher symbolMatcher = SymbolMatcher::Any);
     bool                        storeDefinedFun(std::string const & fname, const vec<PTRef>& args, SRef ret_sort, const PTRef tr);
 
@@ -172,12 +167,12 @@ class Interpret {
     void                        getUnsatCore();
     void                        getInterpolants(const ASTNode& n);
     void                        interp (ASTNode& n);
+    void                        setStreamingHandler(Smt2newContext & context);
 
     void                        notify_formatted(bool error, const char* s, ...);
     void                        notify_success();
     void                        comment_formatted(const char* s, ...) const;
 
-    bool                        addLetFrame(ASTNode const & bindingsNode, LetRecords& letRecords);
     PTRef                       letNameResolve(const char* s, const LetRecords& letRecords) const;
     PTRef                       resolveQualifiedIdentifier(const char * name, ASTNode const & sort, bool isQuoted);
 
@@ -194,6 +189,10 @@ class Interpret {
 
     int interpFile(FILE* in);
     int interpFile(char *content);
+    // Executes each command as soon as it is parsed, so that memory is bounded by the largest command
+    int interpStream(FILE* in);
+    // Parses a regular file through a read-only memory mapping; falls back to interpFile/interpStream otherwise
+    int interpMapped(FILE* in, bool streaming);
     int interpPipe();
 
     void    execute(const ASTNode* n);
@@ -12,6 +12,7 @@
 #include <itehandler/IteHandler.h>
 #include <logics/ArrayTheory.h>
 #include <logics/LATheory.h>
+#include <logics/TermSnapshot.h>
 #include <logics/UFLATheory.h>
 #include <models/ModelBuilder.h>
 #include <rewriters/Substitutor.h>
@@ -23,6 +24,8 @@
 #include <tsolvers/RDLTHandler.h>
 #include <unsatcores/UnsatCoreBuilder.h>
 
+#include <unordered_set>
+
 namespace opensmt {
 
 bool stop;
@@ -61,8 +64,14 @@ MainSolver::MainSolver(std::unique_ptr<Theory> th, std::unique_ptr<TermMapper> t
 void MainSolver::initialize() {
     frames.push();
     frameTerms.push(logic.getTerm_true());
+    // Proofs of the clauses are checked and interpolated against the full definitions
+    ts.setPolarityAware(config.polarity_aware_cnf() and not config.produce_proof());
+    // The definitions of the subterms are shared by all frames, except when the clauses are tracked by partitions,
+    // which are dropped on pop
+    ts.setFrameIndependentDefinitions(not trackPartitions());
     preprocessor.initialize();
     smt_solver->initialize();
+    smt_solver->setClauseRelocationCallback([this](ClauseAllocator const & ca) { pmanager.relocateClauses(ca); });
     pair<CRef, CRef> iorefs{CRef_Undef, CRef_Undef};
     smt_solver->addOriginalSMTClause({term_mapper->getOrCreateLit(logic.getTerm_true())}, iorefs);
     if (iorefs.first != CRef_Undef) { pmanager.addClauseClassMask(iorefs.first, 1); }
@@ -75,6 +84,7 @@ void MainSolver::push() {
     bool alreadyUnsat = isLastFrameUnsat();
     frames.push();
     preprocessor.push();
+    theory->pushFrame();
     frameTerms.push(newFrameTerm(frames.last().getId()));
     termNames.pushScope();
     if (alreadyUnsat) { rememberLastFrameUnsat(); }
@@ -95,6 +105,7 @@ bool MainSolver::pop() {
     }
     frames.pop();
     preprocessor.pop();
+    theory->popFrame();
     termNames.popScope();
     firstNotSimplifiedFrame = std::min(firstNotSimplifiedFrame, frames.frameCount());
     if (not isLastFrameUnsat()) { getSMTSolver().restoreOK(); }
@@ -121,6 +132,7 @@ void MainSolver::insertFormula(PTRef fla) {
     }
 
     frames.add(fla);
+    if (guardsAssertions()) { frames.last().guards.push(newAssertionGuard(insertedFormulasCount)); }
     firstNotSimplifiedFrame = std::min(firstNotSimplifiedFrame, frames.frameCount() - 1);
 }
 
@@ -158,7 +170,14 @@ sstat MainSolver::simplifyFormulas() {
                 if (status == s_False) { break; }
             }
         } else {
-            PTRef frameFormula = logic.mkAnd(frames[i].formulas);
+            vec<PTRef> frameFormulas;
+            frames[i].formulas.copyTo(frameFormulas);
+            if (guardsAssertions()) {
+                for (int j = 0; j < frameFormulas.size(); ++j) {
+                    frameFormulas[j] = logic.mkImpl(frames[i].guards[j], frameFormulas[j]);
+                }
+            }
+            PTRef frameFormula = logic.mkAnd(std::move(frameFormulas));
             if (context.frameCount > 0) { frameFormula = applyLearntSubstitutions(frameFormula); }
             frameFormula = theory->preprocessBeforeSubstitutions(frameFormula, context);
             frameFormula = substitutionPass(frameFormula, context);
@@ -194,6 +213,24 @@ void MainSolver::printFramesAsQuery(std::ostream & s) const {
     logic.dumpChecksatToFile(s);
 }
 
+void MainSolver::saveSnapshot(std::ostream & out) const {
+    TermSnapshot::Groups groups(frames.frameCount());
+    for (std::size_t i = 0; i < frames.frameCount(); ++i) {
+        frames[i].formulas.copyTo(groups[i]);
+    }
+    TermSnapshot::write(out, logic, groups);
+}
+
+void MainSolver::loadSnapshot(std::istream & in) {
+    TermSnapshot::Groups groups = TermSnapshot::read(in, logic);
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        if (i > 0) { push(); }
+        for (PTRef fla : groups[i]) {
+            insertFormula(fla);
+        }
+    }
+}
+
 // Replace subtrees consisting only of ands / ors with a single and / or term.
 // Search a maximal section of the tree consisting solely of ands / ors.  The
 // root of this subtree is called and / or root.  Collect the subtrees rooted at
@@ -205,6 +242,9 @@ void MainSolver::printFramesAsQuery(std::ostream & s) const {
 // that structure.
 //
 PTRef MainSolver::rewriteMaxArity(PTRef root) {
+    if (int threads = config.preprocessing_threads(); threads > 0) {
+        return opensmt::rewriteMaxArityParallel(logic, root, static_cast<unsigned>(threads));
+    }
     return opensmt::rewriteMaxArityClassic(logic, root);
 }
 
@@ -219,6 +259,16 @@ std::unique_ptr<Model> MainSolver::getModel() {
     return modelBuilder.build();
 }
 
+std::vector<PTRef> MainSolver::getValues(std::vector<PTRef> const & terms) {
+    auto model = getModel();
+    std::vector<PTRef> values;
+    values.reserve(terms.size());
+    for (PTRef tr : terms) {
+        values.push_back(model->evaluate(tr));
+    }
+    return values;
+}
+
 void MainSolver::printResolutionProofSMT2() const {
     assert(smt_solver);
     if (!smt_solver->logsResolutionProof()) { throw ApiException("Proofs are not tracked"); }
@@ -231,6 +281,11 @@ std::unique_ptr<UnsatCore> MainSolver::getUnsatCore() const {
     if (not config.produce_unsat_cores()) { throw ApiException("Producing unsat cores is not enabled"); }
     if (status != s_False) { throw ApiException("Unsat core cannot be extracted if solver is not in UNSAT state"); }
 
+    if (guardsAssertions()) {
+        UnsatCoreBuilder unsatCoreBuilder{config, logic, coreAssertions, termNames};
+        return unsatCoreBuilder.build();
+    }
+
     auto & proof = smt_solver->getResolutionProof();
     UnsatCoreBuilder unsatCoreBuilder{config, logic, proof, pmanager, termNames};
 
@@ -240,6 +295,25 @@ std::unique_ptr<UnsatCore> MainSolver::getUnsatCore() const {
 lbool MainSolver::getTermValue(PTRef tr) const {
     if (logic.getSortRef(tr) != logic.getSort_bool()) { return l_Undef; }
     if (not term_mapper->hasLit(tr)) { return l_Undef; }
+    if (ts.isPolarityAware()) {
+        // The literal of a connective may disagree with its value if only half of its definition was encoded
+        Pterm const & term = logic.getPterm(tr);
+        if (logic.isNot(tr)) { return getTermValue(term[0]) ^ true; }
+        if (logic.isImplies(tr)) { return (getTermValue(term[0]) ^ true) || getTermValue(term[1]); }
+        if (logic.isAnd(tr) or logic.isOr(tr)) {
+            lbool val = logic.isAnd(tr) ? l_True : l_False;
+            for (PTRef arg : term) {
+                val = logic.isAnd(tr) ? (val && getTermValue(arg)) : (val || getTermValue(arg));
+            }
+            return val;
+        }
+        if (logic.isXor(tr) or logic.isIff(tr)) {
+            lbool first = getTermValue(term[0]);
+            lbool second = getTermValue(term[1]);
+            if (first == l_Undef or second == l_Undef) { return l_Undef; }
+            return lbool((first == second) == logic.isIff(tr));
+        }
+    }
 
     Lit l = term_mapper->getLit(tr);
     auto val = smt_solver->modelValue(l);
@@ -287,8 +361,10 @@ void MainSolver::printFramesAsQuery() const {
 sstat MainSolver::giveToSolver(PTRef root, FrameId push_id) {
 
     struct ClauseCallBack : public Cnfizer::ClauseCallBack {
-        std::vector<vec<Lit>> clauses;
-        void operator()(vec<Lit> && c) override { clauses.push_back(std::move(c)); }
+        std::vector<std::pair<vec<Lit>, bool>> clauses;
+        void operator()(vec<Lit> && c, bool frameIndependent) override {
+            clauses.emplace_back(std::move(c), frameIndependent);
+        }
     };
     ClauseCallBack callBack;
     ts.setClauseCallBack(&callBack);
@@ -296,8 +372,8 @@ sstat MainSolver::giveToSolver(PTRef root, FrameId push_id) {
     bool const keepPartitionsSeparate = trackPartitions();
     Lit frameLit = push_id == 0 ? Lit{} : term_mapper->getOrCreateLit(frameTerms[push_id]);
     int partitionIndex = keepPartitionsSeparate ? pmanager.getPartitionIndex(root) : -1;
-    for (auto & clause : callBack.clauses) {
-        if (push_id != 0) { clause.push(frameLit); }
+    for (auto & [clause, frameIndependent] : callBack.clauses) {
+        if (push_id != 0 and not frameIndependent) { clause.push(frameLit); }
         pair<CRef, CRef> iorefs{CRef_Undef, CRef_Undef};
         bool res = smt_solver->addOriginalSMTClause(std::move(clause), iorefs);
         if (keepPartitionsSeparate) {
@@ -320,6 +396,8 @@ sstat MainSolver::check() {
         printf("; %s query time so far: %f\n", solver_name.c_str(), query_timer.getTime());
         StopWatch sw(query_timer);
     }
+    unsatAssumptions.clear();
+    coreAssertions.clear();
     if (isLastFrameUnsat()) { return s_False; }
     sstat rval = simplifyFormulas();
 
@@ -331,13 +409,65 @@ sstat MainSolver::check() {
         } catch (std::overflow_error const & error) { rval = s_Error; }
         if (rval == s_False) {
             assert(not smt_solver->isOK());
-            rememberUnsatFrame(smt_solver->getConflictFrame());
+            // The final conflict holds the negations of the failed assumptions
+            for (Lit l : smt_solver->conflict) {
+                auto [first, last] = assumptionIndices.equal_range(var(l));
+                for (auto it = first; it != last; ++it) {
+                    if (assumptionLits[it->second] == ~l) { unsatAssumptions.push(assumptionTerms[it->second]); }
+                }
+            }
+            if (guardsAssertions()) {
+                std::unordered_set<Var> failedVars;
+                for (Lit l : smt_solver->conflict) {
+                    failedVars.insert(var(l));
+                }
+                for (std::size_t i = 0; i < frames.frameCount(); ++i) {
+                    for (int j = 0; j < frames[i].guards.size(); ++j) {
+                        if (failedVars.count(var(term_mapper->getLit(frames[i].guards[j]))) > 0) {
+                            coreAssertions.push(frames[i].formulas[j]);
+                        }
+                    }
+                }
+            }
+            if (unsatAssumptions.size() == 0 and coreAssertions.size() == 0) {
+                rememberUnsatFrame(smt_solver->getConflictFrame());
+            } else {
+                // Only unsatisfiable under the assumptions, the assertions can still be used
+                smt_solver->restoreOK();
+            }
         }
     }
 
     return rval;
 }
 
+sstat MainSolver::checkAssuming(vec<PTRef> const & assumptions) {
+    assumptionTerms.clear();
+    assumptionLits.clear();
+    assumptionIndices.clear();
+    for (PTRef tr : assumptions) {
+        PTRef atom = logic.isNot(tr) ? logic.getPterm(tr)[0] : tr;
+        if (not logic.isBoolAtom(atom)) {
+            throw ApiException("Assumption must be a Boolean variable or its negation, got " + logic.pp(tr));
+        }
+        Lit l = term_mapper->getOrCreateLit(tr);
+        term_mapper->setFrozen(var(l));
+        assumptionIndices.emplace(var(l), assumptionLits.size());
+        assumptionTerms.push(tr);
+        assumptionLits.push(l);
+    }
+    sstat rval = check();
+    assumptionTerms.clear();
+    assumptionLits.clear();
+    assumptionIndices.clear();
+    return rval;
+}
+
+vec<PTRef> const & MainSolver::getUnsatAssumptions() const {
+    if (status != s_False) { throw ApiException("Unsat assumptions cannot be extracted if solver is not in UNSAT state"); }
+    return unsatAssumptions;
+}
+
 sstat MainSolver::solve() {
     if (!smt_solver->isOK()) { return s_False; }
 
@@ -346,6 +476,14 @@ sstat MainSolver::solve() {
         Lit l = term_mapper->getOrCreateLit(tr);
         smt_solver->addVar(var(l));
     }
+    for (Lit l : assumptionLits) {
+        smt_solver->addVar(var(l));
+    }
+    for (std::size_t i = 0; i < frames.frameCount(); ++i) {
+        for (PTRef guard : frames[i].guards) {
+            smt_solver->addVar(var(term_mapper->getLit(guard)));
+        }
+    }
 
     vec<FrameId> en_frames;
     for (std::size_t i = 0; i < frames.frameCount(); ++i) {
@@ -380,6 +518,14 @@ sstat MainSolver::solve_(vec<FrameId> const & enabledFrames) {
         assumps[i - 1] = assumps[i];
     }
     assumps.pop();
+    for (std::size_t i = 0; i < frames.frameCount(); ++i) {
+        for (PTRef guard : frames[i].guards) {
+            assumps.push(term_mapper->getLit(guard));
+        }
+    }
+    for (Lit l : assumptionLits) {
+        assumps.push(l);
+    }
     return smt_solver->solve(assumps, !config.isIncremental(), config.isIncremental());
 }
 
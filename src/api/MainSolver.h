@@ -20,6 +20,7 @@
 #include <unsatcores/UnsatCore.h>
 
 #include <memory>
+#include <unordered_map>
 
 namespace opensmt {
 class Logic;
@@ -81,16 +82,36 @@ public:
     void push();
     bool pop();
     void insertFormula(PTRef fla);
+    // The literal that is assumed exactly when the current frame is enabled; lit_Undef in the base frame
+    Lit getCurrentFrameGuard() {
+        FrameId id = frames.last().getId();
+        return id == 0 ? lit_Undef : ~term_mapper->getOrCreateLit(frameTerms[id]);
+    }
     std::size_t getInsertedFormulasCount() const { return insertedFormulasCount; }
 
     void initialize();
 
     virtual sstat check(); // A wrapper for solve which simplifies the loaded formulas and initializes the solvers
+    /**
+     * Checks the assertions under the assumptions, which must be Boolean variables or their negations. The assumptions
+     * are only passed to the SAT solver, so the clauses it learnt stay valid across such checks and nothing is
+     * preprocessed again. The variables should not be defined by top-level equalities, which the preprocessing may
+     * substitute away.
+     */
+    sstat checkAssuming(vec<PTRef> const & assumptions);
+    // After an unsatisfiable checkAssuming: the assumptions that are inconsistent with the assertions. Empty if the
+    // assertions alone are unsatisfiable.
+    vec<PTRef> const & getUnsatAssumptions() const;
     sstat solve();
     // Simplify frames (not yet simplified) until all are simplified or the instance is detected unsatisfiable.
     sstat simplifyFormulas();
 
     void printFramesAsQuery() const;
+    // Writes the asserted frames with the terms they are built from in the binary format of TermSnapshot
+    void saveSnapshot(std::ostream & out) const;
+    // Asserts the frames of a snapshot: the first one in the current frame, each of the others in a new pushed frame.
+    // Loading is fastest into a solver with a fresh logic.
+    void loadSnapshot(std::istream & in);
     [[nodiscard]] sstat getStatus() const { return status; }
 
     // Values
@@ -98,6 +119,8 @@ public:
 
     // Returns model of the last query (must be in satisfiable state)
     std::unique_ptr<Model> getModel();
+    // Returns values of the given terms in the model of the last query; the model is built once for the whole batch
+    std::vector<PTRef> getValues(std::vector<PTRef> const & terms);
 
     std::unique_ptr<UnsatCore> getUnsatCore() const;
 
@@ -124,6 +147,7 @@ protected:
         void push(PTRef tr) { formulas.push(tr); }
         PTRef operator[](int i) const { return formulas[i]; }
         vec<PTRef> formulas;
+        vec<PTRef> guards; // Of the formulas, if the unsat cores come from assumptions
         bool unsat{false}; // If true then the stack of frames with this frame at top is UNSAT
 
         PushFrame(PushFrame const &) = delete;
@@ -240,6 +264,15 @@ protected:
         smt_solver->addAssumptionVar(var(l));
         return frameTerm;
     }
+    // The guard of an assertion enables it only when assumed, so the guards that fail tell the unsat core
+    PTRef newAssertionGuard(unsigned int assertionIndex) {
+        auto name = std::string(Logic::s_assertionv_prefix) + std::to_string(assertionIndex);
+        PTRef guard = logic.mkBoolVar(name.c_str());
+        Lit l = term_mapper->getOrCreateLit(guard);
+        term_mapper->setFrozen(var(l));
+        smt_solver->addAssumptionVar(var(l));
+        return guard;
+    }
     bool isLastFrameUnsat() const { return frames.last().unsat; }
     void rememberLastFrameUnsat() { frames.last().unsat = true; }
     void rememberUnsatFrame(std::size_t frameIndex) {
@@ -250,6 +283,7 @@ protected:
     }
 
     inline bool trackPartitions() const;
+    inline bool guardsAssertions() const;
 
     PTRef rewriteMaxArity(PTRef root);
 
@@ -284,6 +318,11 @@ private:
     int check_called = 0;    // A counter on how many times check was called.
 
     vec<PTRef> frameTerms;
+    vec<PTRef> assumptionTerms;  // Of the current checkAssuming
+    vec<Lit> assumptionLits;
+    std::unordered_multimap<Var, int> assumptionIndices; // Into assumptionLits, by variable
+    vec<PTRef> unsatAssumptions; // Of the last check
+    vec<PTRef> coreAssertions;   // Of the last check, the assertions whose guards failed
     std::size_t firstNotSimplifiedFrame = 0;
     unsigned int insertedFormulasCount = 0;
 };
@@ -292,6 +331,11 @@ bool MainSolver::trackPartitions() const {
     assert(smt_solver);
     return smt_solver->logsResolutionProof();
 }
+
+bool MainSolver::guardsAssertions() const {
+    assert(smt_solver);
+    return config.produce_unsat_cores() and not smt_solver->logsResolutionProof();
+}
 } // namespace opensmt
 
 #endif // MAINSOLVER_H
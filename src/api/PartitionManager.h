@@ -46,6 +46,8 @@ public:
 
     void addClauseClassMask(CRef c, ipartitions_t const & toadd);
 
+    void relocateClauses(ClauseAllocator const & ca) { partitionInfo.relocateClauses(ca); }
+
     void invalidatePartitions(ipartitions_t const & toinvalidate);
 
     inline std::vector<PTRef> getPartitions() const { return partitionInfo.getTopLevelFormulas(); }
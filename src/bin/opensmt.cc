@@ -82,7 +82,9 @@ int main( int argc, char * argv[] )
 
     SMTConfig c;
     bool pipe = false;
-    while ((opt = getopt(argc, argv, "hdpir:v")) != -1) {
+    bool stream = false;
+    bool mapped = false;
+    while ((opt = getopt(argc, argv, "hdpmsir:v")) != -1) {
         switch (opt) {
 
             case 'h':
@@ -107,8 +109,14 @@ int main( int argc, char * argv[] )
             case 'p':
                 pipe = true;
                 break;
+            case 'm':
+                mapped = true;
+                break;
+            case 's':
+                stream = true;
+                break;
             default: /* '?' */
-                fprintf(stderr, "Usage:\n\t%s [-d] [-h] [-r seed] filename [...]\n",
+                fprintf(stderr, "Usage:\n\t%s [-d] [-h] [-m] [-s] [-r seed] filename [...]\n",
                         argv[0]);
                 return 0;
         }
@@ -121,6 +129,9 @@ int main( int argc, char * argv[] )
         if (pipe) {
             interpreter.interpPipe();
         }
+        else if (stream) {
+            interpreter.interpStream(stdin);
+        }
         else {
             interpretInteractive(interpreter);
         }
@@ -142,7 +153,13 @@ int main( int argc, char * argv[] )
                 opensmt_error( "SMTLIB 1.2 format is not supported in this version, sorry" );
             }
             else if ( extension != NULL && strcmp( extension, ".smt2" ) == 0 ) {
-                interpreter.interpFile(fin);
+                if (mapped) {
+                    interpreter.interpMapped(fin, stream);
+                } else if (stream) {
+                    interpreter.interpStream(fin);
+                } else {
+                    interpreter.interpFile(fin);
+                }
             }
             else
                 opensmt_error2( filename, " extension not recognized. Please use one in { smt2, cnf } or stdin (smtlib2 is assumed)" );
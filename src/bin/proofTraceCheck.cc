@@ -0,0 +1,69 @@
+// Checks a proof trace written by OpenSMT with the option :proof-trace, see smtsolvers/ProofTrace.h
+
+#include <smtsolvers/ProofTrace.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+void printUsage(char const * name) {
+    std::cerr << "Usage: " << name << " [-t] <trace>\n"
+              << "  -t  print the explanation of each theory lemma, a conjunction that should be unsatisfiable\n";
+}
+} // namespace
+
+int main(int argc, char * argv[]) {
+    using namespace opensmt;
+
+    bool printLemmas = false;
+    char const * fileName = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-t") == 0) {
+            printLemmas = true;
+        } else if (fileName == nullptr) {
+            fileName = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (fileName == nullptr) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    std::ifstream in(fileName, std::ios::in | std::ios::binary);
+    if (not in) {
+        std::cerr << "Cannot open " << fileName << '\n';
+        return 2;
+    }
+
+    ProofTraceChecker checker;
+    if (printLemmas) {
+        checker.onTheoryLemma([](std::vector<Lit> const & clause, std::vector<std::string> const & atoms) {
+            std::cout << "(and";
+            for (std::size_t i = 0; i < clause.size(); ++i) {
+                // The explanation assigns each atom the value that falsifies its literal
+                if (sign(clause[i])) {
+                    std::cout << ' ' << atoms[i];
+                } else {
+                    std::cout << " (not " << atoms[i] << ')';
+                }
+            }
+            std::cout << ")\n";
+        });
+    }
+    bool const valid = checker.check(in);
+    auto const & stats = checker.getStats();
+    std::cout << "c inputs " << stats.inputs << ", additions " << stats.additions << ", deletions " << stats.deletions
+              << ", theory lemmas " << stats.theoryLemmas << '\n';
+    if (stats.unmatchedDeletions > 0) {
+        std::cout << "c warning: ignored " << stats.unmatchedDeletions << " deletions of absent clauses\n";
+    }
+    if (not valid) {
+        std::cout << "c " << checker.getError() << '\n' << "s NOT VERIFIED" << std::endl;
+        return 1;
+    }
+    std::cout << (checker.refutes() ? "s VERIFIED" : "s VERIFIED WITHOUT REFUTATION") << std::endl;
+    return 0;
+}
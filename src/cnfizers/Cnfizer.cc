@@ -59,7 +59,7 @@ void Cnfizer::cnfize(PTRef formula, FrameId frame_id) {
     for (PTRef topLevelConjunct : top_level_formulae) {
         assert(
             not logic.isAnd(topLevelConjunct)); // Conjunction should have been split when retrieving top-level formulae
-        if (alreadyProcessed.contains(topLevelConjunct, frame_id)) { continue; }
+        if (alreadyProcessed.contains(logic.getPterm(topLevelConjunct).getId(), frame_id)) { continue; }
         TRACE("Adding clause " << logic.printTerm(f))
         // Give it to the solver if already in CNF
         if (isClause(topLevelConjunct)) {
@@ -73,11 +73,11 @@ void Cnfizer::cnfize(PTRef formula, FrameId frame_id) {
             TRACE(" => proper cnfization")
             cnfizeAndAssert(topLevelConjunct); // Perform actual cnfization (implemented in subclasses)
         }
-        alreadyProcessed.insert(topLevelConjunct, frame_id);
+        alreadyProcessed.insert(logic.getPterm(topLevelConjunct).getId(), frame_id);
     }
     vec<PTRef> nestedBoolRoots = logic.getNestedBoolRoots(formula);
     for (PTRef tr : nestedBoolRoots) {
-        cnfize(tr); // cnfize the formula without asserting the top level
+        cnfize(tr, both); // cnfize the formula without asserting the top level; the theory needs its value
     }
 }
 
@@ -85,7 +85,7 @@ void Cnfizer::cnfizeAndAssert(PTRef formula) {
     assert(formula != PTRef_Undef and not logic.isAnd(formula));
     // Add the top level literal as a unit to solver.
     addClause({this->getOrCreateLiteralFor(formula)});
-    cnfize(formula);
+    cnfize(formula, positive);
 }
 
 // Apply simple de Morgan laws to the formula
@@ -160,7 +160,11 @@ bool Cnfizer::checkPureConj(PTRef e, Map<PTRef, bool, PTRefHash> & check_cache)
 }
 
 void Cnfizer::addClause(vec<Lit> && clause) {
-    (*clauseCallBack)(std::move(clause));
+    (*clauseCallBack)(std::move(clause), false);
+}
+
+void Cnfizer::addDefinitionClause(vec<Lit> && clause) {
+    (*clauseCallBack)(std::move(clause), frameIndependentDefinitions);
 }
 
 void Cnfizer::processClause(PTRef f) {
@@ -201,14 +205,16 @@ void Cnfizer::retrieveConjuncts(PTRef f, vec<PTRef> & conjuncts) {
     }
 }
 
-bool Cnfizer::Cache::contains(PTRef term, FrameId frame) {
-    return cache.find({term, frame}) != cache.end() or
-           (frame != baseFrame and cache.find({term, baseFrame}) != cache.end());
+bool Cnfizer::Cache::contains(PTId term, FrameId frame) const {
+    if (Idx(term) >= frames.size()) { return false; }
+    FrameId const processedIn = frames[Idx(term)];
+    return processedIn == frame or processedIn == baseFrame;
 }
 
-void Cnfizer::Cache::insert(PTRef term, FrameId frame) {
+void Cnfizer::Cache::insert(PTId term, FrameId frame) {
     assert(!contains(term, frame));
-    cache.insert({term, frame});
+    if (Idx(term) >= frames.size()) { frames.resize(Idx(term) + 1, noFrame); }
+    frames[Idx(term)] = frame;
 }
 
 // TODO: Fix isAtom!!! (everything that is not a boolean connective should be considered as atom
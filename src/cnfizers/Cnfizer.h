@@ -33,7 +33,8 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <logics/Logic.h>
 #include <logics/Theory.h>
 
-#include <unordered_set>
+#include <limits>
+#include <vector>
 
 namespace opensmt {
 class SimpSMTSolver;
@@ -48,7 +49,8 @@ public:
     using FrameId = uint32_t;
 
     struct ClauseCallBack {
-        virtual void operator()(vec<Lit> &&) = 0;
+        // A frame-independent clause holds in every frame, it need not be guarded by the frame of the formula
+        virtual void operator()(vec<Lit> &&, bool frameIndependent) = 0;
     };
 
     Cnfizer(Logic & logic, TermMapper & tmap);
@@ -66,34 +68,38 @@ public:
         this->clauseCallBack = callback;
     }
 
+    // The definitions of the subterms are then cnfized only once, in the base frame, and reused by all later frames
+    void setFrameIndependentDefinitions(bool independent) { frameIndependentDefinitions = independent; }
+
 protected:
+    // The terms processed in the base frame, or in the given frame
     class Cache {
     public:
         Cache() = default;
-        bool contains(PTRef term, FrameId frame);
-        void insert(PTRef term, FrameId frame);
+        bool contains(PTId term, FrameId frame) const;
+        void insert(PTId term, FrameId frame);
 
     private:
-        using CacheEntry = std::pair<PTRef, FrameId>;
-
-        struct EntryHash {
-            std::size_t operator()(CacheEntry entry) const {
-                std::hash<uint32_t> hasher;
-                return (hasher(entry.first.x) ^ hasher(entry.second));
-            }
-        };
+        static constexpr FrameId baseFrame = 0;
+        static constexpr FrameId noFrame = std::numeric_limits<FrameId>::max();
 
-        FrameId baseFrame = 0;
-        std::unordered_set<CacheEntry, EntryHash> cache;
+        // The last frame each term was processed in, indexed by the ids of the terms. Forgetting the earlier frames
+        // only means that the term may be processed again in them.
+        std::vector<FrameId> frames;
     };
 
-    virtual void cnfize(PTRef) = 0; // Actual cnfization. To be implemented in derived classes
+    // The polarities in which a term occurs in the asserted formulas
+    enum Polarity : uint8_t { positive = 1, negative = 2, both = positive | negative };
+
+    virtual void cnfize(PTRef, Polarity) = 0; // Actual cnfization. To be implemented in derived classes
     void cnfizeAndAssert(PTRef);    // Cnfize and assert the top-level.
 
     bool isClause(PTRef);
     bool checkDeMorgan(PTRef);
     void processClause(PTRef f);
-    void addClause(vec<Lit> &&);
+    void addClause(vec<Lit> &&);           // A clause of the current formula
+    void addDefinitionClause(vec<Lit> &&); // A clause of the definition of a subterm
+    FrameId definitionFrame() const { return frameIndependentDefinitions ? 0 : currentFrameId; }
     void deMorganize(PTRef);
 
     void retrieveClause(PTRef, vec<Lit> &);
@@ -108,6 +114,7 @@ protected:
     ClauseCallBack * clauseCallBack;
 
     FrameId currentFrameId = 0;
+    bool frameIndependentDefinitions = false;
 
 private:
     // Check if a formula is purely a conjunction
@@ -9,48 +9,73 @@
 
 #include "Tseitin.h"
 
+#include <utility>
+#include <vector>
+
 namespace opensmt {
-void Tseitin::cnfize(PTRef term) {
-    vec<PTRef> unprocessed_terms{term};
+void Tseitin::cnfize(PTRef term, Polarity polarity) {
+    std::vector<std::pair<PTRef, Polarity>> unprocessed_terms{{term, polarityAware ? polarity : both}};
 
     // Visit the DAG of the formula
-    while (unprocessed_terms.size() != 0) {
-        PTRef ptr = unprocessed_terms.last();
-        unprocessed_terms.pop();
-        // Skip if the node has already been processed before
-        if (alreadyCnfized.contains(ptr, currentFrameId)) { continue; }
+    while (not unprocessed_terms.empty()) {
+        auto [ptr, wanted] = unprocessed_terms.back();
+        unprocessed_terms.pop_back();
+        // Skip if the node has already been processed before in the wanted polarities
+        Polarity const pol = missingPolarities(ptr, wanted);
+        if (pol == 0) { continue; }
 
         // Here (after the checks) not safe to use Pterm& since cnfize.* can alter the table of terms
         // by calling findLit
         int sz = logic.getPterm(ptr).size();
         if (logic.isAnd(ptr))
-            cnfizeAnd(ptr);
+            cnfizeAnd(ptr, pol);
         else if (logic.isOr(ptr))
-            cnfizeOr(ptr);
+            cnfizeOr(ptr, pol);
         else if (logic.isXor(ptr))
-            cnfizeXor(ptr);
+            cnfizeXor(ptr, pol);
         else if (logic.isIff(ptr))
-            cnfizeIff(ptr);
+            cnfizeIff(ptr, pol);
         else if (logic.isImplies(ptr))
-            cnfizeImplies(ptr);
+            cnfizeImplies(ptr, pol);
         // Ites are handled through the ite manager system and treated here as variables
         //        else if (logic.isIte(ptr))
-        //            res &= cnfizeIfthenelse(ptr);
+        //            res &= cnfizeIfthenelse(ptr, pol);
         else if (!logic.isNot(ptr) && sz > 0) { // do not recurse into atoms
             goto tseitin_end;
         }
-        for (PTRef child : logic.getPterm(ptr)) {
-            unprocessed_terms.push(child);
+        for (int i = 0; i < sz; ++i) {
+            unprocessed_terms.emplace_back(logic.getPterm(ptr)[i], childPolarity(ptr, i, pol));
         }
     tseitin_end:
-        alreadyCnfized.insert(ptr, currentFrameId);
+        if (pol & positive) { cnfizedPositively.insert(logic.getPterm(ptr).getId(), definitionFrame()); }
+        if (pol & negative) { cnfizedNegatively.insert(logic.getPterm(ptr).getId(), definitionFrame()); }
     }
 }
 
-void Tseitin::cnfizeAnd(PTRef and_term) {
+Cnfizer::Polarity Tseitin::missingPolarities(PTRef term, Polarity wanted) {
+    int missing = 0;
+    if ((wanted & positive) and not cnfizedPositively.contains(logic.getPterm(term).getId(), definitionFrame())) { missing |= positive; }
+    if ((wanted & negative) and not cnfizedNegatively.contains(logic.getPterm(term).getId(), definitionFrame())) { missing |= negative; }
+    return static_cast<Polarity>(missing);
+}
+
+Cnfizer::Polarity Tseitin::childPolarity(PTRef parent, int childIndex, Polarity parentPolarity) const {
+    auto flipped = [parentPolarity]() {
+        return static_cast<Polarity>(((parentPolarity & positive) ? negative : 0) |
+                                     ((parentPolarity & negative) ? positive : 0));
+    };
+    if (logic.isNot(parent)) { return flipped(); }
+    // The antecedent of an implication occurs in the opposite polarity
+    if (logic.isImplies(parent)) { return childIndex + 1 < logic.getPterm(parent).size() ? flipped() : parentPolarity; }
+    if (logic.isXor(parent) or logic.isIff(parent)) { return both; }
+    return parentPolarity;
+}
+
+void Tseitin::cnfizeAnd(PTRef and_term, Polarity polarity) {
     // ( a_0 & ... & a_{n-1} )
     // <=>
-    // aux = ( -aux | a_0 ) & ... & ( -aux | a_{n-1} ) & ( aux & -a_0 & ... & -a_{n-1} )
+    // aux = ( -aux | a_0 ) & ... & ( -aux | a_{n-1} ) & ( aux | -a_0 | ... | -a_{n-1} )
+    // The binary clauses are needed in the positive polarity, the big clause in the negative one
     Lit v = this->getOrCreateLiteralFor(and_term);
     vec<Lit> big_clause;
     int size = logic.getPterm(and_term).size();
@@ -60,15 +85,16 @@ void Tseitin::cnfizeAnd(PTRef and_term) {
         PTRef arg = logic.getPterm(and_term)[i];
         Lit argLit = this->getOrCreateLiteralFor(arg);
         big_clause.push(~argLit);
-        addClause({~v, argLit});
+        if (polarity & positive) { addDefinitionClause({~v, argLit}); }
     }
-    addClause(std::move(big_clause));
+    if (polarity & negative) { addDefinitionClause(std::move(big_clause)); }
 }
 
-void Tseitin::cnfizeOr(PTRef or_term) {
+void Tseitin::cnfizeOr(PTRef or_term, Polarity polarity) {
     // ( a_0 | ... | a_{n-1} )
     // <=>
     // aux = ( aux | -a_0 ) & ... & ( aux | -a_{n-1} ) & ( -aux | a_0 | ... | a_{n-1} )
+    // The big clause is needed in the positive polarity, the binary clauses in the negative one
     Lit v = this->getOrCreateLiteralFor(or_term);
     vec<Lit> big_clause;
     int size = logic.getPterm(or_term).size();
@@ -77,12 +103,12 @@ void Tseitin::cnfizeOr(PTRef or_term) {
         PTRef arg = logic.getPterm(or_term)[i];
         Lit argLit = this->getOrCreateLiteralFor(arg);
         big_clause.push(argLit);
-        addClause({v, ~argLit});
+        if (polarity & negative) { addDefinitionClause({v, ~argLit}); }
     }
-    addClause(std::move(big_clause));
+    if (polarity & positive) { addDefinitionClause(std::move(big_clause)); }
 }
 
-void Tseitin::cnfizeXor(PTRef xor_term) {
+void Tseitin::cnfizeXor(PTRef xor_term, Polarity polarity) {
     // ( a_0 xor a_1 )
     // <=>
     // aux = ( -aux | a_0  | a_1 ) & ( -aux | -a_0 | -a_1 ) &
@@ -92,17 +118,21 @@ void Tseitin::cnfizeXor(PTRef xor_term) {
     Lit arg0 = this->getOrCreateLiteralFor(logic.getPterm(xor_term)[0]);
     Lit arg1 = this->getOrCreateLiteralFor(logic.getPterm(xor_term)[1]);
 
-    // First clause
-    addClause({~v, arg0, arg1});
-    // Second clause
-    addClause({~v, ~arg0, ~arg1});
-    // Third clause
-    addClause({v, ~arg0, arg1});
-    // Fourth clause
-    addClause({v, arg0, ~arg1});
+    if (polarity & positive) {
+        // First clause
+        addDefinitionClause({~v, arg0, arg1});
+        // Second clause
+        addDefinitionClause({~v, ~arg0, ~arg1});
+    }
+    if (polarity & negative) {
+        // Third clause
+        addDefinitionClause({v, ~arg0, arg1});
+        // Fourth clause
+        addDefinitionClause({v, arg0, ~arg1});
+    }
 }
 
-void Tseitin::cnfizeIff(PTRef eq_term) {
+void Tseitin::cnfizeIff(PTRef eq_term, Polarity polarity) {
     // ( a_0 <-> a_1 )
     // <=>
     // aux = ( -aux |  a_0 | -a_1 ) & ( -aux | -a_0 |  a_1 ) &
@@ -112,17 +142,21 @@ void Tseitin::cnfizeIff(PTRef eq_term) {
     Lit arg0 = this->getOrCreateLiteralFor(logic.getPterm(eq_term)[0]);
     Lit arg1 = this->getOrCreateLiteralFor(logic.getPterm(eq_term)[1]);
 
-    // First clause
-    addClause({~v, arg0, ~arg1});
-    // Second clause
-    addClause({~v, ~arg0, arg1});
-    // Third clause
-    addClause({v, arg0, arg1});
-    // Fourth clause
-    addClause({v, ~arg0, ~arg1});
+    if (polarity & positive) {
+        // First clause
+        addDefinitionClause({~v, arg0, ~arg1});
+        // Second clause
+        addDefinitionClause({~v, ~arg0, arg1});
+    }
+    if (polarity & negative) {
+        // Third clause
+        addDefinitionClause({v, arg0, arg1});
+        // Fourth clause
+        addDefinitionClause({v, ~arg0, ~arg1});
+    }
 }
 
-void Tseitin::cnfizeIfthenelse(PTRef ite_term) {
+void Tseitin::cnfizeIfthenelse(PTRef ite_term, Polarity polarity) {
     //  (!a | !i | t) & (!a | i | e) & (a | !i | !t) & (a | i | !e)
     // ( if a_0 then a_1 else a_2 )
     // <=>
@@ -136,13 +170,17 @@ void Tseitin::cnfizeIfthenelse(PTRef ite_term) {
     Lit a1 = this->getOrCreateLiteralFor(logic.getPterm(ite_term)[1]);
     Lit a2 = this->getOrCreateLiteralFor(logic.getPterm(ite_term)[2]);
 
-    addClause({~v, ~a0, a1});
-    addClause({~v, a0, a2});
-    addClause({v, ~a0, ~a1});
-    addClause({v, a0, ~a2});
+    if (polarity & positive) {
+        addDefinitionClause({~v, ~a0, a1});
+        addDefinitionClause({~v, a0, a2});
+    }
+    if (polarity & negative) {
+        addDefinitionClause({v, ~a0, ~a1});
+        addDefinitionClause({v, a0, ~a2});
+    }
 }
 
-void Tseitin::cnfizeImplies(PTRef impl_term) {
+void Tseitin::cnfizeImplies(PTRef impl_term, Polarity polarity) {
     // ( a_0 => a_1 )
     // <=>
     // aux = ( -aux | -a_0 |  a_1 ) &
@@ -153,9 +191,11 @@ void Tseitin::cnfizeImplies(PTRef impl_term) {
     Lit a0 = this->getOrCreateLiteralFor(logic.getPterm(impl_term)[0]);
     Lit a1 = this->getOrCreateLiteralFor(logic.getPterm(impl_term)[1]);
 
-    addClause({v, a0});
-    addClause({v, ~a1});
-    addClause({~v, ~a0, a1});
+    if (polarity & negative) {
+        addDefinitionClause({v, a0});
+        addDefinitionClause({v, ~a1});
+    }
+    if (polarity & positive) { addDefinitionClause({~v, ~a0, a1}); }
 }
 
 } // namespace opensmt
@@ -19,18 +19,29 @@ class Tseitin : public Cnfizer {
 public:
     Tseitin(Logic & logic, TermMapper & tmap) : Cnfizer(logic, tmap) {}
 
+    // The polarity-aware (Plaisted-Greenbaum) encoding defines a term only in the polarities in which it occurs: the
+    // literal of a term occurring only positively implies the term, but the term need not imply the literal.
+    // The literals of such terms then do not give their values in a model.
+    void setPolarityAware(bool aware) { polarityAware = aware; }
+    bool isPolarityAware() const { return polarityAware; }
+
 private:
-    // Cache of already cnfized terms. Note that this is different from Cnfizer cache of already processed top-level
-    // flas
-    Cache alreadyCnfized;
-
-    void cnfize(PTRef) override;  // Cnfize the given term
-    void cnfizeAnd(PTRef);        // Cnfize conjunctions
-    void cnfizeOr(PTRef);         // Cnfize disjunctions
-    void cnfizeIff(PTRef);        // Cnfize iffs
-    void cnfizeXor(PTRef);        // Cnfize xors
-    void cnfizeIfthenelse(PTRef); // Cnfize if then elses
-    void cnfizeImplies(PTRef);    // Cnfize implications
+    // Caches of terms already cnfized in the positive and in the negative polarity. Note that this is different from
+    // Cnfizer cache of already processed top-level flas
+    Cache cnfizedPositively;
+    Cache cnfizedNegatively;
+    bool polarityAware = false;
+
+    void cnfize(PTRef, Polarity) override; // Cnfize the given term
+    void cnfizeAnd(PTRef, Polarity);        // Cnfize conjunctions
+    void cnfizeOr(PTRef, Polarity);         // Cnfize disjunctions
+    void cnfizeIff(PTRef, Polarity);        // Cnfize iffs
+    void cnfizeXor(PTRef, Polarity);        // Cnfize xors
+    void cnfizeIfthenelse(PTRef, Polarity); // Cnfize if then elses
+    void cnfizeImplies(PTRef, Polarity);    // Cnfize implications
+
+    Polarity missingPolarities(PTRef, Polarity wanted);
+    Polarity childPolarity(PTRef parent, int childIndex, Polarity parentPolarity) const;
 };
 } // namespace opensmt
 
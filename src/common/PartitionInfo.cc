@@ -41,6 +41,15 @@ void PartitionInfo::addClausePartition(CRef c, ipartitions_t const & p) {
     clause_class[c] |= p;
 }
 
+void PartitionInfo::relocateClauses(ClauseAllocator const & ca) {
+    std::unordered_map<CRef, ipartitions_t> relocated;
+    relocated.reserve(clause_class.size());
+    for (auto & [cref, partitions] : clause_class) {
+        if (ca[cref].reloced()) { relocated.emplace(ca[cref].relocation(), std::move(partitions)); }
+    }
+    clause_class = std::move(relocated);
+}
+
 void PartitionInfo::invalidatePartitions(ipartitions_t const & toinvalidate) {
     auto negated = ~toinvalidate;
     for (auto it = term_partitions.begin(); it != term_partitions.end(); /* deliberately empty */) {
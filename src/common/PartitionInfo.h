@@ -24,6 +24,8 @@ public:
     void addIPartitions(SymRef s, ipartitions_t const & p);
     ipartitions_t const & getClausePartitions(CRef) const;
     void addClausePartition(CRef c, ipartitions_t const & p);
+    // Moves the partitions of the clauses to their new references after garbage collection in `ca`
+    void relocateClauses(ClauseAllocator const & ca);
 
     inline std::vector<PTRef> getTopLevelFormulas() const { return flaPartitionMap.get_top_level_flas(); }
     inline unsigned int getNoOfPartitions() const { return flaPartitionMap.getNoOfPartitions(); }
@@ -554,7 +554,7 @@ PTRef ArithLogic::mkConst(SRef sort, Number const & c) {
     for (auto i = numbers.size(); i <= id; i++) {
         numbers.emplace_back();
     }
-    if (numbers[id] == nullptr) { numbers[id] = new Number(val); }
+    if (numbers[id] == nullptr) { numbers[id] = new Number(c); }
     assert(c == *numbers[id]);
     markConstant(id);
     return ptr;
@@ -762,6 +762,14 @@ PTRef ArithLogic::mkGt(vec<PTRef> const & args) {
     return mkAnd(std::move(binaryInequalities));
 }
 
+void ArithLogic::termReferences(vec<PTRef *> & refs) {
+    Logic::termReferences(refs);
+    for (PTRef * ref : {&term_Real_ZERO, &term_Real_ONE, &term_Real_MINUSONE, &term_Int_ZERO, &term_Int_ONE,
+                        &term_Int_MINUSONE}) {
+        refs.push(ref);
+    }
+}
+
 PTRef ArithLogic::mkBinaryEq(PTRef lhs, PTRef rhs) {
     if (getSortRef(rhs) != getSortRef(lhs)) { throw ApiException("Equality over non-equal sorts"); }
     if (hasUFs() or hasArrays()) { return Logic::mkBinaryEq(lhs, rhs); }
@@ -887,8 +895,7 @@ PTRef ArithLogic::mkConst(SRef s, char const * name) {
         SymId id = sym_store[getPterm(ptr).symb()].getId();
         for (auto i = numbers.size(); i <= id; i++)
             numbers.emplace_back(nullptr);
-        if (numbers[id] != nullptr) { delete numbers[id]; }
-        numbers[id] = new Number(rat);
+        if (numbers[id] == nullptr) { numbers[id] = new Number(rat); }
         free(rat);
         markConstant(id);
     } else
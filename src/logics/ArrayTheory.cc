@@ -11,9 +11,9 @@
 
 namespace opensmt {
 
-PTRef ArrayTheory::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const &) {
+PTRef ArrayTheory::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const & context) {
     // TODO: simplify select over store on the same index
-    fla = rewriteDistincts(getLogic(), fla);
+    fla = rewriteDistincts(getLogic(), fla, memoFor(distinctsMemo, context));
     fla = instantiateReadOverStore(getLogic(), fla);
     return fla;
 }
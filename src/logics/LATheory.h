@@ -38,22 +38,33 @@ public:
 namespace {
 
 template<typename TLogic>
-PTRef rewriteDivMod(TLogic &, PTRef fla) { return fla; }
+PTRef rewriteDivMod(TLogic &, PTRef fla, RewriteMemo *) { return fla; }
 
 template<>
-PTRef rewriteDivMod<ArithLogic>(ArithLogic & logic, PTRef fla) {
+PTRef rewriteDivMod<ArithLogic>(ArithLogic & logic, PTRef fla, RewriteMemo * memo) {
     // Real logic cannot have div and mod
-    return not logic.hasIntegers() ? fla : opensmt::rewriteDivMod(logic, fla);
+    return not logic.hasIntegers() ? fla : opensmt::rewriteDivMod(logic, fla, memo);
+}
+
+template<typename TLogic>
+PTRef rewriteCardinalities(TLogic &, PTRef fla, RewriteMemo *) { return fla; }
+
+template<>
+PTRef rewriteCardinalities<ArithLogic>(ArithLogic & logic, PTRef fla, RewriteMemo * memo) {
+    return opensmt::rewriteCardinalities(logic, fla, memo);
 }
 
 }
 
 template<typename LinAlgLogic, typename LinAlgTSHandler>
-PTRef LATheory<LinAlgLogic,LinAlgTSHandler>::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const &) {
-    fla = rewriteDistincts(getLogic(), fla);
-    fla = rewriteDivMod<LinAlgLogic>(lalogic, fla);
-    ArithmeticEqualityRewriter equalityRewriter(lalogic);
+PTRef LATheory<LinAlgLogic,LinAlgTSHandler>::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const & context) {
+    fla = rewriteDistincts(getLogic(), fla, memoFor(distinctsMemo, context));
+    fla = rewriteDivMod<LinAlgLogic>(lalogic, fla, memoFor(divModMemo, context));
+    ArithmeticEqualityRewriter equalityRewriter(lalogic, memoFor(arithmeticEqualitiesMemo, context));
     fla = equalityRewriter.rewrite(fla);
+    if (config.encode_cardinalities()) {
+        fla = rewriteCardinalities<LinAlgLogic>(lalogic, fla, memoFor(cardinalitiesMemo, context));
+    }
     return fla;
 }
 
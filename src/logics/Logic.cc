@@ -49,6 +49,7 @@ char const * Logic::tk_indexed = "_";
 
 char const * Logic::s_sort_bool = "Bool";
 char const * Logic::s_framev_prefix = ".frame";
+char const * Logic::s_assertionv_prefix = ".assertion";
 char const * Logic::s_abstract_value_prefix = "@";
 
 // The constructor initiates the base logic (Boolean)
@@ -278,10 +279,20 @@ bool Logic::peekSortSymbol(SortSymbol const & symbol, SSymRef & out) const {
 SSymRef Logic::declareSortSymbol(SortSymbol symbol) {
     SSymRef res;
     if (sort_store.peek(symbol, res)) { return res; }
+    if (term_store.inConcurrentConstruction()) {
+        throw ApiException("Sorts cannot be declared during concurrent term construction");
+    }
     return sort_store.newSortSymbol(std::move(symbol));
 }
 
 SRef Logic::getSort(SSymRef symbolRef, vec<SRef> && args) {
+    if (term_store.inConcurrentConstruction()) {
+        SRef existing;
+        if (not sort_store.peek(symbolRef, args, existing)) {
+            throw ApiException("Sorts cannot be declared during concurrent term construction");
+        }
+        return existing;
+    }
     auto [sr, created] = sort_store.getOrCreateSort(symbolRef, std::move(args));
     if (created) {
         instantiateFunctions(sr);
@@ -563,22 +574,22 @@ PTRef Logic::mkDistinct(vec<PTRef> && args) {
 
     SymRef diseq_sym = term_store.lookupSymbol(tk_distinct, args);
     assert(!isBooleanOperator(diseq_sym));
-    PTLKey key;
-    key.sym = diseq_sym;
-    args.moveTo(key.args);
-    if (term_store.hasCplxKey(key)) {
-        return term_store.getFromCplxMap(key);
+    PTRef existing = term_store.lookupCanonical(diseq_sym, args);
+    if (existing != PTRef_Undef) {
+        return existing;
     } else {
         if (distinctClassCount < maxDistinctClasses) {
-            PTRef res = term_store.newTerm(diseq_sym, key.args);
-            term_store.addToCplxMap(std::move(key), res);
+            if (term_store.inConcurrentConstruction()) {
+                throw ApiException("Distinction classes cannot be created during concurrent term construction");
+            }
+            PTRef res = term_store.getOrCreateCanonical(diseq_sym, args);
             distinctClassCount++;
             return res;
         } else {
             vec<PTRef> distinct_terms;
-            for (int i = 0; i < key.args.size(); i++) {
-                for (int j = i + 1; j < key.args.size(); j++) {
-                    distinct_terms.push(mkDistinct({key.args[i], key.args[j]}));
+            for (int i = 0; i < args.size(); i++) {
+                for (int j = i + 1; j < args.size(); j++) {
+                    distinct_terms.push(mkDistinct({args[i], args[j]}));
                 }
             }
             return mkAnd(std::move(distinct_terms));
@@ -615,7 +626,14 @@ PTRef Logic::mkConst(char const * name) {
 }
 
 PTRef Logic::mkVar(SRef s, char const * name, bool isInterpreted) {
-    SymRef sr = sym_store.newSymb(name, s, {}, isInterpreted ? SymConf::Interpreted : SymConf::Default);
+    SymbolConfig const & config = isInterpreted ? SymConf::Interpreted : SymConf::Default;
+    SymRef sr = sym_store.find(name, s, {}, config);
+    if (sr == SymRef_Undef) {
+        if (term_store.inConcurrentConstruction()) {
+            throw ApiException("Symbols cannot be declared during concurrent term construction");
+        }
+        sr = sym_store.newSymb(name, s, {}, config);
+    }
     assert(sr != SymRef_Undef);
     if (sr == SymRef_Undef) {
         std::cerr << "Unexpected situation in  Logic::mkVar for " << name << std::endl;
@@ -629,6 +647,9 @@ PTRef Logic::mkVar(SRef s, char const * name, bool isInterpreted) {
 }
 
 PTRef Logic::mkUniqueAbstractValue(SRef s) {
+    if (term_store.inConcurrentConstruction()) {
+        throw ApiException("Abstract values cannot be created during concurrent term construction");
+    }
     std::string uniqueName = s_abstract_value_prefix + std::to_string(abstractValueCount++);
     return mkVar(s, uniqueName.c_str());
 }
@@ -657,6 +678,10 @@ void Logic::markConstant(PTRef ptr) {
 }
 
 void Logic::markConstant(SymId id) {
+    if (id < static_cast<unsigned int>(constants.size()) and constants[id]) { return; }
+    if (term_store.inConcurrentConstruction()) {
+        throw ApiException("Constants cannot be created during concurrent term construction");
+    }
     // Code to allow efficient constant detection.
     while (id >= static_cast<unsigned int>(constants.size()))
         constants.push(false);
@@ -732,8 +757,12 @@ SymRef Logic::declareFun(std::string const & fname, SRef rsort, vec<SRef> const
     assert(rsort != SRef_Undef);
     assert(std::find(args.begin(), args.end(), SRef_Undef) == args.end());
 
-    SymRef sr = sym_store.newSymb(fname.c_str(), rsort, args, symbolConfig);
-    return sr;
+    SymRef sr = sym_store.find(fname.c_str(), rsort, args, symbolConfig);
+    if (sr != SymRef_Undef) { return sr; }
+    if (term_store.inConcurrentConstruction()) {
+        throw ApiException("Symbols cannot be declared during concurrent term construction");
+    }
+    return sym_store.newSymb(fname.c_str(), rsort, args, symbolConfig);
 }
 
 PTRef Logic::insertTerm(SymRef sym, vec<PTRef> && terms) {
@@ -758,6 +787,99 @@ PTRef Logic::insertTerm(SymRef sym, vec<PTRef> && terms) {
     return mkUninterpFun(sym, std::move(terms));
 }
 
+PTRef Logic::insertNormalizedTerm(SymRef sym, vec<PTRef> && args) {
+    if (not sym_store.isKnown(sym)) { throw ApiException("Unknown symbol"); }
+    std::string why;
+    if (not typeCheck(sym, args, why)) { throw ApiException(why); }
+    if (args.size() == 0) { return mkFun(sym, std::move(args)); }
+    return term_store.getOrCreateCanonical(sym, args);
+}
+
+void Logic::termReferences(vec<PTRef *> & refs) {
+    refs.push(&term_TRUE);
+    refs.push(&term_FALSE);
+    for (auto * entry : defaultValueForSort.getKeysAndValsPtrs()) {
+        refs.push(&entry->data);
+    }
+}
+
+std::size_t Logic::collectGarbage(vec<PTRef> & roots) {
+    if (term_store.inConcurrentConstruction()) {
+        throw ApiException("Terms cannot be collected during concurrent term construction");
+    }
+    vec<PTRef *> ownRefs;
+    termReferences(ownRefs);
+    // The auxiliary variables of IteHandler are named after their ite terms, which are kept as long as the variables
+    vec<SymRef> iteAuxSymbols;
+    vec<PTRef> iteAuxVars;
+    for (SymRef sym : sym_store.getSymbols()) {
+        if (sym_store[sym].nargs() != 0 or not term_store.hasCtermKey(sym)) { continue; }
+        if (std::string_view(getSymName(sym)).substr(0, IteHandler::itePrefix.size()) == IteHandler::itePrefix) {
+            iteAuxSymbols.push(sym);
+            iteAuxVars.push(term_store.getFromCtermMap(sym));
+        }
+    }
+
+    vec<PTRef> allRoots;
+    roots.copyTo(allRoots);
+    for (PTRef * ref : ownRefs) {
+        allRoots.push(*ref);
+    }
+    for (PTRef auxVar : iteAuxVars) {
+        allRoots.push(IteHandler::getIteTermFor(*this, auxVar));
+    }
+    vec<PTRef> weakRefs;
+    iteAuxVars.copyTo(weakRefs);
+    std::vector<UFAppearanceStatus> ufStatuses;
+    for (PTRef tr : propFormulasAppearingInUF) {
+        weakRefs.push(tr);
+        ufStatuses.push_back(appears_in_uf[Idx(getPterm(tr).getId())]);
+    }
+
+    std::size_t reclaimed = term_store.collectGarbage(allRoots, weakRefs);
+
+    int next = 0;
+    for (PTRef & root : roots) {
+        root = allRoots[next++];
+    }
+    for (PTRef * ref : ownRefs) {
+        *ref = allRoots[next++];
+    }
+    // The surviving variables keep their symbols under the names of the moved ite terms
+    vec<SymRef> renamedAuxSymbols;
+    std::vector<std::string> newAuxNames;
+    for (int i = 0; i < iteAuxVars.size(); i++) {
+        SymRef sym = iteAuxSymbols[i];
+        PTRef ite = allRoots[next++];
+        if (weakRefs[i] == PTRef_Undef) {
+            sym_store.forget(sym);
+            continue;
+        }
+        std::string_view oldName = getSymName(sym);
+        std::size_t suffixStart = oldName.find_first_not_of("0123456789", IteHandler::itePrefix.size());
+        std::string name(IteHandler::itePrefix);
+        name += std::to_string(ite.x);
+        name += oldName.substr(std::min(suffixStart, oldName.size()));
+        if (name == oldName) { continue; }
+        renamedAuxSymbols.push(sym);
+        newAuxNames.push_back(std::move(name));
+    }
+    sym_store.rename(renamedAuxSymbols, newAuxNames);
+
+    vec<PTRef> ufFormulas;
+    appears_in_uf.clear();
+    for (std::size_t i = 0; i < ufStatuses.size(); i++) {
+        PTRef tr = weakRefs[iteAuxVars.size() + static_cast<int>(i)];
+        if (tr == PTRef_Undef) { continue; }
+        ufFormulas.push(tr);
+        auto id = static_cast<int>(Idx(getPterm(tr).getId()));
+        if (appears_in_uf.size() <= id) { appears_in_uf.growTo(id + 1, UFAppearanceStatus::unseen); }
+        appears_in_uf[id] = ufStatuses[i];
+    }
+    ufFormulas.moveTo(propFormulasAppearingInUF);
+    return reclaimed;
+}
+
 PTRef Logic::mkFun(SymRef sym, vec<PTRef> && terms) {
 #ifndef NDEBUG
     std::string why;
@@ -769,45 +891,22 @@ PTRef Logic::mkFun(SymRef sym, vec<PTRef> && terms) {
         if (term_store.hasCtermKey(sym))           // cterm_map.contains(sym))
             res = term_store.getFromCtermMap(sym); // cterm_map[sym];
         else {
+            if (term_store.inConcurrentConstruction()) {
+                throw ApiException("Nullary terms cannot be created during concurrent term construction");
+            }
             res = term_store.newTerm(sym, terms);
             term_store.addToCtermMap(sym, res); // cterm_map.insert(sym, res);
         }
-    } else if (!isBooleanOperator(sym)) {
-        if (!sym_store[sym].left_assoc() && !sym_store[sym].right_assoc() && !sym_store[sym].chainable() &&
-            !sym_store[sym].pairwise() && sym_store[sym].nargs() != terms.size_()) {
-            throw ApiException(e_argnum_mismatch);
-        }
-        PTLKey k;
-        k.sym = sym;
-        terms.moveTo(k.args);
-        if (sym_store[sym].commutes()) { termSort(k.args); }
-        if (term_store.hasCplxKey(k))
-            res = term_store.getFromCplxMap(k);
-        else {
-            res = term_store.newTerm(sym, k.args);
-            term_store.addToCplxMap(std::move(k), res);
-        }
     } else {
-        // Boolean operator
-        PTLKey k;
-        k.sym = sym;
-        terms.moveTo(k.args);
-        if (term_store.hasBoolKey(k)) {         // bool_map.contains(k)) {
-            res = term_store.getFromBoolMap(k); // bool_map[k];
-#ifdef SIMPLIFY_DEBUG
-            char * ts = printTerm(res);
-            cerr << "duplicate: " << ts << std::endl;
-            ::free(ts);
-#endif
-        } else {
-            res = term_store.newTerm(sym, k.args);
-            term_store.addToBoolMap(std::move(k), res);
-#ifdef SIMPLIFY_DEBUG
-            char * ts = printTerm(res);
-            cerr << "new: " << ts << std::endl;
-            ::free(ts);
-#endif
+        // Boolean operators come here already normalized
+        if (!isBooleanOperator(sym)) {
+            if (!sym_store[sym].left_assoc() && !sym_store[sym].right_assoc() && !sym_store[sym].chainable() &&
+                !sym_store[sym].pairwise() && sym_store[sym].nargs() != terms.size_()) {
+                throw ApiException(e_argnum_mismatch);
+            }
+            if (sym_store[sym].commutes()) { termSort(terms); }
         }
+        res = term_store.getOrCreateCanonical(sym, terms);
     }
     return res;
 }
@@ -840,13 +939,7 @@ PTRef Logic::hasEquality(vec<PTRef> & args) {
     SymRef sref = term_store.lookupSymbol(tk_equals, args);
     assert(sref != SymRef_Undef);
     termSort(args);
-    PTLKey k;
-    k.sym = sref;
-    args.copyTo(k.args);
-    if (term_store.hasCplxKey(k))
-        return term_store.getFromCplxMap(k);
-    else
-        return PTRef_Undef;
+    return term_store.lookupCanonical(sref, args);
 }
 
 bool Logic::isBooleanOperator(SymRef tr) const {
@@ -1249,7 +1342,7 @@ void Logic::dumpHeaderToFile(std::ostream & dump_out) const {
 
     vec<SymRef> const & symbols = sym_store.getSymbols();
     for (SymRef s : symbols) {
-        if (s == getSym_true() || s == getSym_false()) continue;
+        if (s == getSym_true() || s == getSym_false() || sym_store.isForgotten(s)) continue;
         if (isConstant(s)) {
             if (isBuiltinConstant(s)) continue;
             dump_out << "(declare-const ";
@@ -1356,6 +1449,10 @@ std::string Logic::printSort(SRef s) const {
     return sort_store.printSort(s);
 }
 
+std::size_t Logic::getSortSize(SRef s) const {
+    return sort_store.getSize(s);
+}
+
 SRef Logic::getUniqueArgSort(SymRef sr) const {
     SRef res = SRef_Undef;
     for (SRef a : getSym(sr)) {
@@ -63,6 +63,9 @@ public:
     SRef getSortRef(SymRef sr) const;
     std::string printSort(SRef s) const;
     std::size_t getSortSize(SRef s) const;
+    SRef getSortArg(SRef s, uint32_t i) const { return sort_store[s][i]; }
+    SSymRef getSortSymRef(SRef s) const { return sort_store.getSortSym(s); }
+    SortSymbol const & getSortSymbol(SSymRef ssr) const { return sort_store[ssr]; }
     SRef declareUninterpretedSort(std::string const &);
 
     bool isArraySort(SRef sref) const { return sort_store[sref].getSymRef() == sym_ArraySort; }
@@ -99,7 +102,7 @@ public:
      *
      * Relies on a term invariant that id of a child is lower than id of a parent.
      */
-    TermMarks getTermMarks(PTId maxTermId) const { return TermMarks(auxiliaryNatSet, Idx(maxTermId) + 1); }
+    TermMarks getTermMarks(PTId maxTermId) const { return TermMarks(auxiliaryNatSet(), Idx(maxTermId) + 1); }
     // Default values for the logic
 
     // Deprecated! Use getDefaultValuePTRef instead
@@ -324,6 +327,36 @@ public:
         args.copyTo(tmp);
         return insertTerm(sym, std::move(tmp));
     }
+    // Inserts a term whose arguments are already in the form and order the term constructors produce, e.g., a term
+    // read back from a snapshot; no simplification or argument sorting is done. Throws ApiException if the symbol is
+    // unknown or the number or sorts of the arguments do not match it.
+    PTRef insertNormalizedTerm(SymRef sym, vec<PTRef> && args);
+    void reserveTerms(std::size_t numTerms) { term_store.reserve(numTerms); }
+
+    // Lets several threads build terms at once with mkAnd, mkOr, mkNot, mkXor, mkImpl, mkEq, mkIte and mkUninterpFun.
+    // The sorts, symbols and nullary terms used must exist beforehand: declaring new ones, creating new distinction
+    // classes or collecting garbage throws ApiException until the construction ends. See
+    // PtStore::beginConcurrentConstruction.
+    void beginConcurrentConstruction(std::size_t maxNewTerms, std::size_t maxNewArgs) {
+        term_store.beginConcurrentConstruction(maxNewTerms, maxNewArgs);
+    }
+    // The references of the new terms depend on how the threads interleaved
+    void endConcurrentConstruction() { term_store.endConcurrentConstruction(); }
+    // Ends the construction with the new terms in the order of their groups; see PtStore::endConcurrentConstruction
+    void endConcurrentConstruction(vec<PTRef> & results) { term_store.endConcurrentConstruction(results); }
+    // Drops all the terms of the construction, e.g., after it ran out of the reserved capacity
+    void abortConcurrentConstruction() { term_store.abortConcurrentConstruction(); }
+    void setConcurrentGroup(uint32_t group) { term_store.setConcurrentGroup(group); }
+
+    /**
+     * Reclaims the memory of the terms that are no longer needed: only the terms reachable from the roots and from the
+     * terms the logic itself refers to are kept. The roots are replaced by the new references of their terms. Any other
+     * reference to a term held outside of the logic is invalid afterwards, including the ones held by solvers built on
+     * the logic, so the terms should be collected only when no solver uses the logic. See PtStore::collectGarbage.
+     *
+     * @return the number of bytes reclaimed
+     */
+    std::size_t collectGarbage(vec<PTRef> & roots);
 
     // Top-level equalities based substitutions
     bool getNewFacts(PTRef root, MapWithKeys<PTRef, lbool, PTRefHash> & facts);
@@ -372,6 +405,7 @@ public:
     inline int verbose() const; // { return config.verbosity(); }
 
     std::size_t getNumberOfTerms() const { return term_store.getNumberOfTerms(); }
+    std::size_t getNumberOfSymbols() const { return sym_store.getSymbols().size(); }
 
     static char const * tk_val_uf_default;
     static char const * tk_val_bool_default;
@@ -391,6 +425,7 @@ public:
     static char const * s_sort_bool;
     static char const * s_ite_prefix;
     static char const * s_framev_prefix;
+    static char const * s_assertionv_prefix;
     static char const * s_abstract_value_prefix;
 
     vec<PTRef> propFormulasAppearingInUF;
@@ -406,6 +441,8 @@ protected:
     void markConstant(SymId sid);
 
     virtual PTRef mkBinaryEq(PTRef lhs, PTRef rhs);
+    // The references to terms the logic holds itself; collectGarbage keeps these terms and updates the references
+    virtual void termReferences(vec<PTRef *> & refs);
     bool isInternalSort(SRef) const;
     void newUninterpretedSortHandler(SRef);
 
@@ -436,7 +473,11 @@ protected:
     SymStore sym_store;
     PtStore term_store;
 
-    mutable nat_set auxiliaryNatSet;
+    // One per thread, so that several threads can traverse the terms at once
+    static nat_set & auxiliaryNatSet() {
+        static thread_local nat_set set;
+        return set;
+    }
 
     SSymRef sym_IndexedSort;
 
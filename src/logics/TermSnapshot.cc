@@ -0,0 +1,339 @@
+#include "TermSnapshot.h"
+
+#include <common/ApiException.h>
+#include <itehandler/IteHandler.h>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace opensmt {
+
+namespace {
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t logic;
+    uint32_t numSortSymbols;
+    uint32_t numSorts;
+    uint32_t numSymbols;
+    uint32_t numTerms;
+    uint32_t numGroups;
+    uint32_t poolWords;
+    uint32_t stringWords;
+};
+
+// Record sizes in words: sort symbol {name, arity, flags}, sort {sort symbol, nargs, args}, symbol {name, return
+// sort, nargs, args, flags}, term {symbol, nargs, args}, group {size, terms}
+constexpr std::size_t headerWords = sizeof(Header) / sizeof(uint32_t);
+constexpr std::size_t sortSymbolWords = 3;
+constexpr std::size_t sortWords = 3;
+constexpr std::size_t symbolWords = 5;
+constexpr std::size_t termWords = 3;
+constexpr std::size_t groupWords = 2;
+
+namespace SymbolFlags {
+constexpr uint32_t Interpreted = 0x1;
+constexpr uint32_t Commutes = 0x2;
+constexpr uint32_t NoScoping = 0x4;
+constexpr uint32_t Constant = 0x8;
+constexpr uint32_t IteAux = 0x10;
+constexpr uint32_t PropertyShift = 8;
+} // namespace SymbolFlags
+
+[[noreturn]] void malformed() {
+    throw ApiException("Malformed term snapshot");
+}
+
+// The auxiliary variables of IteHandler are named after the reference of their ite term, which changes on loading
+bool isIteAuxVar(Logic const & logic, PTRef tr) {
+    if (not logic.isVar(tr)) { return false; }
+    auto symName = std::string_view(logic.getSymName(tr));
+    return symName.compare(0, IteHandler::itePrefix.size(), IteHandler::itePrefix) == 0;
+}
+
+std::string_view iteAuxSuffix(std::string_view name) {
+    name.remove_prefix(IteHandler::itePrefix.size());
+    return name.substr(std::min(name.find_first_not_of("0123456789"), name.size()));
+}
+} // namespace
+
+void TermSnapshot::write(std::ostream & out, Logic const & logic, Groups const & groups) {
+    // Term references are allocation offsets, so ordering the reachable terms by reference puts children first
+    std::vector<PTRef> terms;
+    std::unordered_set<PTRef, PTRefHash> seen;
+    std::vector<PTRef> queue;
+    std::unordered_set<SymRef, SymRefHash> iteAuxSymbols;
+    for (auto const & group : groups) {
+        for (PTRef tr : group) { queue.push_back(tr); }
+    }
+    while (not queue.empty()) {
+        PTRef tr = queue.back();
+        queue.pop_back();
+        if (not seen.insert(tr).second) { continue; }
+        terms.push_back(tr);
+        for (PTRef child : logic.getPterm(tr)) {
+            if (seen.find(child) == seen.end()) { queue.push_back(child); }
+        }
+        if (isIteAuxVar(logic, tr)) {
+            iteAuxSymbols.insert(logic.getSymRef(tr));
+            queue.push_back(IteHandler::getIteTermFor(logic, tr));
+        }
+    }
+    std::sort(terms.begin(), terms.end(), [](PTRef a, PTRef b) { return a.x < b.x; });
+
+    std::vector<SymRef> symbols;
+    std::unordered_map<SymRef, uint32_t, SymRefHash> symbolIndex;
+    for (PTRef tr : terms) {
+        SymRef sym = logic.getSymRef(tr);
+        if (symbolIndex.emplace(sym, symbols.size()).second) { symbols.push_back(sym); }
+    }
+
+    // The same holds for sorts and their arguments
+    std::vector<SRef> sorts;
+    std::unordered_set<SRef, SRefHash> seenSorts;
+    std::vector<SRef> sortQueue;
+    for (SymRef sym : symbols) {
+        Symbol const & symbol = logic.getSym(sym);
+        sortQueue.push_back(symbol.rsort());
+        sortQueue.insert(sortQueue.end(), symbol.begin(), symbol.end());
+    }
+    while (not sortQueue.empty()) {
+        SRef sort = sortQueue.back();
+        sortQueue.pop_back();
+        if (not seenSorts.insert(sort).second) { continue; }
+        sorts.push_back(sort);
+        for (uint32_t i = 0; i < logic.getSortSize(sort); ++i) {
+            sortQueue.push_back(logic.getSortArg(sort, i));
+        }
+    }
+    std::sort(sorts.begin(), sorts.end(), [](SRef a, SRef b) { return a.x < b.x; });
+    std::unordered_map<SRef, uint32_t, SRefHash> sortIndex;
+    std::vector<SSymRef> sortSymbols;
+    std::unordered_map<SSymRef, uint32_t, SSymRefHash> sortSymbolIndex;
+    for (SRef sort : sorts) {
+        sortIndex.emplace(sort, sortIndex.size());
+        SSymRef ssym = logic.getSortSymRef(sort);
+        if (sortSymbolIndex.emplace(ssym, sortSymbols.size()).second) { sortSymbols.push_back(ssym); }
+    }
+
+    std::string strings;
+    auto addName = [&strings](std::string_view name) {
+        auto offset = static_cast<uint32_t>(strings.size());
+        strings.append(name);
+        strings.push_back('\0');
+        return offset;
+    };
+    std::vector<uint32_t> pool;
+    std::vector<uint32_t> records;
+    auto poolOffset = [&pool]() { return static_cast<uint32_t>(pool.size()); };
+
+    for (SSymRef ssym : sortSymbols) {
+        SortSymbol const & sortSymbol = logic.getSortSymbol(ssym);
+        records.insert(records.end(), {addName(sortSymbol.name), sortSymbol.arity, sortSymbol.flags});
+    }
+    for (SRef sort : sorts) {
+        auto nargs = static_cast<uint32_t>(logic.getSortSize(sort));
+        records.insert(records.end(), {sortSymbolIndex.at(logic.getSortSymRef(sort)), nargs, poolOffset()});
+        for (uint32_t i = 0; i < nargs; ++i) {
+            pool.push_back(sortIndex.at(logic.getSortArg(sort, i)));
+        }
+    }
+    for (SymRef sym : symbols) {
+        Symbol const & symbol = logic.getSym(sym);
+        uint32_t flags = (symbol.isInterpreted() ? SymbolFlags::Interpreted : 0) |
+                         (symbol.commutes() ? SymbolFlags::Commutes : 0) |
+                         (symbol.noScoping() ? SymbolFlags::NoScoping : 0) |
+                         (logic.isConstant(sym) ? SymbolFlags::Constant : 0) |
+                         (static_cast<uint32_t>(symbol.type()) << SymbolFlags::PropertyShift);
+        std::string_view symName = logic.getSymName(sym);
+        if (iteAuxSymbols.count(sym) > 0) {
+            // Only the suffix is stored; the term refers to its ite term instead
+            flags |= SymbolFlags::IteAux;
+            symName = iteAuxSuffix(symName);
+        }
+        records.insert(records.end(),
+                       {addName(symName), sortIndex.at(symbol.rsort()), symbol.nargs(), poolOffset(), flags});
+        for (SRef argSort : symbol) {
+            pool.push_back(sortIndex.at(argSort));
+        }
+    }
+    std::unordered_map<PTRef, uint32_t, PTRefHash> termIndex;
+    termIndex.reserve(terms.size());
+    for (PTRef tr : terms) {
+        Pterm const & term = logic.getPterm(tr);
+        if (iteAuxSymbols.count(term.symb()) > 0) {
+            // The ite term was created before its auxiliary variable, so it is already indexed
+            records.insert(records.end(), {symbolIndex.at(term.symb()), 1, poolOffset()});
+            pool.push_back(termIndex.at(IteHandler::getIteTermFor(logic, tr)));
+            termIndex.emplace(tr, termIndex.size());
+            continue;
+        }
+        records.insert(records.end(), {symbolIndex.at(term.symb()), static_cast<uint32_t>(term.size()), poolOffset()});
+        for (PTRef child : term) {
+            pool.push_back(termIndex.at(child));
+        }
+        termIndex.emplace(tr, termIndex.size());
+    }
+    for (auto const & group : groups) {
+        records.insert(records.end(), {static_cast<uint32_t>(group.size()), poolOffset()});
+        for (PTRef tr : group) {
+            pool.push_back(termIndex.at(tr));
+        }
+    }
+
+    strings.resize((strings.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t) * sizeof(uint32_t), '\0');
+    Header header{magic,
+                  version,
+                  static_cast<uint32_t>(logic.getLogic()),
+                  static_cast<uint32_t>(sortSymbols.size()),
+                  static_cast<uint32_t>(sorts.size()),
+                  static_cast<uint32_t>(symbols.size()),
+                  static_cast<uint32_t>(terms.size()),
+                  static_cast<uint32_t>(groups.size()),
+                  static_cast<uint32_t>(pool.size()),
+                  static_cast<uint32_t>(strings.size() / sizeof(uint32_t))};
+    out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    out.write(reinterpret_cast<char const *>(records.data()), records.size() * sizeof(uint32_t));
+    out.write(reinterpret_cast<char const *>(pool.data()), pool.size() * sizeof(uint32_t));
+    out.write(strings.data(), strings.size());
+}
+
+TermSnapshot::Groups TermSnapshot::read(std::istream & in, Logic & logic) {
+    std::string bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    if (bytes.size() % sizeof(uint32_t) != 0) { malformed(); }
+    std::vector<uint32_t> words(bytes.size() / sizeof(uint32_t));
+    std::memcpy(words.data(), bytes.data(), bytes.size());
+    return read(words.data(), words.size(), logic);
+}
+
+TermSnapshot::Groups TermSnapshot::read(uint32_t const * data, std::size_t numWords, Logic & logic) {
+    if (numWords < headerWords) { malformed(); }
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != magic or header.version != version) { malformed(); }
+    if (header.logic != static_cast<uint32_t>(logic.getLogic())) {
+        throw ApiException("Term snapshot was made with a different logic");
+    }
+    std::size_t expectedWords = headerWords + sortSymbolWords * std::size_t(header.numSortSymbols) +
+                                sortWords * std::size_t(header.numSorts) + symbolWords * std::size_t(header.numSymbols) +
+                                termWords * std::size_t(header.numTerms) + groupWords * std::size_t(header.numGroups) +
+                                header.poolWords + header.stringWords;
+    if (numWords != expectedWords) { malformed(); }
+
+    uint32_t const * record = data + headerWords;
+    uint32_t const * pool = data + expectedWords - header.stringWords - header.poolWords;
+    char const * strings = reinterpret_cast<char const *>(pool + header.poolWords);
+    std::size_t stringBytes = std::size_t(header.stringWords) * sizeof(uint32_t);
+    if (stringBytes > 0 and strings[stringBytes - 1] != '\0') { malformed(); }
+
+    auto name = [&](uint32_t offset) {
+        if (offset >= stringBytes) { malformed(); }
+        return strings + offset;
+    };
+    // Arguments of a record; each must be an index below bound
+    auto args = [&](uint32_t offset, uint32_t size, uint32_t bound) {
+        if (std::size_t(offset) + size > header.poolWords) { malformed(); }
+        uint32_t const * begin = pool + offset;
+        if (std::any_of(begin, begin + size, [bound](uint32_t index) { return index >= bound; })) { malformed(); }
+        return begin;
+    };
+
+    std::vector<SSymRef> sortSymbols;
+    sortSymbols.reserve(header.numSortSymbols);
+    for (uint32_t i = 0; i < header.numSortSymbols; ++i, record += sortSymbolWords) {
+        sortSymbols.push_back(logic.declareSortSymbol(SortSymbol(name(record[0]), record[1], record[2])));
+    }
+    std::vector<SRef> sorts;
+    sorts.reserve(header.numSorts);
+    for (uint32_t i = 0; i < header.numSorts; ++i, record += sortWords) {
+        if (record[0] >= header.numSortSymbols) { malformed(); }
+        SSymRef ssym = sortSymbols[record[0]];
+        if (record[1] != logic.getSortSymbol(ssym).arity) { malformed(); }
+        uint32_t const * sortArgs = args(record[2], record[1], i);
+        vec<SRef> argSorts;
+        for (uint32_t j = 0; j < record[1]; ++j) {
+            argSorts.push(sorts[sortArgs[j]]);
+        }
+        sorts.push_back(logic.getSort(ssym, std::move(argSorts)));
+    }
+    // Constants and ite auxiliary variables are made with their terms: a constant to get its reference in the order
+    // of the stored terms, an auxiliary variable once the new reference of its ite term is known
+    struct LoadedSymbol {
+        SymRef sym;
+        SRef sort;
+        char const * name;
+        uint32_t flags;
+    };
+    std::vector<LoadedSymbol> symbols;
+    symbols.reserve(header.numSymbols);
+    for (uint32_t i = 0; i < header.numSymbols; ++i, record += symbolWords) {
+        if (record[1] >= header.numSorts) { malformed(); }
+        char const * symName = name(record[0]);
+        SRef rsort = sorts[record[1]];
+        uint32_t flags = record[4];
+        if (flags & (SymbolFlags::Constant | SymbolFlags::IteAux)) {
+            if (record[2] != 0) { malformed(); }
+            symbols.push_back({SymRef_Undef, rsort, symName, flags});
+            continue;
+        }
+        uint32_t const * symArgs = args(record[3], record[2], header.numSorts);
+        vec<SRef> argSorts;
+        for (uint32_t j = 0; j < record[2]; ++j) {
+            argSorts.push(sorts[symArgs[j]]);
+        }
+        uint32_t property = flags >> SymbolFlags::PropertyShift;
+        if (property > static_cast<uint32_t>(SymbolProperty::Pairwise)) { malformed(); }
+        SymbolConfig config{(flags & SymbolFlags::Interpreted) != 0, (flags & SymbolFlags::Commutes) != 0,
+                            (flags & SymbolFlags::NoScoping) != 0, static_cast<SymbolProperty>(property)};
+        symbols.push_back({logic.declareFun(symName, rsort, argSorts, config), rsort, symName, flags});
+    }
+
+    logic.reserveTerms(header.numTerms);
+    std::vector<PTRef> terms;
+    terms.reserve(header.numTerms);
+    // While the new references keep the order of the stored terms, the stored argument order is still canonical
+    bool orderPreserved = true;
+    for (uint32_t i = 0; i < header.numTerms; ++i, record += termWords) {
+        if (record[0] >= header.numSymbols) { malformed(); }
+        LoadedSymbol const & symbol = symbols[record[0]];
+        uint32_t const * termArgs = args(record[2], record[1], i);
+        PTRef tr = PTRef_Undef;
+        if (symbol.flags & SymbolFlags::Constant) {
+            tr = logic.mkConst(symbol.sort, symbol.name);
+        } else if (symbol.flags & SymbolFlags::IteAux) {
+            if (record[1] != 1 or not logic.isIte(terms[termArgs[0]])) { malformed(); }
+            std::string auxName(IteHandler::itePrefix);
+            auxName += std::to_string(terms[termArgs[0]].x);
+            auxName += symbol.name;
+            tr = logic.mkVar(symbol.sort, auxName.c_str());
+        } else {
+            vec<PTRef> children;
+            children.capacity(static_cast<int>(record[1]));
+            for (uint32_t j = 0; j < record[1]; ++j) {
+                children.push(terms[termArgs[j]]);
+            }
+            tr = orderPreserved ? logic.insertNormalizedTerm(symbol.sym, std::move(children))
+                                : logic.insertTerm(symbol.sym, std::move(children));
+        }
+        if (not terms.empty() and tr.x <= terms.back().x) { orderPreserved = false; }
+        terms.push_back(tr);
+    }
+
+    Groups groups(header.numGroups);
+    for (auto & group : groups) {
+        uint32_t const * members = args(record[1], record[0], header.numTerms);
+        for (uint32_t j = 0; j < record[0]; ++j) {
+            group.push(terms[members[j]]);
+        }
+        record += groupWords;
+    }
+    return groups;
+}
+
+} // namespace opensmt
@@ -0,0 +1,48 @@
+#ifndef OPENSMT_TERMSNAPSHOT_H
+#define OPENSMT_TERMSNAPSHOT_H
+
+#include "Logic.h"
+
+#include <minisat/mtl/Vec.h>
+#include <pterms/PTRef.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace opensmt {
+
+/**
+ * Binary snapshot of groups of terms (e.g., the assertion frames of a solver) together with the sorts, symbols and
+ * term DAG they are built from.
+ *
+ * The snapshot is a sequence of 32-bit words in native byte order: a fixed header, then fixed-size records for sort
+ * symbols, sorts, symbols, terms and groups, one pool of argument indices and the NUL-terminated names. Every
+ * reference is an index into an earlier table, and terms are stored children first, so the terms can be appended to
+ * a logic in a single pass over the data, which may as well be a memory-mapped file.
+ *
+ * Loading does not go through the term constructors: the stored terms are already in normal form, so each term costs
+ * a check of its arguments against its symbol and one lookup in the term store instead of the simplification and
+ * argument sorting of the constructors.
+ * This relies on the loaded terms getting references in the same relative order as the saved ones, which holds when
+ * loading into a fresh logic; once it fails the remaining terms are rebuilt with the regular constructors.
+ */
+class TermSnapshot {
+public:
+    using Groups = std::vector<vec<PTRef>>;
+
+    static void write(std::ostream & out, Logic const & logic, Groups const & groups);
+
+    // Reads a snapshot into the logic and returns the stored groups; throws ApiException on malformed input or if the
+    // snapshot was made with a different logic.
+    static Groups read(std::istream & in, Logic & logic);
+    static Groups read(uint32_t const * data, std::size_t numWords, Logic & logic);
+
+    static constexpr uint32_t magic = 0x534d534f; // "OSMS"
+    static constexpr uint32_t version = 1;
+};
+
+} // namespace opensmt
+
+#endif // OPENSMT_TERMSNAPSHOT_H
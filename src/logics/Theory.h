@@ -29,8 +29,10 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Logic.h"
 
 #include <api/PartitionManager.h>
+#include <rewriters/Rewriter.h>
 #include <tsolvers/UFTHandler.h>
 
+#include <iostream>
 #include <memory>
 
 namespace opensmt {
@@ -46,6 +48,17 @@ class Theory
 
     SMTConfig & config;
 
+    // Results of the rewritings in preprocessing, kept for the later frames; see RewriteMemo
+    RewriteMemo distinctsMemo;
+    RewriteMemo divModMemo;
+    RewriteMemo arithmeticEqualitiesMemo;
+    RewriteMemo cardinalitiesMemo;
+
+    // Partitions are rewritten each on its own, without the results of the other ones
+    static RewriteMemo * memoFor(RewriteMemo & memo, PreprocessingContext const & context) {
+        return context.perPartition ? nullptr : &memo;
+    }
+
     Theory(SMTConfig &c) : config(c) { }
 
   public:
@@ -58,7 +71,33 @@ class Theory
     virtual PTRef preprocessAfterSubstitutions(PTRef, PreprocessingContext const &) = 0;
     virtual void afterPreprocessing(span<const PTRef>) {}
 
-    virtual                ~Theory() = default;
+    // The solver enters or leaves an assertion frame
+    void pushFrame() {
+        for (RewriteMemo * memo : {&distinctsMemo, &divModMemo, &arithmeticEqualitiesMemo, &cardinalitiesMemo}) {
+            memo->push();
+        }
+    }
+    void popFrame() {
+        for (RewriteMemo * memo : {&distinctsMemo, &divModMemo, &arithmeticEqualitiesMemo, &cardinalitiesMemo}) {
+            memo->pop();
+        }
+    }
+
+    void printStatistics(std::ostream & os) const {
+        auto printMemo = [&os](char const * name, RewriteMemo const & memo) {
+            os << name << memo.getHits() << " of " << memo.getLookups() << " (" << 100 * memo.hitRate() << "%)\n";
+        };
+        printMemo("; Distinct memo hits.......: ", distinctsMemo);
+        printMemo("; Div/mod memo hits........: ", divModMemo);
+        printMemo("; Arith. eq. memo hits.....: ", arithmeticEqualitiesMemo);
+        printMemo("; Cardinality memo hits....: ", cardinalitiesMemo);
+    }
+
+    virtual ~Theory() {
+#ifdef STATISTICS
+        printStatistics(std::cerr);
+#endif // STATISTICS
+    }
 };
 
 class UFTheory : public Theory
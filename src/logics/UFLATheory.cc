@@ -9,9 +9,12 @@
 
 namespace opensmt {
 
-PTRef UFLATheory::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const &) {
-    fla = rewriteDistincts(getLogic(), fla);
-    fla = rewriteDivMod<ArithLogic>(logic, fla);
+PTRef UFLATheory::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const & context) {
+    fla = rewriteDistincts(getLogic(), fla, memoFor(distinctsMemo, context));
+    fla = rewriteDivMod<ArithLogic>(logic, fla, memoFor(divModMemo, context));
+    if (config.encode_cardinalities()) {
+        fla = rewriteCardinalities<ArithLogic>(logic, fla, memoFor(cardinalitiesMemo, context));
+    }
     PTRef purified = purify(fla);
     if (logic.hasArrays()) {
         purified = instantiateReadOverStore(logic, purified);
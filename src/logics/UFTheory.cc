@@ -12,7 +12,7 @@ PTRef UFTheory::preprocessBeforeSubstitutions(PTRef fla, PreprocessingContext co
 PTRef UFTheory::preprocessAfterSubstitutions(PTRef fla, PreprocessingContext const & context) {
     using namespace opensmt;
     fla = context.frameCount == 0 ? rewriteDistinctsKeepTopLevel(getLogic(), fla)
-                               : rewriteDistincts(getLogic(), fla);
+                               : rewriteDistincts(getLogic(), fla, memoFor(distinctsMemo, context));
     AppearsInUfVisitor(getLogic()).visit(fla);
     return fla;
 }
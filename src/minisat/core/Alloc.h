@@ -71,6 +71,7 @@ class RegionAllocator
 
     Ref      alloc     (int size);
     void     free      (int size)    { wasted_ += size; }
+    void     shrink    (uint32_t size) { assert(size <= sz); sz -= size; }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
     T&       operator[](Ref r)       { assert(r < sz); return memory[r]; }
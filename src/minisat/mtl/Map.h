@@ -392,12 +392,14 @@ public:
     void remove(const K& k) {
         assert(table != NULL);
         std::vector<Pair>& ps = table[index(k)];
-        int j = 0;
+        std::size_t j = 0;
         for (; j < ps.size() && !equals(ps[j].key, k); j++);
         assert(j < ps.size());
-        ps[j].key = ps.last().key;
-        ps.last().data.copyTo(ps[j].data);
-        ps.pop();
+        if (j + 1 != ps.size()) {
+            ps[j].key = ps.back().key;
+            ps.back().data.moveTo(ps[j].data);
+        }
+        ps.pop_back();
         size--;
     }
 
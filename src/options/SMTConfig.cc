@@ -398,6 +398,10 @@ namespace opensmt {
           int seed = value.getValue().numval;
           if (seed == 0) { msg = s_err_seed_zero; return false; }
       }
+      if (strcmp(name, o_dl_propagation_bound) == 0) {
+          if (value.getValue().type != O_NUM) { msg = s_err_not_num; return false; }
+          if (value.getValue().numval < 0) { msg = s_err_negative; return false; }
+      }
 
       if (strcmp(name, o_sat_split_type) == 0) {
           if (value.getValue().type != O_STR) { msg = s_err_not_str; return false; }
@@ -407,6 +411,9 @@ namespace opensmt {
                   strcmp(val, spts_none) != 0)
           { msg = s_err_unknown_split; return false; }
       }
+      if (strcmp(name, o_proof_trace) == 0) {
+          if (value.getValue().type != O_STR) { msg = s_err_not_str; return false; }
+      }
       if (strcmp(name, o_sat_split_units) == 0) {
           if (value.getValue().type != O_STR) { msg = s_err_not_str; return false; }
           const char* val = value.getValue().strval;
@@ -448,6 +455,8 @@ namespace opensmt {
   const char* SMTConfig::o_produce_models = ":produce-models";
   const char* SMTConfig::o_produce_unsat_cores = ":produce-unsat-cores";
   const char* SMTConfig::o_minimal_unsat_cores = ":minimal-unsat-cores";
+  const char* SMTConfig::o_minimal_unsat_cores_alg = ":minimal-unsat-cores-algorithm";
+  const char* SMTConfig::o_unsat_cores_from_assumptions = ":unsat-cores-from-assumptions";
   const char* SMTConfig::o_print_cores_full = ":print-cores-full";
   const char* SMTConfig::o_verbosity      = ":verbosity";
   const char* SMTConfig::o_incremental    = ":incremental";
@@ -482,6 +491,7 @@ namespace opensmt {
   const char* SMTConfig::o_proof_multiple_inter    = ":proof-interpolation-property";
   const char* SMTConfig::o_proof_alternative_inter = ":proof-alternative-inter";
   const char* SMTConfig::o_proof_reduce  = ":proof-reduce";
+  const char* SMTConfig::o_proof_trace   = ":proof-trace";
   const char* SMTConfig::o_proof_rec_piv = ":proof-rpi";
   const char* SMTConfig::o_proof_push_units = ":proof-lower-units";
   const char* SMTConfig::o_proof_transf_trav = ":proof-reduce-expose";
@@ -499,6 +509,7 @@ namespace opensmt {
   const char* SMTConfig::o_ghost_vars = ":ghost-vars";
   const char* SMTConfig::o_dump_query = ":dump-query";
   const char* SMTConfig::o_dump_query_name = ":dump-query-name";
+  const char* SMTConfig::o_preprocessing_threads = ":preprocessing-threads";
   const char* SMTConfig::o_inst_name = ":instance-name";
   const char* SMTConfig::o_dump_only = ":dump-only";
   const char* SMTConfig::o_sat_dump_learnts = ":dump-learnts";
@@ -516,6 +527,9 @@ namespace opensmt {
   const char* SMTConfig::o_sat_remove_symmetries = ":remove-symmetries";
   const char* SMTConfig::o_dryrun = ":dryrun";
   const char* SMTConfig::o_do_substitutions = ":do-substitutions";
+  const char* SMTConfig::o_polarity_aware_cnf = ":polarity-aware-cnf";
+  const char* SMTConfig::o_encode_cardinalities = ":encode-cardinalities";
+  const char* SMTConfig::o_dl_propagation_bound = ":dl-propagation-bound";
   const char* SMTConfig::o_respect_logic_partitioning_hints = ":respect-logic-partitioning-hints"; // Logic can have a say whether a var is good for partitioning
   const char* SMTConfig::o_sat_scatter_split = ":scatter-split";
   const char* SMTConfig::o_sat_lookahead_split = ":lookahead-split";
@@ -537,6 +551,7 @@ namespace opensmt {
   const char* SMTConfig::s_err_not_bool = "expected Boolean";
   const char* SMTConfig::s_err_not_num = "expected number";
   const char* SMTConfig::s_err_seed_zero = "seed cannot be 0";
+  const char* SMTConfig::s_err_negative = "expected non-negative number";
   const char* SMTConfig::s_err_unknown_split = "unknown split type";
   const char* SMTConfig::s_err_unknown_units = "unknown split units";
 
@@ -36,6 +36,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <iostream>
 #include <list>
 #include <string>
+#include <vector>
 #include <fstream>
 
 namespace opensmt {
@@ -80,26 +81,43 @@ namespace opensmt {
       , CONST_T    , CONSTL_T
   };
 
+  class FastRational;
+
   class ASTNode {
     private:
       ASTType             type;
       tokens::smt2token   tok;
       char*               val;
+      bool                ownsValue = true;
+      FastRational const* number = nullptr;
       static const char*  typestr[];
     public:
+      // Tags a value that outlives the node, e.g., a text interned by the scanner
+      struct Borrowed {};
+
       std::vector< ASTNode* >*children;
       ASTNode(ASTType t, tokens::smt2token tok) : type(t), tok(tok), val(NULL), children(NULL) {}
       ASTNode(ASTType t, char* v) : type(t), tok({tokens::t_none}), val(v), children(NULL) {}
+      ASTNode(ASTType t, char* v, Borrowed) : type(t), tok({tokens::t_none}), val(v), ownsValue(false), children(NULL) {}
       ASTNode(ASTNode const &) = delete;
       ASTNode & operator=(ASTNode const &) = delete;
       ~ASTNode() {
           if (children) {
-              for (auto ci = children->begin(); ci != children->end(); ci++) {
-                  delete *ci;
-              };
+              // Detach the descendants before deleting them, so that deep trees are freed without recursion
+              std::vector<ASTNode*> pending(children->begin(), children->end());
               delete children;
+              while (not pending.empty()) {
+                  ASTNode * node = pending.back();
+                  pending.pop_back();
+                  if (node and node->children) {
+                      pending.insert(pending.end(), node->children->begin(), node->children->end());
+                      delete node->children;
+                      node->children = nullptr;
+                  }
+                  delete node;
+              }
           }
-          free(val);
+          if (ownsValue) { free(val); }
       }
 
       void                   print(std::ostream& o, int indent);
@@ -107,6 +125,9 @@ namespace opensmt {
       inline ASTType         getType()   const { return type; }
       inline const char      *getValue()  const { return val; }
       inline const tokens::smt2token getToken()  const { return tok; }
+      // The value of a numeral or decimal if the scanner parsed it already, nullptr otherwise
+      inline const FastRational *getNumber() const { return number; }
+      inline void            setNumber(const FastRational * n) { number = n; }
   };
 
 
@@ -272,6 +293,8 @@ namespace opensmt {
     static const char* o_proof_multiple_inter;
     static const char* o_proof_alternative_inter;
     static const char* o_proof_reduce;
+    // File to which the SAT solver streams a clausal proof trace as it runs, see ProofTrace.h
+    static const char* o_proof_trace;
     static const char* o_itp_bool_alg;
     static const char* o_itp_euf_alg;
     static const char* o_itp_lra_alg;
@@ -286,6 +309,8 @@ namespace opensmt {
     static const char* o_dump_mode;
     static const char* o_dump_query;
     static const char* o_dump_query_name;
+    // Threads for rewriting the independent top-level conjuncts; 0 leaves the rewriting to the main thread
+    static const char* o_preprocessing_threads;
     static const char* o_sat_dump_learnts;
     static const char* o_sat_split_type;
     static const char* o_sat_split_inittune;
@@ -308,12 +333,22 @@ namespace opensmt {
     static const char* o_produce_unsat_cores;
     // Produce the unsat cores as locally minimal (i.e. subset-minimal)
     static const char* o_minimal_unsat_cores;
+    // How the unsat cores are minimized: 0 drops the elements one by one, 1 uses QuickXplain
+    static const char* o_minimal_unsat_cores_alg;
+    // Extract the unsat cores from the failed guards of the assertions instead of from the resolution proof
+    static const char* o_unsat_cores_from_assumptions;
     // Make unsat cores agnostic to the smt2 attribute ':named'
     // (although aimed at printing, the computation also must be agnostic, consequently)
     static const char* o_print_cores_full;
     static const char* o_sat_remove_symmetries;
     static const char* o_dryrun;
     static const char* o_do_substitutions;
+    // Encode the Boolean structure with only the halves of the Tseitin definitions that the polarities of the terms need
+    static const char* o_polarity_aware_cnf;
+    // Encode inequalities over sums of numeric ites with constant branches as Boolean counters over their conditions
+    static const char* o_encode_cardinalities;
+    // Max. vertices explored in each direction when the difference-logic solver deduces from an edge; 0 - unbounded
+    static const char* o_dl_propagation_bound;
     static const char* o_respect_logic_partitioning_hints;
     static const char* o_output_dir;
     static const char* o_ghost_vars;
@@ -327,6 +362,7 @@ namespace opensmt {
     static const char* s_err_not_bool;
     static const char* s_err_not_num;
     static const char* s_err_seed_zero;
+    static const char* s_err_negative;
     static const char* s_err_unknown_split;
     static const char* s_err_unknown_units;
 
@@ -345,7 +381,7 @@ namespace opensmt {
         return strcmp(o_name, o_produce_inter) == 0 || strcmp(o_name, o_produce_proofs) == 0
           || strcmp(o_name, o_sat_pure_lookahead) == 0 || strcmp(o_name, o_sat_lookahead_split) == 0
           || strcmp(o_name, o_sat_picky) == 0 || strcmp(o_name, o_sat_scatter_split) == 0
-          || strcmp(o_name, o_ghost_vars) == 0;
+          || strcmp(o_name, o_ghost_vars) == 0 || strcmp(o_name, o_proof_trace) == 0;
     }
 
     void          insertOption(const char* o_name, SMTOption* o) {
@@ -438,6 +474,7 @@ namespace opensmt {
     inline int  getRandomSeed   ( ) const { return optionTable.has(o_random_seed) ? optionTable[o_random_seed]->getValue().numval : 91648253; }
     inline void setProduceModels( ) { insertOption(o_produce_models, new SMTOption(1)); }
     inline bool setRandomSeed(int seed) { insertOption(o_random_seed, new SMTOption(seed)); return true; }
+    inline void setDLPropagationBound(int bound) { insertOption(o_dl_propagation_bound, new SMTOption(bound)); }
 
     void setUsedForInitiliazation() { usedForInitialization = true; }
 
@@ -523,6 +560,13 @@ namespace opensmt {
     bool minimal_unsat_cores() const {
         return optionTable.has(o_minimal_unsat_cores) && optionTable[o_minimal_unsat_cores]->getValue().numval > 0;
     }
+    int minimal_unsat_cores_alg() const {
+        return optionTable.has(o_minimal_unsat_cores_alg) ? optionTable[o_minimal_unsat_cores_alg]->getValue().numval : 0;
+    }
+    bool unsat_cores_from_assumptions() const {
+        return optionTable.has(o_unsat_cores_from_assumptions)
+            && optionTable[o_unsat_cores_from_assumptions]->getValue().numval > 0;
+    }
     bool print_cores_full() const {
         return optionTable.has(o_print_cores_full) && optionTable[o_print_cores_full]->getValue().numval > 0;
     }
@@ -594,8 +638,8 @@ namespace opensmt {
       { return optionTable.has(o_certify_inter) ?
           optionTable[o_certify_inter]->getValue().numval : 0; }
     bool produce_proof() const
-      { // produce_inter or produce_unsat_core => produce_proof
-        if (produce_inter() or produce_unsat_cores()) return true;
+      { // produce_inter or produce_unsat_core => produce_proof, unless the cores come from assumptions
+        if (produce_inter() or (produce_unsat_cores() and not unsat_cores_from_assumptions())) return true;
         return optionTable.has(o_produce_proofs) ?
           optionTable[o_produce_proofs]->getValue().numval > 0 : false; }
     bool produce_inter() const
@@ -634,6 +678,9 @@ namespace opensmt {
     int proof_reduce() const
       { return optionTable.has(o_proof_reduce) ?
           optionTable[o_proof_reduce]->getValue().numval : 0; }
+    std::string proof_trace() const
+      { return optionTable.has(o_proof_trace) ?
+          optionTable[o_proof_trace]->getValue().strval : ""; }
     int itp_bool_alg() const
       { return optionTable.has(o_itp_bool_alg) ?
           optionTable[o_itp_bool_alg]->getValue().numval : 0; }
@@ -724,6 +771,10 @@ namespace opensmt {
           return name;
       }
 
+    int preprocessing_threads() const
+      { return optionTable.has(o_preprocessing_threads) ?
+          optionTable[o_preprocessing_threads]->getValue().numval : 0; }
+
     int sat_dump_learnts() const
       { return optionTable.has(o_sat_dump_learnts) ?
           optionTable[o_sat_dump_learnts]->getValue().numval : 0; }
@@ -838,6 +889,15 @@ namespace opensmt {
     int do_substitutions() const
       { return optionTable.has(o_do_substitutions) ?
           optionTable[o_do_substitutions]->getValue().numval : 1; }
+    bool polarity_aware_cnf() const
+      { return optionTable.has(o_polarity_aware_cnf) ?
+          optionTable[o_polarity_aware_cnf]->getValue().numval > 0 : false; }
+    bool encode_cardinalities() const
+      { return optionTable.has(o_encode_cardinalities) ?
+          optionTable[o_encode_cardinalities]->getValue().numval > 0 : false; }
+    int dl_propagation_bound() const
+      { return optionTable.has(o_dl_propagation_bound) ?
+          optionTable[o_dl_propagation_bound]->getValue().numval : 0; }
 
 
     bool use_theory_polarity_suggestion() const
@@ -0,0 +1,378 @@
+#include "smt2mappedlexer.h"
+
+#include <api/smt2tokens.h>
+#include <parsers/smt2new/smt2newcontext.h>
+
+using namespace opensmt;
+
+#include "smt2newparser.hh"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace opensmt::tokens;
+
+namespace opensmt {
+
+MappedFile::MappedFile(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0 or not S_ISREG(st.st_mode)) { return; }
+    size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        mapped = true;
+        return;
+    }
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        size = 0;
+        return;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    mapped = true;
+}
+
+MappedFile::~MappedFile() {
+    if (data) { munmap(data, size); }
+}
+
+namespace {
+// Character classes of smt2newlexer.ll
+bool isSymbolStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) or (c != '\0' and std::strchr("~!@$%^&*-+=<>.?/'_", c));
+}
+
+bool isSymbolChar(char c) {
+    return isSymbolStart(c) or std::isdigit(static_cast<unsigned char>(c));
+}
+
+bool isKeywordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) or (c != '\0' and std::strchr("~!@$%^&*_-+=<>.?/", c));
+}
+
+bool isDigit(char c) { return c >= '0' and c <= '9'; }
+
+// Lengths of the longest prefixes of s matching the numeral, decimal and symbol patterns
+std::size_t numeralLength(std::string_view s) {
+    if (not s.empty() and s[0] == '0') { return 1; }
+    std::size_t i = (not s.empty() and s[0] == '-') ? 1 : 0;
+    if (i >= s.size() or s[i] < '1' or s[i] > '9') { return 0; }
+    while (++i < s.size() and isDigit(s[i])) {}
+    if (i + 1 < s.size() and s[i] == '/' and s[i + 1] >= '1' and s[i + 1] <= '9') {
+        ++i;
+        while (++i < s.size() and isDigit(s[i])) {}
+    }
+    return i;
+}
+
+std::size_t decimalLength(std::string_view s) {
+    std::size_t i = (not s.empty() and s[0] == '-') ? 1 : 0;
+    std::size_t integerStart = i;
+    while (i < s.size() and isDigit(s[i])) { ++i; }
+    if (i == integerStart or i >= s.size() or s[i] != '.') { return 0; }
+    std::size_t fractionStart = ++i;
+    while (i < s.size() and isDigit(s[i])) { ++i; }
+    return i == fractionStart ? 0 : i;
+}
+
+std::size_t symbolLength(std::string_view s) {
+    if (s.empty() or not isSymbolStart(s[0])) { return 0; }
+    std::size_t i = 1;
+    while (i < s.size() and isSymbolChar(s[i])) { ++i; }
+    return i;
+}
+
+// The value of a numeral or decimal without '/', read in chunks of digits that fit a word
+Number parseNumber(std::string_view text) {
+    bool negative = text[0] == '-';
+    Number value = 0;
+    Number denominator = 1;
+    bool fraction = false;
+    uint32_t chunk = 0;
+    uint32_t chunkScale = 1;
+    uint32_t fractionScale = 1;
+    auto flush = [&]() {
+        value = value * Number(chunkScale) + Number(chunk);
+        denominator *= Number(fractionScale);
+        chunk = 0;
+        chunkScale = fractionScale = 1;
+    };
+    for (char c : text.substr(negative ? 1 : 0)) {
+        if (c == '.') {
+            fraction = true;
+            continue;
+        }
+        chunk = chunk * 10 + static_cast<uint32_t>(c - '0');
+        chunkScale *= 10;
+        if (fraction) { fractionScale *= 10; }
+        if (chunkScale == 1000000000) { flush(); }
+    }
+    flush();
+    if (fraction) { value /= denominator; }
+    return negative ? -value : value;
+}
+
+std::unordered_map<std::string_view, std::pair<int, smt2token>> const reservedWords = {
+    {"as", {TK_AS, {t_as}}},
+    {"DECIMAL", {TK_DECIMAL, {t_DECIMAL}}},
+    {"exists", {TK_EXISTS, {t_exists}}},
+    {"forall", {TK_FORALL, {t_forall}}},
+    {"let", {TK_LET, {t_let}}},
+    {"NUMERAL", {TK_NUMERAL, {t_NUMERAL}}},
+    {"par", {TK_PAR, {t_par}}},
+    {"STRING", {TK_STRING, {t_STRING}}},
+    {"assert", {TK_ASSERT, {t_assert}}},
+    {"check-sat", {TK_CHECKSAT, {t_checksat}}},
+    {"declare-sort", {TK_DECLARESORT, {t_declaresort}}},
+    {"declare-fun", {TK_DECLAREFUN, {t_declarefun}}},
+    {"declare-const", {TK_DECLARECONST, {t_declareconst}}},
+    {"define-sort", {TK_DEFINESORT, {t_definesort}}},
+    {"define-fun", {TK_DEFINEFUN, {t_definefun}}},
+    {"exit", {TK_EXIT, {t_exit}}},
+    {"get-assertions", {TK_GETASSERTIONS, {t_getassertions}}},
+    {"get-assignment", {TK_GETASSIGNMENT, {t_getassignment}}},
+    {"get-info", {TK_GETINFO, {t_getinfo}}},
+    {"get-option", {TK_GETOPTION, {t_getoption}}},
+    {"get-proof", {TK_GETPROOF, {t_getproof}}},
+    {"get-unsat-core", {TK_GETUNSATCORE, {t_getunsatcore}}},
+    {"get-value", {TK_GETVALUE, {t_getvalue}}},
+    {"get-model", {TK_GETMODEL, {t_getmodel}}},
+    {"pop", {TK_POP, {t_pop}}},
+    {"push", {TK_PUSH, {t_push}}},
+    {"set-logic", {TK_SETLOGIC, {t_setlogic}}},
+    {"set-info", {TK_SETINFO, {t_setinfo}}},
+    {"set-option", {TK_SETOPTION, {t_setoption}}},
+    {"get-interpolants", {TK_GETITPS, {t_getinterpolants}}},
+    {"theory", {TK_THEORY, {t_theory}}},
+    {"simplify", {TK_SIMPLIFY, {t_simplify}}},
+    {"echo", {TK_ECHO, {t_echo}}},
+};
+
+std::unordered_map<std::string_view, int> const predefinedKeywords = {
+    {":sorts", KW_SORTS},
+    {":funs", KW_FUNS},
+    {":sorts-description", KW_SORTSDESCRIPTION},
+    {":funs-description", KW_FUNSDESCRIPTION},
+    {":definition", KW_DEFINITION},
+    {":values", KW_VALUES},
+    {":notes", KW_NOTES},
+    {":theories", KW_THEORIES},
+    {":extensions", KW_EXTENSIONS},
+    {":print-success", KW_PRINTSUCCESS},
+    {":expand-definitions", KW_EXPANDDEFINITIONS},
+    {":interactive-mode", KW_INTERACTIVEMODE},
+    {":produce-proofs", KW_PRODUCEPROOFS},
+    {":produce-unsat-cores", KW_PRODUCEUNSATCORES},
+    {":minimal-unsat-cores", KW_MINIMALUNSATCORES},
+    {":print-cores-full", KW_PRINTCORESFULL},
+    {":produce-models", KW_PRODUCEMODELS},
+    {":produce-assignments", KW_PRODUCEASSIGNMENTS},
+    {":regular-output-channel", KW_REGULAROUTPUTCHANNEL},
+    {":diagnostic-output-channel", KW_DIAGNOSTICOUTPUTCHANNEL},
+    {":random-seed", KW_RANDOMSEED},
+    {":verbosity", KW_VERBOSITY},
+    {":error-behavior", KW_ERRORBEHAVIOR},
+    {":name", KW_NAME},
+    {":named", KW_NAMED},
+    {":authors", KW_AUTHORS},
+    {":version", KW_VERSION},
+    {":status", KW_STATUS},
+    {":reason-unknown", KW_REASONUNKNOWN},
+    {":all-statistics", KW_ALLSTATISTICS},
+};
+} // namespace
+
+std::string_view Smt2MappedLexer::take(std::size_t length) {
+    std::string_view token = input.substr(pos, length);
+    pos += length;
+    return token;
+}
+
+Smt2MappedLexer::Token Smt2MappedLexer::invalid(std::string message) {
+    error = std::move(message);
+    return {invalidToken, {}, line};
+}
+
+char * Smt2MappedLexer::intern(std::string_view text) {
+    auto it = interned.find(text);
+    if (it == interned.end()) {
+        auto copy = std::make_unique<char[]>(text.size() + 1);
+        std::memcpy(copy.get(), text.data(), text.size());
+        copy[text.size()] = '\0';
+        std::string_view key(copy.get(), text.size());
+        it = interned.emplace(key, std::move(copy)).first;
+    }
+    return it->second.get();
+}
+
+Number const * Smt2MappedLexer::numberOf(char const * internedText) const {
+    auto it = numbers.find(internedText);
+    return it == numbers.end() ? nullptr : &it->second;
+}
+
+Smt2MappedLexer::Token Smt2MappedLexer::next() {
+    // Whitespace and comments
+    while (pos < input.size()) {
+        char c = input[pos];
+        if (c == ';') {
+            while (pos < input.size() and input[pos] != '\n') { ++pos; }
+        } else if (c == ' ' or c == '\t' or c == '\n') {
+            line += (c == '\n');
+            ++pos;
+        } else {
+            break;
+        }
+    }
+    if (pos == input.size()) { return {0, {}, line}; }
+
+    std::string_view rest = input.substr(pos);
+    char c = rest[0];
+    switch (c) {
+        case '(':
+        case ')':
+            return {c, take(1), line};
+        case '"':
+            ++pos;
+            return lexString();
+        case '|':
+            ++pos;
+            return lexQuotedSymbol();
+        case '#': {
+            std::size_t i = 2;
+            if (rest.size() > 1 and rest[1] == 'x') {
+                while (i < rest.size() and std::isxdigit(static_cast<unsigned char>(rest[i]))) { ++i; }
+            } else if (rest.size() > 1 and rest[1] == 'b') {
+                while (i < rest.size() and (rest[i] == '0' or rest[i] == '1')) { ++i; }
+            }
+            if (i == 2) {
+                ++pos;
+                return invalid("invalid token near #");
+            }
+            bool hex = rest[1] == 'x';
+            return {hex ? TK_HEX : TK_BIN, take(i), line};
+        }
+        case ':': {
+            std::size_t i = 1;
+            while (i < rest.size() and isKeywordChar(rest[i])) { ++i; }
+            if (i == 1) {
+                ++pos;
+                return invalid("invalid token near :");
+            }
+            std::string_view keyword = take(i);
+            auto it = predefinedKeywords.find(keyword);
+            return {it == predefinedKeywords.end() ? TK_KEY : it->second, keyword, line};
+        }
+        default:
+            break;
+    }
+
+    // Longest match; on a tie, numerals win over decimals and decimals over symbols as in the flex rules
+    std::size_t numeral = numeralLength(rest);
+    std::size_t decimal = decimalLength(rest);
+    std::size_t symbol = symbolLength(rest);
+    if (numeral > 0 and numeral >= decimal and numeral >= symbol) {
+        return {TK_NUM, take(numeral), line};
+    }
+    if (decimal > 0 and decimal >= symbol) {
+        return {TK_DEC, take(decimal), line};
+    }
+    if (symbol == 0) {
+        ++pos;
+        return invalid(std::string("invalid token near ") + c);
+    }
+    std::string_view token = take(symbol);
+    if (token == "!" or token == "_") { return {token[0], token, line}; }
+    if (auto it = reservedWords.find(token); it != reservedWords.end()) {
+        return {it->second.first, token, line};
+    }
+    return {TK_SYM, token, line};
+}
+
+int Smt2MappedLexer::lex(YYSTYPE * lvalp, YYLTYPE * llocp) {
+    Token token = next();
+    llocp->first_line = token.line;
+    switch (token.kind) {
+        case 0:
+        case invalidToken:
+        case '(':
+        case ')':
+        case '!':
+        case '_':
+            return token.kind;
+        case TK_STR:
+            if (token.text.find('\\') != std::string_view::npos) {
+                std::string unescaped;
+                for (std::size_t i = 0; i < token.text.size(); ++i) {
+                    if (token.text[i] == '\\' and i + 1 < token.text.size() and (token.text[i + 1] == '"' or token.text[i + 1] == '\\')) {
+                        ++i;
+                    } else if (token.text[i] == '\\') {
+                        putchar('\\'); // The flex scanner echoes characters no rule matches
+                        continue;
+                    }
+                    unescaped.push_back(token.text[i]);
+                }
+                lvalp->str = intern(unescaped);
+                return TK_STR;
+            }
+            break;
+        case TK_NUM:
+        case TK_DEC:
+            lvalp->str = intern(token.text);
+            if (token.text.find('/') == std::string_view::npos) {
+                numbers.try_emplace(lvalp->str, parseNumber(token.text));
+            }
+            return token.kind;
+        default:
+            if (auto it = reservedWords.find(token.text); it != reservedWords.end() and it->second.first == token.kind) {
+                lvalp->tok = it->second.second;
+                return token.kind;
+            }
+            break;
+    }
+    lvalp->str = intern(token.text);
+    return token.kind;
+}
+
+Smt2MappedLexer::Token Smt2MappedLexer::lexString() {
+    int startLine = line;
+    std::size_t start = pos;
+    while (pos < input.size() and input[pos] != '"') {
+        if (input[pos] == '\\' and pos + 1 < input.size() and (input[pos + 1] == '"' or input[pos + 1] == '\\')) {
+            ++pos;
+        }
+        line += (input[pos] == '\n');
+        ++pos;
+    }
+    if (pos == input.size()) { return invalid("unterminated string"); }
+    std::string_view text = input.substr(start, pos - start);
+    ++pos;
+    return {TK_STR, text, startLine};
+}
+
+Smt2MappedLexer::Token Smt2MappedLexer::lexQuotedSymbol() {
+    int startLine = line;
+    std::size_t start = pos;
+    while (pos < input.size() and input[pos] != '|') {
+        if (input[pos] == '\\') {
+            ++pos;
+            return invalid("\\ not allowed inside | ... |");
+        }
+        line += (input[pos] == '\n');
+        ++pos;
+    }
+    if (pos == input.size()) { return invalid("unterminated quoted symbol"); }
+    std::string_view text = input.substr(start, pos - start);
+    ++pos;
+    return {TK_QSYM, text, startLine};
+}
+
+} // namespace opensmt
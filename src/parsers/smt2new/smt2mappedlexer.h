@@ -0,0 +1,83 @@
+#ifndef OPENSMT_SMT2MAPPEDLEXER_H
+#define OPENSMT_SMT2MAPPEDLEXER_H
+
+#include <common/Number.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+union YYSTYPE;
+struct YYLTYPE;
+
+namespace opensmt {
+
+/**
+ * Read-only memory mapping of a whole file.
+ */
+class MappedFile {
+public:
+    explicit MappedFile(int fd);
+    ~MappedFile();
+    MappedFile(MappedFile const &) = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+
+    bool isMapped() const { return mapped; }
+    std::string_view contents() const { return {static_cast<char const *>(data), size}; }
+
+private:
+    void * data = nullptr;
+    std::size_t size = 0;
+    bool mapped = false;
+};
+
+/**
+ * Scanner for SMT-LIB2 that works directly over an input held in memory, e.g., a mapped file.
+ *
+ * It produces the same tokens as the flex scanner in smt2newlexer.ll, but reads no input through a FILE and keeps no
+ * buffer of its own. Tokens are views into the input. The parser gets the text of a token interned: every distinct text
+ * is copied once and the copy lives as long as the lexer, so the AST refers to it instead of owning a copy. Numerals and
+ * decimals are also parsed in place, the parser gets their values with numberOf.
+ */
+class Smt2MappedLexer {
+public:
+    explicit Smt2MappedLexer(std::string_view input) : input(input) {}
+
+    // The kind of a token that no rule matches, the parser knows no such token
+    static constexpr int invalidToken = 1;
+
+    struct Token {
+        int kind;              // A token of the parser, 0 at the end of the input, or invalidToken
+        std::string_view text; // For strings, the contents without the quotes and with the escapes unresolved
+        int line;
+    };
+
+    Token next();
+    int lex(YYSTYPE * lvalp, YYLTYPE * llocp);
+
+    // The reason of the last invalid token
+    std::string const & getError() const { return error; }
+    // The value of a numeral or decimal interned by lex; nullptr for other texts
+    Number const * numberOf(char const * internedText) const;
+
+private:
+    std::string_view input;
+    std::size_t pos = 0;
+    int line = 1;
+    std::string error;
+
+    // Keys view the interned copies
+    std::unordered_map<std::string_view, std::unique_ptr<char[]>> interned;
+    std::unordered_map<char const *, Number> numbers;
+
+    std::string_view take(std::size_t length);
+    Token lexString();
+    Token lexQuotedSymbol();
+    Token invalid(std::string message);
+    char * intern(std::string_view text);
+};
+} // namespace opensmt
+
+#endif // OPENSMT_SMT2MAPPEDLEXER_H
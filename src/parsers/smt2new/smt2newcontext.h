@@ -29,10 +29,13 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <options/SMTConfig.h>
 
+#include <functional>
 #include <iostream>
 
 namespace opensmt {
 
+class Smt2MappedLexer;
+
 class Smt2newContext {
   private:
     int                         init_scanner();
@@ -41,8 +44,10 @@ class Smt2newContext {
     int                         buffer_sz;
     int                         buffer_cap;
     ASTNode*                    root;
+    std::function<bool(ASTNode&)> commandHandler;
   public:
-    void*                       scanner;
+    void*                       scanner = nullptr;
+    Smt2MappedLexer*            mappedLexer = nullptr; // Used instead of the flex scanner if set
     int                         result;
     FILE*                       is;
     char*                       ib;
@@ -75,8 +80,21 @@ class Smt2newContext {
         buffer = (char*) malloc(buffer_cap);
     }
 
+    explicit Smt2newContext(Smt2MappedLexer& lexer, bool interactive = false) :
+       buffer_sz(0)
+     , buffer_cap(1)
+     , root(NULL)
+     , mappedLexer(&lexer)
+     , result(0)
+     , is(NULL)
+     , ib(NULL)
+     , interactive(interactive)
+    {
+        buffer = (char*) malloc(buffer_cap);
+    }
+
     ~Smt2newContext() {
-        destroy_scanner();
+        if (not mappedLexer) { destroy_scanner(); }
         delete root;
         free(buffer);
     }
@@ -102,6 +120,20 @@ class Smt2newContext {
         root = n;
     }
 
+    // In streaming mode every command is passed to the handler as soon as it is parsed and freed right after,
+    // instead of being collected under the root.  Parsing stops when the handler returns false.
+    void setCommandHandler(std::function<bool(ASTNode&)> handler) {
+        commandHandler = std::move(handler);
+    }
+
+    bool isStreaming() const { return static_cast<bool>(commandHandler); }
+
+    bool processCommand(ASTNode* n) {
+        bool proceed = commandHandler(*n);
+        delete n;
+        return proceed;
+    }
+
     void prettyPrint(std::ostream& o) {
         o << "Starting print" << std::endl;
         root->print(o, 0);
@@ -37,8 +37,10 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 %{
 
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
+#include <unistd.h>
 #include <vector>
 #include <list>
 
@@ -54,6 +56,15 @@ using namespace opensmt::tokens;
 
 
 #define YY_EXTRA_TYPE Smt2newContext*
+// Take whatever input is available instead of waiting for a full buffer, so that in streaming mode a command is
+// executed before the input following it arrives
+#define YY_INPUT(buf, result, max_size) \
+    { \
+        ssize_t n; \
+        while ((n = read(fileno(yyin), buf, max_size)) < 0 and errno == EINTR) { errno = 0; } \
+        if (n < 0) { YY_FATAL_ERROR("input in flex scanner failed"); } \
+        result = n; \
+    }
 #define YY_USER_ACTION yyget_lloc(yyscanner)->first_line = yyget_lineno(yyscanner);
 %}
 
@@ -50,9 +50,37 @@ using namespace opensmt;
 
 #include "smt2newparser.hh"
 
+#include <parsers/smt2new/smt2mappedlexer.h>
 
 int osmt_yylex(YYSTYPE* lvalp, YYLTYPE* llocp, void* scanner);
 
+void osmt_yyerror( YYLTYPE* locp, Smt2newContext* context, const char * s );
+
+static int osmt_yylex_dispatch(YYSTYPE* lvalp, YYLTYPE* llocp, Smt2newContext* context)
+{
+  if (context->mappedLexer) {
+    int token = context->mappedLexer->lex(lvalp, llocp);
+    if (token == Smt2MappedLexer::invalidToken)
+      osmt_yyerror(llocp, context, context->mappedLexer->getError().c_str());
+    return token;
+  }
+  return osmt_yylex(lvalp, llocp, context->scanner);
+}
+
+// A node for a token text; the texts of the mapped scanner are interned and stay owned by it
+static ASTNode* mkLeaf(Smt2newContext* context, ASTType type, char* value)
+{
+  if (not context->mappedLexer)
+    return new ASTNode(type, value);
+  ASTNode* node = new ASTNode(type, value, ASTNode::Borrowed{});
+  if (type == NUM_T or type == DEC_T)
+    node->setNumber(context->mappedLexer->numberOf(value));
+  return node;
+}
+
+#undef yylex
+#define yylex(lvalp, llocp, scanner) osmt_yylex_dispatch(lvalp, llocp, context)
+
 void osmt_yyerror( YYLTYPE* locp, Smt2newContext* context, const char * s )
 {
   if (context->interactive)
@@ -64,8 +92,8 @@ void osmt_yyerror( YYLTYPE* locp, Smt2newContext* context, const char * s )
 
 #define scanner context->scanner
 
-/* Overallocation to prevent stack overflow */
-#define YYMAXDEPTH 1024 * 1024
+/* Overallocation to prevent stack overflow; a let nests about six stack entries deep */
+#define YYMAXDEPTH 16 * 1024 * 1024
 %}
 
 %union
@@ -76,7 +104,7 @@ void osmt_yyerror( YYLTYPE* locp, Smt2newContext* context, const char * s )
   tokens::smt2token            tok;
 }
 
-%destructor { free($$); } <str>
+%destructor { if (not context->mappedLexer) { free($$); } } <str>
 %destructor { delete $$; } <snode>
 %destructor { if ($$) { for (auto node : *$$) { delete node; } delete $$; }} <snode_list>
 
@@ -102,15 +130,25 @@ void osmt_yyerror( YYLTYPE* locp, Smt2newContext* context, const char * s )
 script: command_list { ASTNode *n = new ASTNode(CMDL_T, strdup("main-script")); n->children = $1; context->insertRoot(n); };
 
 symbol: TK_SYM
-        { $$ = new ASTNode(SYM_T, $1); }
+        { $$ = mkLeaf(context, SYM_T, $1); }
     | TK_QSYM
-        { $$ = new ASTNode(QSYM_T, $1); }
+        { $$ = mkLeaf(context, QSYM_T, $1); }
     ;
 
 command_list:
         { $$ = new std::vector<ASTNode*>(); }
     | command_list command
-        { (*$1).push_back($2); $$ = $1; }
+        {
+            if (context->isStreaming()) {
+                if (not context->processCommand($2)) {
+                    delete $1;
+                    YYACCEPT;
+                }
+            } else {
+                (*$1).push_back($2);
+            }
+            $$ = $1;
+        }
     ;
 
 command: '(' TK_SETLOGIC symbol ')'
@@ -136,7 +174,7 @@ command: '(' TK_SETLOGIC symbol ')'
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($3);
-            $$->children->push_back(new ASTNode(NUM_T, $4));
+            $$->children->push_back(mkLeaf(context, NUM_T, $4));
         }
     | '(' TK_DEFINESORT symbol '(' symbol_list ')' sort ')'
         {
@@ -192,13 +230,13 @@ command: '(' TK_SETLOGIC symbol ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(NUM_T, $3));
+            $$->children->push_back(mkLeaf(context, NUM_T, $3));
         }
     | '(' TK_POP TK_NUM ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(NUM_T, $3));
+            $$->children->push_back(mkLeaf(context, NUM_T, $3));
         }
     | '(' TK_ASSERT term ')'
         {
@@ -227,19 +265,19 @@ command: '(' TK_SETLOGIC symbol ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(UATTR_T, $3));
+            $$->children->push_back(mkLeaf(context, UATTR_T, $3));
         }
     | '(' TK_RDSTATE TK_STR ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(UATTR_T, $3));
+            $$->children->push_back(mkLeaf(context, UATTR_T, $3));
         }
     | '(' TK_WRFUNS TK_STR ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(UATTR_T, $3));
+            $$->children->push_back(mkLeaf(context, UATTR_T, $3));
         }
     | '(' TK_GETUNSATCORE ')'
         {
@@ -263,13 +301,13 @@ command: '(' TK_SETLOGIC symbol ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(UATTR_T, $3));
+            $$->children->push_back(mkLeaf(context, UATTR_T, $3));
         }
     | '(' TK_GETOPTION predef_key ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(PATTR_T, $3));
+            $$->children->push_back(mkLeaf(context, PATTR_T, $3));
         }
     | '(' TK_GETINFO info_flag ')'
         {
@@ -287,7 +325,7 @@ command: '(' TK_SETLOGIC symbol ')'
         {
             $$ = new ASTNode(CMD_T, $2);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(UATTR_T, $3));
+            $$->children->push_back(mkLeaf(context, UATTR_T, $3));
         }
     ;
 
@@ -298,13 +336,13 @@ attribute_list:
     ;
 
 attribute: TK_KEY
-        { $$ = new ASTNode(UATTR_T, $1); }
+        { $$ = mkLeaf(context, UATTR_T, $1); }
     | TK_KEY attribute_value
-        { $$ = new ASTNode(UATTR_T, $1); $$->children = new std::vector<ASTNode*>(); $$->children->push_back($2); }
+        { $$ = mkLeaf(context, UATTR_T, $1); $$->children = new std::vector<ASTNode*>(); $$->children->push_back($2); }
     | predef_key
-        { $$ = new ASTNode(PATTR_T, $1); }
+        { $$ = mkLeaf(context, PATTR_T, $1); }
     | predef_key attribute_value
-        { $$ = new ASTNode(PATTR_T, $1); $$->children = new std::vector<ASTNode*>(); $$->children->push_back($2); }
+        { $$ = mkLeaf(context, PATTR_T, $1); $$->children = new std::vector<ASTNode*>(); $$->children->push_back($2); }
     ;
 
 attribute_value: spec_const
@@ -355,7 +393,7 @@ s_expr: spec_const
         }
     | TK_KEY
         {
-            $$ = new ASTNode(UATTR_T, $1);
+            $$ = mkLeaf(context, UATTR_T, $1);
         }
     | '(' s_expr_list ')'
         {
@@ -377,15 +415,15 @@ s_expr_list:
 
 
 spec_const: TK_NUM
-        { $$ = new ASTNode(NUM_T, $1); }
+        { $$ = mkLeaf(context, NUM_T, $1); }
     | TK_DEC
-        { $$ = new ASTNode(DEC_T, $1); }
+        { $$ = mkLeaf(context, DEC_T, $1); }
     | TK_HEX
-        { $$ = new ASTNode(HEX_T, $1); }
+        { $$ = mkLeaf(context, HEX_T, $1); }
     | TK_BIN
-        { $$ = new ASTNode(BIN_T, $1); }
+        { $$ = mkLeaf(context, BIN_T, $1); }
     | TK_STR
-        { $$ = new ASTNode(STR_T, $1); }
+        { $$ = mkLeaf(context, STR_T, $1); }
     ;
 
 const_val: symbol
@@ -395,9 +433,9 @@ const_val: symbol
     ;
 
 numeral_list: numeral_list TK_NUM
-        { $1->push_back(new ASTNode(NUM_T, $2)); $$ = $1; }
+        { $1->push_back(mkLeaf(context, NUM_T, $2)); $$ = $1; }
     | TK_NUM
-        { $$ = new std::vector<ASTNode*>(); $$->push_back(new ASTNode(NUM_T, $1)); }
+        { $$ = new std::vector<ASTNode*>(); $$->push_back(mkLeaf(context, NUM_T, $1)); }
     ;
 
 qual_identifier: identifier
@@ -511,81 +549,81 @@ b_value: symbol
 
 option: KW_PRINTSUCCESS b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_EXPANDDEFINITIONS b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_INTERACTIVEMODE b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_PRODUCEPROOFS b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_PRODUCEUNSATCORES b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_MINIMALUNSATCORES b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_PRINTCORESFULL b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_PRODUCEMODELS b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_PRODUCEASSIGNMENTS b_value
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
             $$->children->push_back($2);
         }
     | KW_REGULAROUTPUTCHANNEL TK_STR
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(STR_T, $2));
+            $$->children->push_back(mkLeaf(context, STR_T, $2));
         }
     | KW_DIAGNOSTICOUTPUTCHANNEL TK_STR
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(STR_T, $2));
+            $$->children->push_back(mkLeaf(context, STR_T, $2));
         }
     | KW_RANDOMSEED TK_NUM
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(NUM_T, $2));
+            $$->children->push_back(mkLeaf(context, NUM_T, $2));
         }
     | KW_VERBOSITY TK_NUM
         {
-            $$ = new ASTNode(OPTION_T, $1);
+            $$ = mkLeaf(context, OPTION_T, $1);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(NUM_T, $2));
+            $$->children->push_back(mkLeaf(context, NUM_T, $2));
         }
     | attribute
         {
@@ -658,24 +696,24 @@ predef_key: KW_SORTS
     ;
 
 info_flag: KW_ERRORBEHAVIOR
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | KW_NAME
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | KW_AUTHORS
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | KW_VERSION
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | KW_STATUS
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | KW_REASONUNKNOWN
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | KW_ALLSTATISTICS
-        { $$ = new ASTNode(INFO_T, $1); }
+        { $$ = mkLeaf(context, INFO_T, $1); }
     | TK_KEY
         {
             $$ = new ASTNode(INFO_T, NULL);
             $$->children = new std::vector<ASTNode*>();
-            $$->children->push_back(new ASTNode(GATTR_T, $1));
+            $$->children->push_back(mkLeaf(context, GATTR_T, $1));
         }
     ;
 
@@ -26,7 +26,7 @@ public:
         return c == -1 ? icolor_t::I_A : (c == -2 ? icolor_t::I_B : icolor_t::I_AB);
     }
 
-    SingleInterpolationComputationContext(SMTConfig const & config, Theory & theory, TermMapper & termMapper,
+    SingleInterpolationComputationContext(SMTConfig const & config, Theory & theory, THandler & thandler,
                                           PartitionManager & pmanager, ProofGraph const & proof,
                                           ipartitions_t const & A_mask);
 
@@ -69,14 +69,10 @@ public:
         data.clearSharedVar(getSharedVarIndex(n.getPivot()));
     }
 
-    void initTSolver();
-    void backtrackTSolver();
-    bool assertLiteralsToTSolver(vec<Lit> const &);
-
     ipartitions_t const & getVarPartition(Var v) const { return pmanager.getIPartitions(varToPTRef(v)); }
-    inline Lit PTRefToLit(PTRef ref) const { return thandler->getTMap().getLit(ref); }
-    inline Var PTRefToVar(PTRef ref) const { return thandler->getTMap().getVar(ref); }
-    inline PTRef varToPTRef(Var v) const { return thandler->getTMap().varToPTRef(v); }
+    inline Lit PTRefToLit(PTRef ref) const { return thandler.getTMap().getLit(ref); }
+    inline Var PTRefToVar(PTRef ref) const { return thandler.getTMap().getVar(ref); }
+    inline PTRef varToPTRef(Var v) const { return thandler.getTMap().varToPTRef(v); }
 
     icolor_t getSharedVarColorInNode(Var v, ProofNode const & node) const {
         if (isColoredA(node, v))
@@ -117,6 +113,7 @@ public:
 
     PTRef computePartialInterpolantForOriginalClause(ProofNode const & n) const;
 
+    // Expects the theory solver in the conflict given by the negation of the clause
     PTRef computePartialInterpolantForTheoryClause(ProofNode const & n);
 
     PTRef computePartialInterpolantForSplitClause(ProofNode const & n) const;
@@ -127,7 +124,12 @@ public:
 
     icolor_t getVarColor(ProofNode const & n, Var v) const;
 
-    PTRef produceSingleInterpolant();
+    // The nodes must be visited in a topological order, leaves first
+    void prepare();
+    // A theory lemma with the same clause as sameLemma gets its partial interpolant, instead of asking the theory again
+    void interpolateLeaf(ProofNode &, ProofNode const * sameLemma = nullptr);
+    void interpolateInner(ProofNode &);
+    PTRef getRootInterpolant();
 
     void checkInterAlgo() const;
 
@@ -225,8 +227,9 @@ private:
     SMTConfig const & config;
     PartitionManager & pmanager;
     ProofGraph const & proofGraph;
-    std::unique_ptr<THandler> thandler;
+    THandler & thandler;
     ipartitions_t const & A_mask;
+    std::unique_ptr<std::map<Var, icolor_t>> PSFunction;
 };
 
 /**************** HELPER METHODS ************************/
@@ -387,32 +390,6 @@ void SingleInterpolationComputationContext::checkInterAlgo() const {
     }
 }
 
-void SingleInterpolationComputationContext::backtrackTSolver() {
-    thandler->backtrack(-1);
-}
-
-bool SingleInterpolationComputationContext::assertLiteralsToTSolver(vec<Lit> const & vec) {
-    return thandler->assertLits(vec);
-}
-
-void SingleInterpolationComputationContext::initTSolver() {
-    auto const & leaves_ids = proofGraph.getLeaves();
-    assert(not leaves_ids.empty());
-    for (auto id : leaves_ids) {
-        ProofNode * node = proofGraph.getNode(id);
-        assert(node);
-        assert(isLeafClauseType(node->getType()));
-        if (node->getType() != clause_type::CLA_THEORY) { continue; }
-        auto const & clause = proofGraph.getNode(id)->getClause();
-        for (auto const & lit : clause) {
-            Var v = var(lit);
-            PTRef atom = this->varToPTRef(v);
-            assert(logic.isTheoryTerm(atom));
-            thandler->declareAtom(atom);
-        }
-    }
-}
-
 bool SingleInterpolationComputationContext::verifyPartialInterpolant(ProofNode const & n) {
     if (verbose()) std::cout << "; Verifying partial interpolant" << '\n';
     bool res = verifyPartialInterpolantA(n);
@@ -431,7 +408,7 @@ bool SingleInterpolationComputationContext::verifyPartialInterpolant(ProofNode c
 
 bool SingleInterpolationComputationContext::verifyPartialInterpolantA(ProofNode const & n) {
     // Check A /\ ~(C|a,ab) -> I, i.e., A /\ ~(C|a,ab) /\ ~I unsat
-    std::vector<Lit> const & cl = n.getClause();
+    auto cl = n.getClause();
     vec<PTRef> restricted_clause;
 
     for (Lit l : cl) {
@@ -457,7 +434,7 @@ bool SingleInterpolationComputationContext::verifyPartialInterpolantA(ProofNode
 
 bool SingleInterpolationComputationContext::verifyPartialInterpolantB(ProofNode const & n) {
     // Check B /\ ~(C|b,ab) -> ~I, i.e., B /\ ~(C|b,ab) /\ I unsat
-    std::vector<Lit> const & cl = n.getClause();
+    auto cl = n.getClause();
     vec<PTRef> restricted_clause;
 
     for (Lit l : cl) {
@@ -482,7 +459,7 @@ bool SingleInterpolationComputationContext::verifyPartialInterpolantB(ProofNode
 }
 
 SingleInterpolationComputationContext::SingleInterpolationComputationContext(SMTConfig const & config, Theory & theory,
-                                                                             TermMapper & termMapper,
+                                                                             THandler & thandler,
                                                                              PartitionManager & pmanager,
                                                                              ProofGraph const & proof,
                                                                              ipartitions_t const & A_mask)
@@ -490,7 +467,7 @@ SingleInterpolationComputationContext::SingleInterpolationComputationContext(SMT
       config(config),
       pmanager(pmanager),
       proofGraph(proof),
-      thandler(new THandler(theory, termMapper)),
+      thandler(thandler),
       A_mask(A_mask) {
     auto const & vars = proof.getVariables();
     std::size_t varCounts = (*std::max_element(vars.begin(), vars.end())) + 1;
@@ -511,73 +488,56 @@ SingleInterpolationComputationContext::SingleInterpolationComputationContext(SMT
         } else
             throw InternalException("Error in computing variable colors");
     }
-    initTSolver();
 }
 
 /**************** MAIN INTERPOLANTS GENERATION METHODS ************************/
 
-PTRef SingleInterpolationComputationContext::produceSingleInterpolant() {
-    // Check
-    checkInterAlgo();
-
-    // Clause and partial interpolant
-    ProofNode * n = nullptr;
-    PTRef partial_interp = PTRef_Undef;
-
-    // Vector for topological ordering
-    std::vector<clauseid_t> DFSv = proofGraph.topolSortingTopDown();
-    size_t proof_size = DFSv.size();
-
-    if (verbose() > 0) std::cerr << "; Generating interpolant " << std::endl;
-
-    auto PSFunction = needProofStatistics() ? computePSFunction() : nullptr;
+void SingleInterpolationComputationContext::prepare() {
+    PSFunction = needProofStatistics() ? computePSFunction() : nullptr;
+}
 
-    // Traverse proof and compute current interpolant
-    for (size_t i = 0; i < proof_size; i++) {
-        n = proofGraph.getNode(DFSv[i]);
-        assert(n);
+void SingleInterpolationComputationContext::interpolateLeaf(ProofNode & n, ProofNode const * sameLemma) {
+    if (!isLeafClauseType(n.getType())) throw InternalException("; Leaf node with non-leaf clause type");
 
-        // Generate partial interpolant for clause i
-        if (n->isLeaf()) {
-            if (!isLeafClauseType(n->getType())) throw InternalException("; Leaf node with non-leaf clause type");
+    labelLeaf(n, PSFunction.get());
 
-            labelLeaf(*n, PSFunction.get());
+    PTRef partial_interp = PTRef_Undef;
+    if (n.getType() == clause_type::CLA_ORIG) {
+        partial_interp = computePartialInterpolantForOriginalClause(n);
+    } else if (n.getType() == clause_type::CLA_THEORY) {
+        partial_interp = sameLemma ? getPartialInterpolant(*sameLemma) : computePartialInterpolantForTheoryClause(n);
+    } else if (n.getType() == clause_type::CLA_SPLIT) {
+        partial_interp = computePartialInterpolantForSplitClause(n);
+    } else {
+        assert(n.getType() == clause_type::CLA_ASSUMPTION);
+        // MB: Frame literals must be ignored when interpolating
+        // This interpolant will be ignored eventually, any value would do
+        setPartialInterpolant(n, logic.getTerm_true());
+        return;
+    }
 
-            if (n->getType() == clause_type::CLA_ORIG) {
-                partial_interp = computePartialInterpolantForOriginalClause(*n);
-            } else if (n->getType() == clause_type::CLA_THEORY) {
-                partial_interp = computePartialInterpolantForTheoryClause(*n);
-            } else if (n->getType() == clause_type::CLA_SPLIT) {
-                partial_interp = computePartialInterpolantForSplitClause(*n);
-            } else {
-                assert(n->getType() == clause_type::CLA_ASSUMPTION);
-                // MB: Frame literals must be ignored when interpolating
-                // This interpolant will be ignored eventually, any value would do
-                setPartialInterpolant(*n, logic.getTerm_true());
-                continue;
-            }
+    assert(partial_interp != PTRef_Undef);
+    setPartialInterpolant(n, partial_interp);
+    if (enabledPedInterpVerif()) { verifyPartialInterpolant(n); }
+}
 
-            assert(partial_interp != PTRef_Undef);
-            setPartialInterpolant(*n, partial_interp);
-            if (enabledPedInterpVerif()) { verifyPartialInterpolant(*n); }
-        } else { // Inner node
-            partial_interp = compInterpLabelingInner(*n);
-            assert(partial_interp != PTRef_Undef);
-            setPartialInterpolant(*n, partial_interp);
-        }
-    }
+void SingleInterpolationComputationContext::interpolateInner(ProofNode & n) {
+    PTRef partial_interp = compInterpLabelingInner(n);
+    assert(partial_interp != PTRef_Undef);
+    setPartialInterpolant(n, partial_interp);
+}
 
-    PSFunction.release();
+PTRef SingleInterpolationComputationContext::getRootInterpolant() {
+    PSFunction.reset();
 
+    // Last clause visited is the empty clause with total interpolant
     PTRef rootInterpolant = getPartialInterpolant(*proofGraph.getRoot());
     assert(rootInterpolant != PTRef_Undef);
-    // Last clause visited is the empty clause with total interpolant
-    assert(partial_interp == rootInterpolant);
 
     if (verbose()) {
         // getComplexityInterpolant(partial_interp);
         int nbool, neq, nuf, nif;
-        logic.collectStats(partial_interp, nbool, neq, nuf, nif);
+        logic.collectStats(rootInterpolant, nbool, neq, nuf, nif);
         std::cerr << "; Number of boolean connectives: " << nbool << '\n';
         std::cerr << "; Number of equalities: " << neq << '\n';
         std::cerr << "; Number of uninterpreted functions: " << nuf << '\n';
@@ -666,29 +626,11 @@ PTRef SingleInterpolationComputationContext::computePartialInterpolantForOrigina
 }
 
 PTRef SingleInterpolationComputationContext::computePartialInterpolantForTheoryClause(ProofNode const & n) {
-    backtrackTSolver();
-    vec<Lit> newvec;
-    std::vector<Lit> const & oldvec = n.getClause();
-    for (Lit l : oldvec) {
-        newvec.push(~l);
-    }
-    bool satisfiable = this->assertLiteralsToTSolver(newvec);
-    if (satisfiable) {
-        TRes tres = thandler->check(true);
-        satisfiable = (tres != TRes::UNSAT);
-    }
-    if (satisfiable) {
-        assert(false);
-        throw InternalException("Asserting negation of theory clause did not result in conflict in theory solver!");
-    }
     THandler::ItpColorMap ptref2label;
-    for (Lit l : oldvec) {
+    for (Lit l : n.getClause()) {
         ptref2label.insert({varToPTRef(var(l)), getVarColor(n, var(l))});
     }
-
-    PTRef interpolant = thandler->getInterpolant(A_mask, &ptref2label, pmanager);
-    backtrackTSolver();
-    return interpolant;
+    return thandler.getInterpolant(A_mask, &ptref2label, pmanager);
 }
 
 /*
@@ -770,7 +712,7 @@ PTRef SingleInterpolationComputationContext::compInterpLabelingInner(ProofNode &
 template<typename TFun>
 void SingleInterpolationComputationContext::setLeafLabeling(ProofNode & node, TFun colorABVar) {
     resetLabeling(node);
-    std::vector<Lit> const & cl = node.getClause();
+    auto cl = node.getClause();
 
     for (Lit l : cl) {
         Var v = var(l);
@@ -825,6 +767,133 @@ void SingleInterpolationComputationContext::setLeafMcMillanPrimeLabeling(ProofNo
     setLeafLabeling(n, [&](ProofNode & node, Var v) { colorA(node, v); });
 }
 
+/********** INTERPOLANTS FOR SEVERAL PARTITIONINGS **********/
+
+/*
+ * Computes the interpolants for several partitionings in a single traversal of the proof: every node gets its partial
+ * interpolants for all the partitionings before the traversal moves on. The partitionings share the theory solver, so
+ * the conflict of each theory lemma is established only once and then interpolated for each of them. The solver may
+ * learn the same theory lemma several times, so the partial interpolants of a lemma are computed only for its first
+ * occurrence in the proof and reused for the others.
+ */
+class MultiInterpolationComputationContext {
+public:
+    MultiInterpolationComputationContext(SMTConfig const & config, Theory & theory, TermMapper & termMapper,
+                                         PartitionManager & pmanager, ProofGraph const & proof,
+                                         std::vector<ipartitions_t> const & A_masks);
+
+    std::vector<PTRef> produceInterpolants();
+
+private:
+    void initTSolver();
+    void assertTheoryConflict(ProofNode const &);
+
+    Logic & logic;
+    ProofGraph const & proofGraph;
+    std::unique_ptr<THandler> thandler;
+    std::vector<std::unique_ptr<SingleInterpolationComputationContext>> contexts;
+    std::map<std::vector<Lit>, ProofNode const *> theoryLemmas; // The first node of each theory lemma, by sorted clause
+};
+
+MultiInterpolationComputationContext::MultiInterpolationComputationContext(SMTConfig const & config, Theory & theory,
+                                                                           TermMapper & termMapper,
+                                                                           PartitionManager & pmanager,
+                                                                           ProofGraph const & proof,
+                                                                           std::vector<ipartitions_t> const & A_masks)
+    : logic(theory.getLogic()),
+      proofGraph(proof),
+      thandler(new THandler(theory, termMapper)) {
+    initTSolver();
+    contexts.reserve(A_masks.size());
+    for (auto const & A_mask : A_masks) {
+        contexts.push_back(
+            std::make_unique<SingleInterpolationComputationContext>(config, theory, *thandler, pmanager, proof, A_mask));
+    }
+}
+
+void MultiInterpolationComputationContext::initTSolver() {
+    auto const & leaves_ids = proofGraph.getLeaves();
+    assert(not leaves_ids.empty());
+    for (auto id : leaves_ids) {
+        ProofNode * node = proofGraph.getNode(id);
+        assert(node);
+        assert(isLeafClauseType(node->getType()));
+        if (node->getType() != clause_type::CLA_THEORY) { continue; }
+        auto const & clause = proofGraph.getNode(id)->getClause();
+        for (auto const & lit : clause) {
+            PTRef atom = thandler->getTMap().varToPTRef(var(lit));
+            assert(logic.isTheoryTerm(atom));
+            thandler->declareAtom(atom);
+        }
+    }
+}
+
+void MultiInterpolationComputationContext::assertTheoryConflict(ProofNode const & n) {
+    vec<Lit> newvec;
+    for (Lit l : n.getClause()) {
+        newvec.push(~l);
+    }
+    bool satisfiable = thandler->assertLits(newvec);
+    if (satisfiable) {
+        TRes tres = thandler->check(true);
+        satisfiable = (tres != TRes::UNSAT);
+    }
+    if (satisfiable) {
+        assert(false);
+        throw InternalException("Asserting negation of theory clause did not result in conflict in theory solver!");
+    }
+}
+
+std::vector<PTRef> MultiInterpolationComputationContext::produceInterpolants() {
+    if (contexts.empty()) { return {}; }
+    contexts.front()->checkInterAlgo();
+    for (auto & context : contexts) {
+        context->prepare();
+    }
+
+    if (contexts.front()->verbose() > 0) { std::cerr << "; Generating interpolants " << std::endl; }
+
+    // Vector for topological ordering
+    std::vector<clauseid_t> DFSv = proofGraph.topolSortingTopDown();
+    for (clauseid_t id : DFSv) {
+        ProofNode * n = proofGraph.getNode(id);
+        assert(n);
+        if (not n->isLeaf()) {
+            for (auto & context : contexts) {
+                context->interpolateInner(*n);
+            }
+            continue;
+        }
+        if (n->getType() != clause_type::CLA_THEORY) {
+            for (auto & context : contexts) {
+                context->interpolateLeaf(*n);
+            }
+            continue;
+        }
+        std::vector<Lit> lemma(n->getClause().begin(), n->getClause().end());
+        std::sort(lemma.begin(), lemma.end());
+        auto [it, inserted] = theoryLemmas.emplace(std::move(lemma), n);
+        if (not inserted) {
+            for (auto & context : contexts) {
+                context->interpolateLeaf(*n, it->second);
+            }
+            continue;
+        }
+        assertTheoryConflict(*n);
+        for (auto & context : contexts) {
+            context->interpolateLeaf(*n);
+        }
+        thandler->backtrack(-1);
+    }
+
+    std::vector<PTRef> interpolants;
+    interpolants.reserve(contexts.size());
+    for (auto & context : contexts) {
+        interpolants.push_back(context->getRootInterpolant());
+    }
+    return interpolants;
+}
+
 /************************ INTERPOLATION CONTEXT ************************************************************/
 
 InterpolationContext::InterpolationContext(SMTConfig & c, Theory & th, TermMapper & termMapper,
@@ -850,24 +919,45 @@ void InterpolationContext::printProofDotty() {
     proof_graph->printProofGraph();
 }
 
-void InterpolationContext::getSingleInterpolant(vec<PTRef> & interpolants, ipartitions_t const & A_mask) {
-    assert(proof_graph);
-    PTRef itp = SingleInterpolationComputationContext(config, theory, termMapper, pmanager, *proof_graph, A_mask)
-                    .produceSingleInterpolant();
+void InterpolationContext::getInterpolants(std::vector<vec<int>> const & partitions, vec<PTRef> & interpolants) {
+    std::vector<ipartitions_t> A_masks;
+    A_masks.reserve(partitions.size());
+    for (auto const & partitionIndices : partitions) {
+        ipartitions_t A_mask = 0;
+        for (int index : partitionIndices) {
+            setbit(A_mask, static_cast<unsigned int>(index));
+        }
+        A_masks.push_back(A_mask);
+    }
+    getInterpolants(A_masks, interpolants);
+}
 
-    if (enabledInterpVerif()) {
-        bool sound = verifyInterpolant(itp, A_mask);
-        assert(sound);
-        if (verbose()) {
-            if (sound)
-                std::cout << "; Final interpolant is sound" << '\n';
-            else
-                std::cout << "; Final interpolant is NOT sound" << '\n';
+void InterpolationContext::getInterpolants(std::vector<ipartitions_t> const & A_masks, vec<PTRef> & interpolants) {
+    assert(proof_graph);
+    std::vector<PTRef> itps =
+        MultiInterpolationComputationContext(config, theory, termMapper, pmanager, *proof_graph, A_masks)
+            .produceInterpolants();
+
+    for (std::size_t i = 0; i < itps.size(); ++i) {
+        PTRef itp = itps[i];
+        if (enabledInterpVerif()) {
+            bool sound = verifyInterpolant(itp, A_masks[i]);
+            assert(sound);
+            if (verbose()) {
+                if (sound)
+                    std::cout << "; Final interpolant is sound" << '\n';
+                else
+                    std::cout << "; Final interpolant is NOT sound" << '\n';
+            }
         }
+
+        if (config.simplify_inter() > 0) { itp = simplifyInterpolant(itp); }
+        interpolants.push(itp);
     }
+}
 
-    if (config.simplify_inter() > 0) { itp = simplifyInterpolant(itp); }
-    interpolants.push(itp);
+void InterpolationContext::getSingleInterpolant(vec<PTRef> & interpolants, ipartitions_t const & A_mask) {
+    getInterpolants(std::vector<ipartitions_t>{A_mask}, interpolants);
 }
 
 void InterpolationContext::getSingleInterpolant(std::vector<PTRef> & interpolants, ipartitions_t const & A_mask) {
@@ -885,11 +975,12 @@ bool InterpolationContext::getPathInterpolants(vec<PTRef> & interpolants, std::v
                          [](auto const & next, auto const & previous) { return (previous & next) == previous; })
                .first == A_masks.end());
 
-    for (unsigned i = 0; i < A_masks.size(); ++i) {
-        getSingleInterpolant(interpolants, A_masks[i]);
-        if (i > 0 and enabledInterpVerif()) {
-            PTRef previous_itp = interpolants[interpolants.size() - 2];
-            PTRef next_itp = interpolants[interpolants.size() - 1];
+    int const first = interpolants.size();
+    getInterpolants(A_masks, interpolants);
+    if (enabledInterpVerif()) {
+        for (unsigned i = 1; i < A_masks.size(); ++i) {
+            PTRef previous_itp = interpolants[first + i - 1];
+            PTRef next_itp = interpolants[first + i];
             PTRef movedPartitions = logic.mkAnd(pmanager.getPartitions(A_masks[i] ^ A_masks[i - 1]));
             propertySatisfied &=
                 VerificationUtils(logic).impliesInternal(logic.mkAnd(previous_itp, movedPartitions), next_itp);
@@ -938,6 +1029,12 @@ PTRef InterpolationContext::simplifyInterpolant(PTRef itp) const {
     if (simplificationLevel == 4) {
         itp = rewriteMaxArityAggresive(logic, itp);
         itp = simplifyUnderAssignment_Aggressive(itp, logic);
+    } else if (simplificationLevel == 5) {
+        if (verbose() > 1) { std::cout << "Itp before sweeping: \n" << logic.printTerm(itp) << "\n\n"; }
+        itp = sweepEquivalentSubformulas(logic, itp);
+        itp = rewriteMaxArityClassic(logic, itp);
+        // The sweep may reduce the interpolant to a literal
+        if (logic.isAnd(itp) or logic.isOr(itp)) { itp = simplifyUnderAssignment(logic, itp); }
     } else {
         if (simplificationLevel > 0) {
             if (verbose() > 1) { std::cout << "Itp before rewriting max arity: \n" << logic.printTerm(itp) << "\n\n"; }
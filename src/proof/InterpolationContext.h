@@ -29,6 +29,10 @@ public:
     // Create interpolants with each A consisting of the specified partitions
     void getInterpolants(std::vector<vec<int>> const & partitions, vec<PTRef> & interpolants);
 
+    // Create interpolants for all the given A masks together, in a single traversal of the proof, e.g. sequence or tree
+    // interpolants
+    void getInterpolants(std::vector<ipartitions_t> const & A_masks, vec<PTRef> & interpolants);
+
     void getSingleInterpolant(vec<PTRef> & interpolants, ipartitions_t const & A_mask);
 
     void getSingleInterpolant(std::vector<PTRef> & interpolants, ipartitions_t const & A_mask);
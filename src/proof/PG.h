@@ -14,10 +14,14 @@
 #include <tsolvers/THandler.h>
 #include <common/InternalException.h>
 
-#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <new>
-#include <functional>
+#include <vector>
 
 namespace opensmt {
 
@@ -90,27 +94,152 @@ public:
 	friend std::ostream& operator<< (std::ostream &out, RuleContext &ra);
 };
 
-// Resolution proof graph element
+// Lists of values kept one after another in a single array and addressed by their offsets. A list that outgrows its
+// room moves to the end of the array; the room it leaves behind is reclaimed when the lists are compacted.
+template <typename T>
+class FlatLists {
+public:
+    struct List {
+        uint32_t offset = 0;
+        uint32_t size = 0;
+        uint32_t capacity = 0;
+    };
+
+    // Reads the values through the array, so a view stays valid while other lists grow and the array moves
+    class View {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T const *;
+            using reference = T const &;
+
+            Iterator(std::vector<T> const & values, uint32_t pos) : values(&values), pos(pos) {}
+            T const & operator*() const { return (*values)[pos]; }
+            Iterator & operator++() {
+                ++pos;
+                return *this;
+            }
+            bool operator==(Iterator const & other) const { return pos == other.pos; }
+            bool operator!=(Iterator const & other) const { return pos != other.pos; }
+
+        private:
+            std::vector<T> const * values;
+            uint32_t pos;
+        };
+
+        View(std::vector<T> const & values, List list) : values(values), list(list) {}
+        Iterator begin() const { return Iterator(values, list.offset); }
+        Iterator end() const { return Iterator(values, list.offset + list.size); }
+        std::size_t size() const { return list.size; }
+        bool empty() const { return list.size == 0; }
+        T const & operator[](std::size_t i) const {
+            assert(i < list.size);
+            return values[list.offset + i];
+        }
+
+    private:
+        std::vector<T> const & values;
+        List list;
+    };
+
+    View view(List list) const { return View(values, list); }
+    // The pointers are valid only until some list grows
+    T * data(List list) { return values.data() + list.offset; }
+    T const * data(List list) const { return values.data() + list.offset; }
+
+    // Sets the size of the list; new values are unspecified. Returns the values of the list.
+    T * resize(List & list, uint32_t size) {
+        reserve(list, size);
+        list.size = size;
+        return data(list);
+    }
+    void copy(List & to, List from) {
+        reserve(to, from.size);
+        std::copy(values.begin() + from.offset, values.begin() + from.offset + from.size, values.begin() + to.offset);
+        to.size = from.size;
+    }
+    // Inserts the value into a sorted list, unless it is already there
+    void insertSorted(List & list, T value) {
+        T const * first = data(list);
+        uint32_t pos = std::lower_bound(first, first + list.size, value) - first;
+        if (pos < list.size and values[list.offset + pos] == value) { return; }
+        reserve(list, list.size + 1);
+        auto it = values.begin() + list.offset;
+        std::copy_backward(it + pos, it + list.size, it + list.size + 1);
+        *(it + pos) = value;
+        ++list.size;
+    }
+    void eraseSorted(List & list, T value) {
+        T * first = data(list);
+        T * it = std::lower_bound(first, first + list.size, value);
+        if (it == first + list.size or *it != value) { return; }
+        std::copy(it + 1, first + list.size, it);
+        --list.size;
+    }
+    bool containsSorted(List list, T value) const {
+        T const * first = data(list);
+        return std::binary_search(first, first + list.size, value);
+    }
+    void release(List & list) {
+        unused += list.capacity;
+        list = List{};
+    }
+
+    std::size_t usedSize() const { return values.size() - unused; }
+    std::size_t unusedSize() const { return unused; }
+    // Places the lists that forEachList passes to its argument next to each other, in that order. The lists that are
+    // not passed must have been released.
+    template <typename F>
+    void compact(F && forEachList) {
+        std::vector<T> compacted;
+        compacted.reserve(usedSize());
+        forEachList([&](List & list) {
+            auto offset = static_cast<uint32_t>(compacted.size());
+            compacted.insert(compacted.end(), values.begin() + list.offset, values.begin() + list.offset + list.size);
+            list = List{offset, list.size, list.size};
+        });
+        values = std::move(compacted);
+        unused = 0;
+    }
+
+private:
+    void reserve(List & list, uint32_t capacity) {
+        if (capacity <= list.capacity) { return; }
+        if (list.offset + list.capacity == values.size()) { // The last list grows in place
+            values.resize(list.offset + capacity);
+            list.capacity = capacity;
+            return;
+        }
+        uint32_t newCapacity = std::max(capacity, 2 * list.capacity);
+        auto offset = static_cast<uint32_t>(values.size());
+        values.resize(offset + newCapacity);
+        std::copy(values.begin() + list.offset, values.begin() + list.offset + list.size, values.begin() + offset);
+        unused += list.capacity;
+        list.offset = offset;
+        list.capacity = newCapacity;
+    }
+
+    std::vector<T> values;
+    std::size_t unused = 0;
+};
+
+class ProofArena;
+
+// Resolution proof graph element; the nodes refer to each other by their ids, and their clauses and resolvents are
+// stored in the arena of the graph
 struct ProofNode
 {
-    ProofNode    ()
-    : clause     (nullptr)
-    , clause_ref (CRef_Undef)
-    , pivot      (-1)
-    , ant1       (nullptr)
-    , ant2       (nullptr)
-    , resolvents ()
-    { }
-
-    ~ProofNode ( )
-    {
-        delete clause;
-    }
+    using ClauseView = FlatLists<Lit>::View;
+    using ResolventsView = FlatLists<clauseid_t>::View;
+    static constexpr clauseid_t noNode = static_cast<clauseid_t>(-1);
 
     //
     // Auxiliary
     //
-    inline void                 resetClause() { delete clause; clause = NULL; }
+    inline void                 resetClause();
 
     void setClauseRef(CRef cref)
     {
@@ -118,63 +247,42 @@ struct ProofNode
     }
     CRef getClauseRef() const { return clause_ref; }
 
-    void                        initClause(Clause& cla)
-    {
-        assert(clause == NULL);
-        clause = new std::vector<Lit>(cla.size());
-        for(size_t k = 0; k < cla.size(); ++k) (*clause)[k] = cla[k];
-    }
-
-    void                        initClause(std::vector<Lit>& cla)
-    {
-        assert(clause == NULL);
-        clause = new std::vector<Lit>(cla.size());
-        for(size_t k = 0; k < cla.size(); ++k) (*clause)[k] = cla[k];
-    }
-
-    void                        setClause(std::vector<Lit>& cla)
-    {
-        assert(clause);
-        clause->resize(cla.size());
-        for(size_t k = 0; k < cla.size(); ++k) (*clause)[k] = cla[k];
-    }
-
-    void initClause()
-    {
-        assert(clause == NULL);
-        clause = new std::vector<Lit>;
-    }
+    // The literals are kept sorted
+    void                        initClause(Clause& cla);
+    void                        initClause(ProofNode const & other);
+    void                        setClause(std::vector<Lit> const & cla);
+    void                        initClause();
 
     //
     // Getty methods
     //
     inline clauseid_t            getId                  ( ) const { return id; }
-    inline std::vector<Lit> &         getClause              ( )       { assert(clause); return *clause; }
-    inline std::vector<Lit> const &   getClause              ( ) const { assert(clause); return *clause; }
-    inline std::vector<Lit> const *   getPClause             ( ) const { return clause; }
-    inline size_t                getClauseSize          ( ) const { return clause->size( ); }
+    inline ClauseView            getClause              ( ) const;
+    inline bool                  hasClause              ( ) const { return has_clause; }
+    inline size_t                getClauseSize          ( ) const { assert(has_clause); return clause.size; }
     inline Var                   getPivot               ( ) const { return pivot; }
-    inline ProofNode *           getAnt1                ( ) const { return ant1; }
-    inline ProofNode *           getAnt2                ( ) const { return ant2; }
+    inline ProofNode *           getAnt1                ( ) const;
+    inline ProofNode *           getAnt2                ( ) const;
     inline clause_type           getType                ( ) const { return type; }
-    unsigned                     getNumResolvents       ( ) const { return resolvents.size(); }
-    std::set<clauseid_t>&        getResolvents          ( ) { return resolvents; }
+    unsigned                     getNumResolvents       ( ) const { return resolvents.size; }
+    inline ResolventsView        getResolvents          ( ) const;
+    inline bool                  hasResolvent           ( clauseid_t id ) const;
     //
     // Setty methods
     //
     inline void                  setId                  ( clauseid_t new_id )            { id = new_id; }
     inline void                  setPivot               ( Var new_pivot )                { pivot = new_pivot; }
-    inline void                  setAnt1                ( ProofNode * a1 )               { ant1 = a1; }
-    inline void                  setAnt2                ( ProofNode * a2 )               { ant2 = a2; }
+    inline void                  setAnt1                ( ProofNode * a1 )               { ant1 = a1 ? a1->id : noNode; }
+    inline void                  setAnt2                ( ProofNode * a2 )               { ant2 = a2 ? a2->id : noNode; }
     inline void                  setType                ( clause_type new_type )         { type = new_type; }
-    void                         addRes                 ( clauseid_t id )                { resolvents.insert( id ); }
-    void                         remRes                 ( clauseid_t id )                { resolvents.erase( id ); }
+    inline void                  addRes                 ( clauseid_t id );
+    inline void                  remRes                 ( clauseid_t id );
     //
     // Test methods
     //
     inline bool isLeaf() const {
-        assert((ant1 and ant2 ) or (not ant1 and not ant2));
-        return not ant1;
+        assert((ant1 != noNode and ant2 != noNode) or (ant1 == noNode and ant2 == noNode));
+        return ant1 == noNode;
     }
     // 0 if positive, 1 if negative, -1 if not found
     short hasOccurrenceBin(Var) const;
@@ -183,16 +291,122 @@ struct ProofNode
 
 
 private:
-    clauseid_t         id;                 // id
-    std::vector<Lit>*     clause;             // Clause
-    CRef clause_ref;
-    Var                pivot;              // Non-leaf node pivot
-    ProofNode *        ant1;               // Edges to antecedents
-    ProofNode *        ant2;               // Edges to antecedents
-    std::set<clauseid_t> resolvents;       // Resolvents
-    clause_type        type;               // Node type
+    friend class ProofArena;
+    friend class ProofGraph;
+
+    ProofArena *       arena = nullptr;
+    clauseid_t         id = noNode;             // id
+    FlatLists<Lit>::List clause;                // Clause
+    FlatLists<clauseid_t>::List resolvents;     // Resolvents, sorted
+    CRef clause_ref = CRef_Undef;
+    Var                pivot = -1;              // Non-leaf node pivot
+    clauseid_t         ant1 = noNode;           // Edges to antecedents
+    clauseid_t         ant2 = noNode;           // Edges to antecedents
+    clause_type        type = clause_type::CLA_ORIG; // Node type
+    bool               has_clause = false;
+    bool               removed = false;
 };
 
+// Storage of the proof graph. The nodes live in blocks of fixed size, so that they never move; the clauses and the
+// resolvents of all the nodes are kept in two flat arrays.
+class ProofArena
+{
+public:
+    ProofArena() = default;
+    ProofArena(ProofArena const &) = delete;
+    ProofArena & operator=(ProofArena const &) = delete;
+
+    ProofNode & node(clauseid_t id) const {
+        assert(id < numNodes);
+        return blocks[id >> blockBits][id & blockMask];
+    }
+    std::size_t size() const { return numNodes; }
+
+    ProofNode & newNode() {
+        if ((numNodes & blockMask) == 0) { blocks.push_back(std::make_unique<ProofNode[]>(blockMask + 1)); }
+        auto id = static_cast<clauseid_t>(numNodes++);
+        ProofNode & n = node(id);
+        n.arena = this;
+        n.id = id;
+        return n;
+    }
+
+    void removeNode(ProofNode & n) {
+        clauses.release(n.clause);
+        resolvents.release(n.resolvents);
+        n.has_clause = false;
+        n.ant1 = ProofNode::noNode;
+        n.ant2 = ProofNode::noNode;
+        n.removed = true;
+    }
+
+    // Reclaims the room of released and moved lists once it exceeds the room in use
+    void compact() {
+        if (clauses.unusedSize() > clauses.usedSize()) {
+            clauses.compact([this](auto const & visit) {
+                for (std::size_t i = 0; i < numNodes; ++i) { visit(node(i).clause); }
+            });
+        }
+        if (resolvents.unusedSize() > resolvents.usedSize()) {
+            resolvents.compact([this](auto const & visit) {
+                for (std::size_t i = 0; i < numNodes; ++i) { visit(node(i).resolvents); }
+            });
+        }
+    }
+
+    FlatLists<Lit> clauses;
+    FlatLists<clauseid_t> resolvents;
+
+private:
+    static constexpr unsigned blockBits = 12;
+    static constexpr std::size_t blockMask = (std::size_t(1) << blockBits) - 1;
+
+    std::vector<std::unique_ptr<ProofNode[]>> blocks;
+    std::size_t numNodes = 0;
+};
+
+inline void ProofNode::resetClause() {
+    arena->clauses.release(clause);
+    has_clause = false;
+}
+
+inline void ProofNode::initClause(Clause & cla) {
+    assert(not has_clause);
+    Lit * lits = arena->clauses.resize(clause, cla.size());
+    for (unsigned k = 0; k < cla.size(); ++k) { lits[k] = cla[k]; }
+    has_clause = true;
+}
+
+inline void ProofNode::initClause(ProofNode const & other) {
+    assert(not has_clause and other.has_clause);
+    arena->clauses.copy(clause, other.clause);
+    has_clause = true;
+}
+
+inline void ProofNode::setClause(std::vector<Lit> const & cla) {
+    assert(has_clause);
+    Lit * lits = arena->clauses.resize(clause, cla.size());
+    std::copy(cla.begin(), cla.end(), lits);
+}
+
+inline void ProofNode::initClause() {
+    assert(not has_clause);
+    has_clause = true;
+}
+
+inline ProofNode::ClauseView ProofNode::getClause() const {
+    assert(has_clause);
+    return arena->clauses.view(clause);
+}
+
+inline ProofNode * ProofNode::getAnt1() const { return ant1 == noNode ? nullptr : &arena->node(ant1); }
+inline ProofNode * ProofNode::getAnt2() const { return ant2 == noNode ? nullptr : &arena->node(ant2); }
+
+inline ProofNode::ResolventsView ProofNode::getResolvents() const { return arena->resolvents.view(resolvents); }
+inline bool ProofNode::hasResolvent(clauseid_t id) const { return arena->resolvents.containsSorted(resolvents, id); }
+inline void ProofNode::addRes(clauseid_t id) { arena->resolvents.insertSorted(resolvents, id); }
+inline void ProofNode::remRes(clauseid_t id) { arena->resolvents.eraseSorted(resolvents, id); }
+
 class ProofGraph
 {
 public:
@@ -205,19 +419,9 @@ public:
 , logic_ ( logic )
 , termMapper(termMapper)
 {
-		mpz_init(visited_1);
-		mpz_init(visited_2);
 		buildProofGraph(proof);
 }
 
-	~ProofGraph()
-	{
-		mpz_clear(visited_1);
-		mpz_clear(visited_2);
-		for(size_t i=0;i<getGraphSize();i++)
-			if(getNode(i)!=NULL) removeNode(i);
-	}
-
     void printProofAsDotty                  ( std::ostream &);
     //
     // Config
@@ -263,15 +467,15 @@ public:
     //
     // Auxiliary
     //
-    inline size_t     getGraphSize              ( ) const { return graph.size( ); }
-    bool              isSetVisited1             ( clauseid_t id ) const { return mpz_tstbit(visited_1, id); }
-    bool              isSetVisited2             ( clauseid_t id ) const { return mpz_tstbit(visited_2, id); }
-    void              setVisited1               ( clauseid_t id ) const { mpz_setbit(visited_1, id); }
-    void              setVisited2               ( clauseid_t id ) const { mpz_setbit(visited_2, id); }
-    void              resetVisited1             ( ) const               { mpz_set_ui(visited_1,0); }
-    void              resetVisited2             ( ) const               { mpz_set_ui(visited_2,0); }
-    bool              isResetVisited1           ( ) const               { return mpz_cmp_ui(visited_1, 0) == 0; }
-    bool              isResetVisited2           ( ) const               { return mpz_cmp_ui(visited_2, 0) == 0; }
+    inline size_t     getGraphSize              ( ) const { return arena.size( ); }
+    bool              isSetVisited1             ( clauseid_t id ) const { return isSet(visited_1, id); }
+    bool              isSetVisited2             ( clauseid_t id ) const { return isSet(visited_2, id); }
+    void              setVisited1               ( clauseid_t id ) const { set(visited_1, id); }
+    void              setVisited2               ( clauseid_t id ) const { set(visited_2, id); }
+    void              resetVisited1             ( ) const               { std::fill(visited_1.begin(), visited_1.end(), false); }
+    void              resetVisited2             ( ) const               { std::fill(visited_2.begin(), visited_2.end(), false); }
+    bool              isResetVisited1           ( ) const               { return std::find(visited_1.begin(), visited_1.end(), true) == visited_1.end(); }
+    bool              isResetVisited2           ( ) const               { return std::find(visited_2.begin(), visited_2.end(), true) == visited_2.end(); }
 
     unsigned          getMaxIdVar           ( ) { return max_id_variable; }
     void              getGraphInfo          ( );
@@ -284,11 +488,13 @@ public:
 
     void              printClause           ( ProofNode * );
     void              printClause           ( ProofNode *, std::ostream & );
-    inline ProofNode* getNode               ( clauseid_t id ) const { assert(id < graph.size()); return graph[id]; }
+    inline ProofNode* getNode               ( clauseid_t id ) const { ProofNode & n = arena.node(id); return n.removed ? nullptr : &n; }
     static bool       mergeClauses          (std::vector<Lit> const &, std::vector<Lit> const &, std::vector<Lit>&, Var);
+    // Sets the clause of resolv to the resolvent of the clauses of A and B
+    void              mergeClauses          (ProofNode const * A, ProofNode const * B, ProofNode * resolv, Var pivot);
     inline bool       isRoot                ( ProofNode* n ) const { assert(n); return( n->getId() == root ); }
-    inline ProofNode* getRoot               ( ) const { assert( root<graph.size() );assert(graph[ root ]); return graph[ root ]; }
-    inline void       setRoot               ( clauseid_t id ) { assert( id<graph.size() ); root=id; }
+    inline ProofNode* getRoot               ( ) const { assert(getNode(root)); return getNode(root); }
+    inline void       setRoot               ( clauseid_t id ) { assert( id<getGraphSize() ); root=id; }
 
     void		   verifyLeavesInconsistency ( );
 
@@ -353,6 +559,15 @@ public:
 private:
     void buildProofGraph(ResolutionProof const & proof);
     ProofNode * createProofNodeFor(CRef cref, clause_type _ctype, ResolutionProof const & proof); // Helper method for building the proof graph
+    ProofNode * newNode() { return &arena.newNode(); }
+
+    static bool isSet(std::vector<bool> const & bits, clauseid_t id) { return id < bits.size() and bits[id]; }
+    static void set(std::vector<bool> & bits, clauseid_t id) {
+        if (id >= bits.size()) { bits.resize(std::max<std::size_t>(id + 1, 2 * bits.size()), false); }
+        bits[id] = true;
+    }
+    static std::size_t mergeClauses(Lit const * A, std::size_t Asize, Lit const * B, std::size_t Bsize, Lit * resolv,
+                                    Var pivot);
 
     inline void       addLeaf(clauseid_t id)      {  leaves_ids.insert(id); }
     inline void       removeLeaf(clauseid_t id)   {  leaves_ids.erase(id); }
@@ -371,7 +586,7 @@ private:
     SMTConfig &                 config;
     Logic &                     logic_;
     TermMapper const &          termMapper;
-    std::vector<ProofNode *>    graph {};
+    ProofArena                  arena;
     double                         building_time;               // Time spent building graph
     clauseid_t                     root;                        // Proof root
     std::set<clauseid_t>		   leaves_ids;					// Proof leaves, for top-down visits
@@ -406,8 +621,8 @@ private:
     unsigned swap_ties;
 
     // Global visit vectors
-    mutable mpz_t visited_1;
-    mutable mpz_t visited_2;
+    mutable std::vector<bool> visited_1;
+    mutable std::vector<bool> visited_2;
 };
 
 }
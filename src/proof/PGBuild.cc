@@ -61,19 +61,14 @@ struct ProofBuildingStatistics {
 }
 
 ProofNode * ProofGraph::createProofNodeFor(CRef clause, clause_type _ctype, ResolutionProof const & proof) {
-    ProofNode * n = new ProofNode();
+    ProofNode * n = newNode();
     if (isLeafClauseType(_ctype)) {
         n->initClause(proof.getClause(clause));
         n->setClauseRef(clause);
         //Sort clause literals
-        std::sort(n->getClause().begin(),n->getClause().end());
+        Lit * lits = arena.clauses.data(n->clause);
+        std::sort(lits, lits + n->getClauseSize());
     }
-
-    //Add node to graph vector
-    auto currId = static_cast<clauseid_t>(graph.size());
-    graph.push_back(n);
-    n->setId(currId);
-    assert(getNode(currId) == n);
     return n;
 }
 
@@ -206,12 +201,8 @@ void ProofGraph::buildProofGraph(const ResolutionProof & proof) {
 
                 // End tree not reached: deduced node
                 if (i < chaincla.size() - 1) {
-                    currId = graph.size();
-                    n = new ProofNode();
-                    //Add node to graph vector
-                    n->setId(currId);
-                    graph.push_back(n);
-                    assert(getNode(currId) == n);
+                    n = newNode();
+                    currId = n->getId();
                     n->setType(clause_type::CLA_DERIVED);
                     counters.recordNewClause(clause_type::CLA_DERIVED);
                 } else { // End tree reached: currClause
@@ -280,7 +271,7 @@ void ProofGraph::buildProofGraph(const ResolutionProof & proof) {
             if (getNode(i)) {
                 num_non_null++;
 #ifdef PEDANTIC_DEBUG
-                if (getNode(i)->getPClause()) {
+                if (getNode(i)->hasClause()) {
                     cl_non_null++;
                 }
 #endif
@@ -291,7 +282,7 @@ void ProofGraph::buildProofGraph(const ResolutionProof & proof) {
         cout << "Non null nodes: " << num_non_null << '\n';
         cout << "Non null clauses: " << cl_non_null << '\n';
 #endif
-        if (graph.size() > 1) {
+        if (getGraphSize() > 1) {
             assert(num_non_null == (counters.num_leaf + counters.num_learnt + counters.num_derived + counters.num_theory + counters.num_assump));
         }
 
@@ -349,7 +340,7 @@ void ProofGraph::fillProofGraph() {
                 //Non leaf node
                 if (not n->isLeaf()) {
                     n->initClause();
-                    mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(), n->getPivot());
+                    mergeClauses(n->getAnt1(), n->getAnt2(), n, n->getPivot());
                 }
             }
         } else q.pop_back();
@@ -371,6 +362,7 @@ void ProofGraph::emptyProofGraph() {
         ProofNode * n = getNode(i);
         if (n and not n->isLeaf()) { n->resetClause(); }
     }
+    arena.compact();
     if (verbose() > 0) {
         uint64_t mem_used = memUsed();
         reportf("; Memory used after emptying the proof: %.3f MB\n", mem_used == 0 ? 0 : mem_used / 1048576.0);
@@ -431,11 +423,8 @@ void ProofGraph::removeNode(clauseid_t vid) {
     if (n->getAnt1() == nullptr and n->getAnt2() == nullptr) {
         removeLeaf(vid);
     }
-    n->setAnt1(nullptr);
-    n->setAnt2(nullptr);
-    delete n;
     // Remove n from proof
-    graph[vid] = nullptr;
+    arena.removeNode(*n);
 }
 
 unsigned ProofGraph::removeTree(clauseid_t vid) {
@@ -485,13 +474,10 @@ clauseid_t ProofGraph::dupliNode(RuleContext & ra) {
         assert(res->getAnt1() == w or res->getAnt2() == w);
     }
     // Create node and add to graph vector
-    ProofNode * n = new ProofNode();
-    clauseid_t currId = getGraphSize();
-    n->setId(currId);
-    graph.push_back(n);
-    assert(getNode(currId) == n);
+    ProofNode * n = newNode();
+    clauseid_t currId = n->getId();
     n->setType(w->getType());
-    n->initClause(w->getClause());
+    n->initClause(*w);
     n->setClauseRef(w->getClauseRef());
 
     // Set antecedents, pivot
@@ -509,7 +495,7 @@ clauseid_t ProofGraph::dupliNode(RuleContext & ra) {
     if (v->getAnt1() == w) v->setAnt1(n);
     else if (v->getAnt2() == w) v->setAnt2(n);
     else throw InternalException("Error in node duplication");
-    assert(w->getResolvents().find(v_id) == w->getResolvents().end());
+    assert(not w->hasResolvent(v_id));
     assert(w->getNumResolvents() == num_old_res - 1);
     // Remember to modify context
     ra.cw = currId;
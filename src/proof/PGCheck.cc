@@ -60,7 +60,7 @@ void ProofGraph::verifyLeavesInconsistency() {
 bool ProofNode::checkPolarityAnt() {
     assert(getAnt1());
     assert(getAnt2());
-    std::vector<Lit> & cla = getAnt1()->getClause();
+    auto cla = getAnt1()->getClause();
     for (size_t i = 0; i < cla.size(); i++)
         if (var(cla[i]) == getPivot()) { return not sign(cla[i]); }
     throw InternalException("Pivot not found in node's clause");
@@ -123,8 +123,10 @@ void ProofGraph::checkClause(clauseid_t nid) {
         assert(getNode(n->getAnt2()->getId()));
 
         if (n->getClauseSize() != 0) {
+            auto ant1Clause = n->getAnt1()->getClause();
+            auto ant2Clause = n->getAnt2()->getClause();
             std::vector<Lit> v;
-            mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), v, n->getPivot());
+            mergeClauses({ant1Clause.begin(), ant1Clause.end()}, {ant2Clause.begin(), ant2Clause.end()}, v, n->getPivot());
             if (v.size() != n->getClauseSize()) {
                 std::cerr << "Clause : ";
                 printClause(n);
@@ -143,7 +145,7 @@ void ProofGraph::checkClause(clauseid_t nid) {
                     throw InternalException();
                 }
             // Checks whether clause is tautological
-            std::vector<Lit> & cl = n->getClause();
+            auto cl = n->getClause();
             for (unsigned u = 0; u < cl.size() - 1; u++)
                 if (var(cl[u]) == var(cl[u + 1])) {
                     std::cerr << "Clause : ";
@@ -161,7 +163,7 @@ void ProofGraph::checkClause(clauseid_t nid) {
         }
     }
     // Check that every resolvent has this node as its antecedent
-    std::set<clauseid_t> & resolvents = n->getResolvents();
+    auto resolvents = n->getResolvents();
     for (clauseid_t id : resolvents) {
         assert(id < getGraphSize());
         ProofNode * res = getNode(id);
@@ -15,9 +15,9 @@
 namespace opensmt {
 
 short ProofNode::hasOccurrenceBin(Var v) const {
-    std::vector<Lit> const & cla = getClause();
+    Lit const * cla = arena->clauses.data(clause);
     int first = 0;
-    int last = cla.size() - 1;
+    int last = static_cast<int>(getClauseSize()) - 1;
 
     while (first <= last) {
         int mid = (first + last) / 2;
@@ -167,22 +167,37 @@ std::vector<clauseid_t> ProofGraph::topolSortingBotUp() const {
  */
 bool ProofGraph::mergeClauses(std::vector<Lit> const & A, std::vector<Lit> const & B, std::vector<Lit>& resolv, Var pivot)
 {
-    assert(std::is_sorted(A.begin(), A.end()));
-    assert(std::is_sorted(B.begin(), B.end()));
-    assert(std::find_if(A.begin(), A.end(), [pivot](Lit l) { return var(l) == pivot; }) != A.end());
-    assert(std::find_if(B.begin(), B.end(), [pivot](Lit l) { return var(l) == pivot; }) != B.end());
-    const std::size_t Asize = A.size();
-    const std::size_t Bsize = B.size();
-    if (resolv.size() < Asize + Bsize - 2) {
-        resolv.resize(Asize + Bsize - 2);
+    if (resolv.size() < A.size() + B.size() - 2) {
+        resolv.resize(A.size() + B.size() - 2);
     }
-    assert(resolv.size() >= Asize + Bsize - 2);
+    resolv.resize(mergeClauses(A.data(), A.size(), B.data(), B.size(), resolv.data(), pivot));
+    return true;
+}
+
+void ProofGraph::mergeClauses(ProofNode const * A, ProofNode const * B, ProofNode * resolv, Var pivot)
+{
+    assert(A != resolv and B != resolv);
+    std::size_t Asize = A->getClauseSize();
+    std::size_t Bsize = B->getClauseSize();
+    // The room for the resolvent is made first, as it may move the clauses of the antecedents
+    Lit * out = arena.clauses.resize(resolv->clause, Asize + Bsize - 2);
+    resolv->clause.size = mergeClauses(arena.clauses.data(A->clause), Asize, arena.clauses.data(B->clause), Bsize, out, pivot);
+}
+
+// Writes the resolvent to resolv, which must have room for Asize + Bsize - 2 literals, and returns its size
+std::size_t ProofGraph::mergeClauses(Lit const * A, std::size_t Asize, Lit const * B, std::size_t Bsize, Lit * resolv,
+                                     Var pivot)
+{
+    assert(std::is_sorted(A, A + Asize));
+    assert(std::is_sorted(B, B + Bsize));
+    assert(std::find_if(A, A + Asize, [pivot](Lit l) { return var(l) == pivot; }) != A + Asize);
+    assert(std::find_if(B, B + Bsize, [pivot](Lit l) { return var(l) == pivot; }) != B + Bsize);
 
     std::size_t i = 0;
     std::size_t j = 0;
     std::size_t res = 0;
 
-    auto addIfNotPivot = [&resolv, &res, pivot](Lit l) {
+    auto addIfNotPivot = [resolv, &res, pivot](Lit l) {
         if (var(l) != pivot) {
             assert(res == 0 or resolv[res - 1] != l);
             resolv[res++] = l;
@@ -210,11 +225,9 @@ bool ProofGraph::mergeClauses(std::vector<Lit> const & A, std::vector<Lit> const
         addIfNotPivot(B[j]);
         ++j;
     }
-    assert(resolv.size() >= res);
-    resolv.resize(res);
-    assert(std::is_sorted(resolv.begin(), resolv.end()));
-    assert(std::find_if(resolv.begin(), resolv.end(), [pivot](Lit l) { return var(l) == pivot; }) == resolv.end());
-    return true;
+    assert(std::is_sorted(resolv, resolv + res));
+    assert(std::find_if(resolv, resolv + res, [pivot](Lit l) { return var(l) == pivot; }) == resolv + res);
+    return res;
 }
 
 }
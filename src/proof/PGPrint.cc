@@ -136,7 +136,7 @@ void ProofGraph::printProofAsDotty(std::ostream & out) {
 void ProofGraph::printClause(ProofNode* n)
 {
 	assert(n);
-	std::vector<Lit>& cl=n->getClause();
+	auto cl=n->getClause();
 	std::cerr << n->getId();
 	if(!n->isLeaf()) std::cerr << "(" << n->getAnt1()->getId() << "," << n->getAnt2()->getId() << ")";
 	std::cerr << ": ";
@@ -151,7 +151,7 @@ void ProofGraph::printClause(ProofNode* n)
 void ProofGraph::printClause(ProofNode* n, std::ostream & os)
 {
 	assert(n);
-	std::vector<Lit> & cl = n->getClause();
+	auto cl = n->getClause();
 	for (size_t k = 0 ; k < cl.size(); k++)
 	{
 		if(sign(cl[k])) { os << "-"; }
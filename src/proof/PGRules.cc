@@ -121,8 +121,8 @@ RuleContext ProofGraph::getRuleContext(clauseid_t idv3, clauseid_t idv)
 
     assert(ra.cv == idv);
     assert(idv == v->getId());
-    assert(v == graph[idv]);
-    assert(v == graph[ra.cv]);
+    assert(v == getNode(idv));
+    assert(v == getNode(ra.cv));
 
     //Rules application
     if(!t1_in_C2 && !t0_in_C3)
@@ -135,7 +135,7 @@ RuleContext ProofGraph::getRuleContext(clauseid_t idv3, clauseid_t idv)
         else if(v3->getAnt1()!=NULL && v3->getAnt2()!=NULL && w->getPivot()==v3->getPivot())
             ra.type=rA2B;
             //A2 unary case
-        else if(graph[ra.cv2]->getClauseSize()==1)
+        else if(getNode(ra.cv2)->getClauseSize()==1)
             ra.type=rA2u;
         else
             ra.type=rA2;
@@ -143,7 +143,7 @@ RuleContext ProofGraph::getRuleContext(clauseid_t idv3, clauseid_t idv)
     }
     else if(t1_in_C2 && !t0_in_C3)
     {
-        if(graph[ra.cv3]->getAnt1()!=NULL && graph[ra.cw]->getPivot()==graph[ra.cv3]->getPivot())
+        if(getNode(ra.cv3)->getAnt1()!=NULL && getNode(ra.cw)->getPivot()==getNode(ra.cv3)->getPivot())
             ra.type=rA1B;
         else
             ra.type=rA1;
@@ -152,7 +152,7 @@ RuleContext ProofGraph::getRuleContext(clauseid_t idv3, clauseid_t idv)
     {	ra.type=rB1; return ra;	}
     else if(!t1_in_C2 && t0_in_C3 && sign_t0_C3==sign_t0_v1)
     {
-        if(graph[ra.cv]->getClauseSize()==1)
+        if(getNode(ra.cv)->getClauseSize()==1)
             ra.type=rB2;
         else
             ra.type=rB2prime;
@@ -197,7 +197,7 @@ clauseid_t ProofGraph::applyRuleA1( RuleContext& ra )
     assert((w->getAnt1()==v1 && w->getAnt2()== v2) || (w->getAnt1()==v2 && w->getAnt2()==v1));
 
     //w' given by resolution v1,v3 over v pivot
-    mergeClauses(v1->getClause(),v3->getClause(),w->getClause(),v->getPivot());
+    mergeClauses(v1,v3,w,v->getPivot());
 
     assert(w->getAnt1()==v2 || w->getAnt2()==v2);
     if(w->getAnt1()==v2) w->setAnt1(v3); else w->setAnt2(v3);
@@ -205,19 +205,17 @@ clauseid_t ProofGraph::applyRuleA1( RuleContext& ra )
     v3->addRes(ra.getW());
 
     //Creation new node y
-    ProofNode* y=new ProofNode();
+    ProofNode* y=newNode();
     y->initClause();
     //y given by resolution v2,v3 over v pivot
-    mergeClauses(v2->getClause(),v3->getClause(),y->getClause(),v->getPivot());
+    mergeClauses(v2,v3,y,v->getPivot());
 
     v2->remRes(ra.getW());
     y->setAnt1(v2);
     y->setAnt2(v3);
     y->setType(clause_type::CLA_DERIVED);
     y->setPivot(v->getPivot());
-    y->setId(graph.size());
     y->addRes(ra.getV());
-    graph.push_back(y);
     v2->addRes(y->getId());
     v3->addRes(y->getId());
     // Return id new node
@@ -253,7 +251,7 @@ void ProofGraph::applyRuleA1Prime( RuleContext& ra )
     assert(v3->getAnt1()==v2 || v3->getAnt2()==v2);
 
     //Go back to A1 initial configuration
-    mergeClauses(v1->getClause(),newv2->getClause(),w->getClause(),v->getPivot());
+    mergeClauses(v1,newv2,w,v->getPivot());
 
     //Update antecedents
     w->setAnt1(v1);
@@ -304,7 +302,7 @@ void ProofGraph::applyRuleA2( RuleContext& ra )
     v3->addRes(ra.getW());
 
     //Change w clause to resolvent of v1 and v3 over t1 : t0 C1 C3
-    mergeClauses(v1->getClause(),v3->getClause(),w->getClause(),v->getPivot());
+    mergeClauses(v1,v3,w,v->getPivot());
 
     //Change pivots w:t0->t1,v:t1->t0;
     Var aux;
@@ -336,7 +334,7 @@ void ProofGraph::applyRuleB1( RuleContext& ra )
     w->remRes(ra.getV());
 
     //Change v clause to resolvent of v1 and v3 over t1 : t0 C1 C3
-    mergeClauses(v1->getClause(),v3->getClause(),v->getClause(),v->getPivot());
+    mergeClauses(v1,v3,v,v->getPivot());
     //Remove w, if no more resolvents (and in case also v2, w was its only resolvent)
     if(w->getNumResolvents()==0) removeTree(w->getId());
     B1++;
@@ -370,9 +368,9 @@ void ProofGraph::applyRuleB2( RuleContext& ra )
     v3->addRes(ra.getW());
 
     //Change w clause to resolvent of v1 and v3 over t1 : t0 C1 C3
-    mergeClauses(v1->getClause(),v3->getClause(),w->getClause(),v->getPivot());
+    mergeClauses(v1,v3,w,v->getPivot());
     //Change v clause to resolvent of w and v2 over t0 : C1 C2 C3
-    mergeClauses(w->getClause(),v2->getClause(),v->getClause(),w->getPivot());
+    mergeClauses(w,v2,v,w->getPivot());
 
     //Change pivots w:t0->t1,v:t1->t0;
     Var aux;
@@ -403,7 +401,7 @@ void ProofGraph::applyRuleB2Prime( RuleContext& ra )
     w->remRes(ra.getV());
 
     //Change v clause to resolvent of v1 and v3 over t1 : t0 C1 C3
-    mergeClauses(v1->getClause(),v3->getClause(),v->getClause(),v->getPivot());
+    mergeClauses(v1,v3,v,v->getPivot());
     //Remove w, if no more resolvents (and in case also v2, w was its only resolvent)
     if(w->getNumResolvents()==0) removeTree(w->getId());
     B2prime++;
@@ -438,7 +436,7 @@ void ProofGraph::applyRuleB3( RuleContext& ra )
     w->remRes( ra.getV() );
     v3->remRes( ra.getV() );
     // v2 inherits v children
-    std::set<clauseid_t>& resolvents = v->getResolvents();
+    auto resolvents = v->getResolvents();
     for (clauseid_t resolvent_id : resolvents) {
         assert(resolvent_id < getGraphSize());
         ProofNode* res = getNode(resolvent_id);
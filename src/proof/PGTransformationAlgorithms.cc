@@ -210,7 +210,7 @@ double ProofGraph::recyclePivotsIter() {
                 if (piv_in_ant1 and piv_in_ant2) {
                     //Easy case: pivot still in both antecedents
                     //Sufficient to propagate modifications via merge
-                    mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(), n->getPivot());
+                    mergeClauses(n->getAnt1(), n->getAnt2(), n, n->getPivot());
                     for (clauseid_t clauseid : n->getResolvents()) {
                         if (getNode(clauseid)) { q.push_back(clauseid); }
                     }
@@ -278,6 +278,7 @@ double ProofGraph::recyclePivotsIter() {
         }
     } while (not q.empty());
     resetVisited2();
+    arena.compact();
 
     if (proofCheck()) {
         unsigned rem = cleanProofGraph();
@@ -316,7 +317,7 @@ double ProofGraph::recyclePivotsIter() {
 }
 
 void ProofGraph::recycleUnits() {
-    assert(mpz_cmp_ui(visited_1, 0) == 0 and mpz_cmp_ui(visited_2, 0) == 0);
+    assert(isResetVisited1() and isResetVisited2());
     if (verbose() > 1) { std::cerr << "# " << "Recycle units begin" << '\n'; }
     if (verbose() > 1) {
         uint64_t mem_used = memUsed();
@@ -374,7 +375,7 @@ void ProofGraph::recycleUnits() {
                         //Sufficient to propagate modifications via merge
                         if (piv_in_ant1 and piv_in_ant2) {
                             if (isSetVisited2(n->getAnt1()->getId()) or isSetVisited2(n->getAnt2()->getId())) {
-                                mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(),
+                                mergeClauses(n->getAnt1(), n->getAnt2(), n,
                                              n->getPivot());
                                 setVisited2(id);
                             }
@@ -480,22 +481,21 @@ void ProofGraph::recycleUnits() {
         } else {
             assert(oldroot->hasOccurrenceBin(var(unit->getClause()[0])) != -1);
             //printClause(unit);
-            ProofNode *newroot = new ProofNode();
+            ProofNode *newroot = newNode();
             newroot->initClause();
             newroot->setAnt1(oldroot);
             newroot->setAnt2(unit);
             newroot->setType(clause_type::CLA_DERIVED);
             newroot->setPivot(var((unit->getClause())[0]));
-            newroot->setId(graph.size());
-            graph.push_back(newroot);
             unit->addRes(newroot->getId());
             oldroot->addRes(newroot->getId());
             //newroot given by resolution of root and unit over v pivot
-            mergeClauses(oldroot->getClause(), unit->getClause(), newroot->getClause(), newroot->getPivot());
+            mergeClauses(oldroot, unit, newroot, newroot->getPivot());
             setRoot(newroot->getId());
         }
     }
     assert(getRoot()->getClauseSize() == 0);
+    arena.compact();
 
     if (proofCheck()) {
         unsigned rem = cleanProofGraph();
@@ -599,7 +599,7 @@ void ProofGraph::proofTransformAndRestructure(const double left_time, const int
                         }
 
                         if (isSetVisited2(n->getAnt1()->getId()) or isSetVisited2(n->getAnt2()->getId())) {
-                            mergeClauses(n->getAnt1()->getClause(), n->getAnt2()->getClause(), n->getClause(), n->getPivot());
+                            mergeClauses(n->getAnt1(), n->getAnt2(), n, n->getPivot());
                             setVisited2(id);
                         }
                         // NOTE extra check
@@ -716,6 +716,7 @@ void ProofGraph::proofTransformAndRestructure(const double left_time, const int
             checkProof(true);
         }
     }
+    arena.compact();
 
     if (proofCheck()) {
         unsigned rem = cleanProofGraph();
@@ -962,7 +963,8 @@ void ProofGraph::replaceSubproofsWithNoPartitionTheoryVars(std::vector<Var> cons
             hasMixed |= (present != -1);
         }
         if (!hasMixed) { continue; }
-        auto resolvents_ids = leaf->getResolvents();
+        // The resolvents of the leaf change in the loop
+        std::vector<clauseid_t> resolvents_ids(leaf->getResolvents().begin(), leaf->getResolvents().end());
         for (auto resolvent_id : resolvents_ids) {
             ProofNode * resolvent = this->getNode(resolvent_id);
             assert(resolvent);
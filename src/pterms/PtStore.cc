@@ -30,6 +30,8 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <algorithm>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 namespace opensmt {
 int const PtStore::ptstore_vec_idx = 1;
@@ -214,24 +216,359 @@ PTRef PtStore::getFromCtermMap(SymRef & k) {
     return cterm_map[k];
 }
 
-bool PtStore::hasBoolKey(PTLKey const & k) {
-    return bool_map.find(k) != bool_map.end();
+uint32_t PtStore::findSlot(SymRef sym, vec<PTRef> const & args, uint32_t hash) const {
+    auto mask = static_cast<uint32_t>(termTable.size() - 1);
+    for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+        Slot const & slot = termTable[i];
+        if (slot.tr == PTRef_Undef) { return i; }
+        if (slot.hash == hash and matches(slot.tr, sym, args)) { return i; }
+    }
+}
+
+bool PtStore::matches(PTRef tr, SymRef sym, vec<PTRef> const & args) const {
+    Pterm const & term = pta[tr];
+    return term.symb() == sym and term.size() == args.size() and std::equal(args.begin(), args.end(), term.begin());
 }
-void PtStore::addToBoolMap(PTLKey && k, PTRef tr) {
-    bool_map[std::move(k)] = tr;
+
+void PtStore::growTable(std::size_t minCapacity) {
+    std::size_t capacity = termTable.size();
+    while (capacity < minCapacity) {
+        capacity *= 2;
+    }
+    if (capacity == termTable.size()) { return; }
+    std::vector<Slot> old(capacity, Slot{PTRef_Undef, 0});
+    old.swap(termTable);
+    auto mask = static_cast<uint32_t>(capacity - 1);
+    for (Slot const & slot : old) {
+        if (slot.tr == PTRef_Undef) { continue; }
+        uint32_t i = slot.hash & mask;
+        while (termTable[i].tr != PTRef_Undef) {
+            i = (i + 1) & mask;
+        }
+        termTable[i] = slot;
+    }
 }
-PTRef PtStore::getFromBoolMap(PTLKey const & k) {
-    return bool_map.at(k);
+
+PTRef PtStore::lookupCanonical(SymRef sym, vec<PTRef> const & args) const {
+    uint32_t hash = PTLHash()(sym, args.begin(), args.size());
+    if (concurrent) { return const_cast<PtStore *>(this)->getOrCreateConcurrent(sym, args, hash, false); }
+    return termTable[findSlot(sym, args, hash)].tr;
 }
 
-bool PtStore::hasCplxKey(PTLKey const & k) {
-    return cplx_map.find(k) != cplx_map.end();
+PTRef PtStore::getOrCreateCanonical(SymRef sym, vec<PTRef> const & args) {
+    uint32_t hash = PTLHash()(sym, args.begin(), args.size());
+    if (concurrent) { return getOrCreateConcurrent(sym, args, hash, true); }
+    Slot & slot = termTable[findSlot(sym, args, hash)];
+    if (slot.tr != PTRef_Undef) { return slot.tr; }
+    PTRef tr = newTerm(sym, args);
+    slot = {tr, hash};
+    // Keep the load factor at most one half
+    if (++termTableSize * 2 > termTable.size()) { growTable(termTable.size() * 2); }
+    return tr;
 }
-void PtStore::addToCplxMap(PTLKey && k, PTRef tr) {
-    cplx_map[std::move(k)] = tr;
+
+void PtStore::reserve(std::size_t numTerms) {
+    idToPTRef.capacity(static_cast<int>(idToPTRef.size_() + numTerms));
+    growTable((termTableSize + numTerms) * 2);
 }
-PTRef PtStore::getFromCplxMap(PTLKey const & k) {
-    return cplx_map.at(k);
+
+std::size_t PtStore::memoryUsed() const {
+    return pta.size() * sizeof(uint32_t) + idToPTRef.size_() * sizeof(PTRef) + termTable.size() * sizeof(Slot);
+}
+
+std::size_t PtStore::collectGarbage(vec<PTRef> & roots, vec<PTRef> & weakRefs) {
+    assert(not concurrent);
+    std::size_t const usedBefore = memoryUsed();
+
+    // Children have smaller ids than their parents, so one pass down from the highest id marks everything reachable
+    std::vector<char> live(idToPTRef.size_(), 0);
+    for (PTRef tr : roots) {
+        live[Idx(pta[tr].getId())] = 1;
+    }
+    for (int i = idToPTRef.size() - 1; i >= 0; i--) {
+        if (not live[i]) { continue; }
+        for (PTRef child : pta[idToPTRef[i]]) {
+            live[Idx(pta[child].getId())] = 1;
+        }
+    }
+    std::vector<PTRef> liveTerms;
+    uint32_t liveWords = 0;
+    std::size_t liveWithArgs = 0;
+    for (int i = 0; i < idToPTRef.size(); i++) {
+        if (not live[i]) { continue; }
+        PTRef tr = idToPTRef[i];
+        liveTerms.push_back(tr);
+        liveWords += PtermAllocator::ptermWord32Size(pta[tr].size());
+        liveWithArgs += pta[tr].size() > 0;
+    }
+
+    // Assign the new places in the order of the old references, on which the canonical order of arguments depends.
+    // After concurrent construction this may differ from the order of the ids.
+    std::vector<PTRef> byRef(liveTerms);
+    std::sort(byRef.begin(), byRef.end(), [](PTRef a, PTRef b) { return a.x < b.x; });
+    uint32_t next = 0;
+    for (PTRef tr : byRef) {
+        Pterm & term = pta[tr];
+        term.relocate(PTRef{next});
+        next += PtermAllocator::ptermWord32Size(term.size());
+    }
+
+    PtermAllocator to(std::max(liveWords, 1024u * 1024u));
+    if (liveWords > 0) { to.RegionAllocator::alloc(static_cast<int>(liveWords)); }
+    to.n_terms = static_cast<uint32_t>(liveTerms.size());
+    vec<PTRef> newIdToPTRef;
+    newIdToPTRef.capacity(static_cast<int>(liveTerms.size()));
+    std::size_t capacity = 1024;
+    while (capacity < liveWithArgs * 2 + 1) {
+        capacity *= 2;
+    }
+    std::vector<Slot> newTable(capacity, Slot{PTRef_Undef, 0});
+    auto const mask = static_cast<uint32_t>(capacity - 1);
+    cterm_map.clear();
+    for (uint32_t id = 0; id < liveTerms.size(); id++) {
+        PTRef tr = liveTerms[id];
+        pta.reloc(tr, to, id);
+        newIdToPTRef.push(tr);
+        Pterm const & term = to[tr];
+        if (term.size() == 0) {
+            cterm_map.insert(term.symb(), tr);
+            continue;
+        }
+        uint32_t hash = PTLHash()(term.symb(), term.begin(), term.size());
+        uint32_t i = hash & mask;
+        while (newTable[i].tr != PTRef_Undef) {
+            i = (i + 1) & mask;
+        }
+        newTable[i] = {tr, hash};
+    }
+
+    for (PTRef & root : roots) {
+        root = pta[root].relocation();
+    }
+    for (PTRef & ref : weakRefs) {
+        if (ref != PTRef_Undef) { ref = pta[ref].reloced() ? pta[ref].relocation() : PTRef_Undef; }
+    }
+    to.moveTo(pta);
+    newIdToPTRef.moveTo(idToPTRef);
+    termTable = std::move(newTable);
+    termTableSize = liveWithArgs;
+    return usedBefore - memoryUsed();
+}
+
+namespace {
+// Marks a slot whose term is being created by another thread
+constexpr uint32_t busySlot = INT32_MAX - 1; // Below PTRef_Undef
+constexpr uint32_t chunkWords = 16 * 1024;
+constexpr uint32_t maxThreadChunks = 64;
+
+std::atomic<uint64_t> concurrentSessions{0};
+
+// The unused part of the current chunk of the thread in a concurrent construction session
+struct Arena {
+    uint64_t session = 0;
+    uint32_t next = 0;
+    uint32_t end = 0;
+    uint32_t group = 0;
+};
+thread_local Arena arena;
+} // namespace
+
+void PtStore::beginConcurrentConstruction(std::size_t maxNewTerms, std::size_t maxNewArgs) {
+    assert(not concurrent);
+    std::size_t words = maxNewTerms * PtermAllocator::ptermWord32Size(0) + maxNewArgs + maxThreadChunks * chunkWords;
+    if (words > INT32_MAX or pta.size() + words >= busySlot or idToPTRef.size_() + maxNewTerms > INT32_MAX) {
+        throw OutOfMemoryException();
+    }
+    growTable((termTableSize + maxNewTerms) * 2 + 1);
+    auto firstId = static_cast<uint32_t>(idToPTRef.size());
+    idToPTRef.growTo(static_cast<int>(firstId + maxNewTerms), PTRef_Undef);
+    uint32_t regionStart = pta.RegionAllocator::alloc(static_cast<int>(words));
+    concurrent = std::make_unique<ConcurrentState>();
+    concurrent->session = ++concurrentSessions;
+    concurrent->firstId = firstId;
+    concurrent->idLimit = static_cast<uint32_t>(firstId + maxNewTerms);
+    concurrent->regionStart = regionStart;
+    concurrent->regionEnd = regionStart + static_cast<uint32_t>(words);
+    concurrent->nextId = firstId;
+    concurrent->nextChunk = regionStart;
+    concurrent->groups.assign(maxNewTerms, 0);
+}
+
+void PtStore::endConcurrentConstruction() {
+    assert(concurrent);
+    uint32_t numNew = concurrent->nextId - concurrent->firstId;
+    idToPTRef.shrink(static_cast<int>(concurrent->idLimit - concurrent->nextId));
+    pta.n_terms += numNew;
+    termTableSize += numNew;
+    assert(idToPTRef.size_() == pta.getNumTerms());
+    // Return the reserved memory no chunk reached and account for the unused ends of the chunks
+    auto regionUsed = static_cast<uint32_t>(std::min<uint64_t>(concurrent->nextChunk, concurrent->regionEnd));
+    pta.shrink(concurrent->regionEnd - regionUsed);
+    pta.RegionAllocator::free(static_cast<int>(regionUsed - concurrent->regionStart - concurrent->usedWords));
+    concurrent.reset();
+}
+
+void PtStore::abortConcurrentConstruction() {
+    assert(concurrent);
+    uint32_t const regionStart = concurrent->regionStart;
+    // Drop the new terms, all in the reserved region, from the table in place, since this must not fail
+    for (Slot & slot : termTable) {
+        if (slot.tr != PTRef_Undef and slot.tr.x >= regionStart) { slot = Slot{PTRef_Undef, 0}; }
+    }
+    // Put the old terms back on their probe sequences, going around from an empty slot so that no run wraps
+    auto const mask = static_cast<uint32_t>(termTable.size() - 1);
+    uint32_t start = 0;
+    while (termTable[start].tr != PTRef_Undef) {
+        ++start;
+    }
+    for (uint32_t k = 1; k <= mask; k++) {
+        uint32_t j = (start + k) & mask;
+        Slot slot = termTable[j];
+        if (slot.tr == PTRef_Undef) { continue; }
+        termTable[j] = Slot{PTRef_Undef, 0};
+        uint32_t i = slot.hash & mask;
+        while (termTable[i].tr != PTRef_Undef) {
+            i = (i + 1) & mask;
+        }
+        termTable[i] = slot;
+    }
+    idToPTRef.shrink(static_cast<int>(concurrent->idLimit - concurrent->firstId));
+    pta.shrink(concurrent->regionEnd - regionStart);
+    assert(idToPTRef.size_() == pta.getNumTerms());
+    concurrent.reset();
+}
+
+void PtStore::setConcurrentGroup(uint32_t group) {
+    assert(concurrent);
+    if (arena.session != concurrent->session) { arena = {concurrent->session, 0, 0, 0}; }
+    arena.group = group;
+}
+
+void PtStore::endConcurrentConstruction(vec<PTRef> & results) {
+    assert(concurrent);
+    uint32_t const firstId = concurrent->firstId;
+    uint32_t const regionStart = concurrent->regionStart;
+    uint32_t const numNew = concurrent->nextId - firstId;
+    // A thread allocates its chunks at increasing addresses, so within a group the references follow the creation
+    std::vector<uint32_t> order(numNew);
+    for (uint32_t i = 0; i < numNew; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        uint32_t groupA = concurrent->groups[a];
+        uint32_t groupB = concurrent->groups[b];
+        return groupA != groupB ? groupA < groupB : idToPTRef[firstId + a].x < idToPTRef[firstId + b].x;
+    });
+
+    std::unordered_map<uint32_t, PTRef> newRefs;
+    newRefs.reserve(numNew);
+    uint32_t next = regionStart;
+    for (uint32_t i : order) {
+        newRefs.emplace(idToPTRef[firstId + i].x, PTRef{next});
+        next += PtermAllocator::ptermWord32Size(pta[idToPTRef[firstId + i]].size());
+    }
+    auto newRef = [&](PTRef tr) { return tr.x < regionStart ? tr : newRefs.at(tr.x); };
+
+    // Copy the terms aside in their new order, since their new places overlap the old ones
+    std::vector<uint32_t> copy;
+    copy.reserve(next - regionStart);
+    for (uint32_t k = 0; k < numNew; k++) {
+        Pterm const & term = pta[idToPTRef[firstId + order[k]]];
+        auto const * words = reinterpret_cast<uint32_t const *>(&term);
+        std::size_t at = copy.size();
+        copy.insert(copy.end(), words, words + PtermAllocator::ptermWord32Size(term.size()));
+        auto & moved = reinterpret_cast<Pterm &>(copy[at]);
+        moved.setId(static_cast<int>(firstId + k));
+        for (int j = 0; j < moved.size(); j++) {
+            moved.args[j] = newRef(moved.args[j]);
+        }
+    }
+    std::copy(copy.begin(), copy.end(), pta.RegionAllocator::lea(regionStart));
+    pta.shrink(concurrent->regionEnd - next);
+    pta.n_terms += numNew;
+    idToPTRef.shrink(static_cast<int>(concurrent->idLimit - concurrent->nextId));
+    for (uint32_t k = 0, at = regionStart; k < numNew; k++) {
+        PTRef tr{at};
+        idToPTRef[static_cast<int>(firstId + k)] = tr;
+        at += PtermAllocator::ptermWord32Size(pta[tr].size());
+    }
+    assert(idToPTRef.size_() == pta.getNumTerms());
+
+    // The hashes of the new terms change with their arguments
+    std::vector<Slot> old(termTable.size(), Slot{PTRef_Undef, 0});
+    old.swap(termTable);
+    auto const mask = static_cast<uint32_t>(termTable.size() - 1);
+    for (Slot slot : old) {
+        if (slot.tr == PTRef_Undef) { continue; }
+        if (slot.tr.x >= regionStart) {
+            slot.tr = newRef(slot.tr);
+            Pterm const & term = pta[slot.tr];
+            slot.hash = PTLHash()(term.symb(), term.begin(), term.size());
+        }
+        uint32_t i = slot.hash & mask;
+        while (termTable[i].tr != PTRef_Undef) {
+            i = (i + 1) & mask;
+        }
+        termTable[i] = slot;
+    }
+    termTableSize += numNew;
+
+    for (PTRef & result : results) {
+        result = newRef(result);
+    }
+    concurrent.reset();
+}
+
+PTRef PtStore::newTermConcurrent(SymRef sym, vec<PTRef> const & args) {
+    auto words = static_cast<uint32_t>(PtermAllocator::ptermWord32Size(args.size()));
+    if (arena.session != concurrent->session or arena.end - arena.next < words) {
+        uint32_t size = std::max(chunkWords, words);
+        uint64_t start = concurrent->nextChunk.fetch_add(size);
+        if (start + words > concurrent->regionEnd) { throw OutOfMemoryException(); }
+        uint32_t group = arena.session == concurrent->session ? arena.group : 0;
+        arena = {concurrent->session, static_cast<uint32_t>(start),
+                 static_cast<uint32_t>(std::min<uint64_t>(start + size, concurrent->regionEnd)), group};
+    }
+    uint32_t id = concurrent->nextId.fetch_add(1);
+    if (id >= concurrent->idLimit) { throw OutOfMemoryException(); }
+    concurrent->groups[id - concurrent->firstId] = arena.group;
+    PTRef tr = pta.allocAt(arena.next, sym, args, id);
+    arena.next += words;
+    concurrent->usedWords.fetch_add(words, std::memory_order_relaxed);
+    idToPTRef[static_cast<int>(id)] = tr;
+    return tr;
+}
+
+PTRef PtStore::getOrCreateConcurrent(SymRef sym, vec<PTRef> const & args, uint32_t hash, bool create) {
+    auto mask = static_cast<uint32_t>(termTable.size() - 1);
+    for (uint32_t i = hash & mask;; i = (i + 1) & mask) {
+        std::atomic_ref<uint32_t> slotTerm(termTable[i].tr.x);
+        uint32_t x = slotTerm.load(std::memory_order_acquire);
+        while (true) {
+            if (x == busySlot) {
+                std::this_thread::yield();
+                x = slotTerm.load(std::memory_order_acquire);
+            } else if (x == PTRef_Undef.x) {
+                if (not create) { return PTRef_Undef; }
+                if (not slotTerm.compare_exchange_weak(x, busySlot, std::memory_order_acquire)) { continue; }
+                PTRef tr;
+                try {
+                    tr = newTermConcurrent(sym, args);
+                } catch (...) {
+                    slotTerm.store(PTRef_Undef.x, std::memory_order_release);
+                    throw;
+                }
+                termTable[i].hash = hash;
+                slotTerm.store(tr.x, std::memory_order_release);
+                return tr;
+            } else {
+                break;
+            }
+        }
+        // The hash was written before the term was published
+        PTRef tr{x};
+        if (termTable[i].hash == hash and matches(tr, sym, args)) { return tr; }
+    }
 }
 
 PtermIter PtStore::getPtermIter() {
@@ -30,7 +30,9 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <symbols/SymStore.h>
 
-#include <unordered_map>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 namespace opensmt {
 class SStore; // forward declaration
@@ -77,19 +79,81 @@ public:
       }*/
     PTRef getFromCtermMap(SymRef & k);        // { return cterm_map[k]; }
 
-    bool hasBoolKey(PTLKey const & k);
-    void addToBoolMap(PTLKey && k, PTRef tr);
-    PTRef getFromBoolMap(PTLKey const & k);
-
-    bool hasCplxKey(PTLKey const & k);
-    void addToCplxMap(PTLKey && k, PTRef tr);
-    PTRef getFromCplxMap(PTLKey const & k);
+    // Hash-consing of terms with arguments; the arguments must already be in normal form
+    PTRef lookupCanonical(SymRef sym, vec<PTRef> const & args) const; // PTRef_Undef if there is no such term
+    PTRef getOrCreateCanonical(SymRef sym, vec<PTRef> const & args);
+    void reserve(std::size_t numTerms);
+
+    /**
+     * Concurrent construction: until endConcurrentConstruction, getOrCreateCanonical and lookupCanonical may be called
+     * from several threads at once, for at most maxNewTerms new terms with at most maxNewArgs arguments in total.
+     *
+     * The memory for the new terms and the room in the hash table are reserved up front, so neither moves while other
+     * threads read them. Each thread allocates its terms from its own chunk of the reserved memory. The table slots are
+     * claimed with compare-and-swap, so lookups take no locks and two threads building the same term agree on it.
+     * Nothing else in the store may change in the meantime, in particular no new nullary terms can be made. Exceeding
+     * the reserved capacity throws OutOfMemoryException; the construction must then be aborted.
+     *
+     * endConcurrentConstruction or abortConcurrentConstruction must be called once all the constructing threads are
+     * done. The plain variant of endConcurrentConstruction keeps the references the terms got during the construction,
+     * which depend on how the threads interleaved.
+     */
+    void beginConcurrentConstruction(std::size_t maxNewTerms, std::size_t maxNewArgs);
+    void endConcurrentConstruction();
+    // Ends the concurrent construction and drops all the terms created in it, leaving the store as it was before
+    void abortConcurrentConstruction();
+    /**
+     * Ends the concurrent construction and places the new terms in a deterministic order: by the group of the thread
+     * that created them, and by their order of creation within a group. Their references and ids are then the same as
+     * if the groups had been built one after another by a single thread, provided that no term was built in two
+     * groups. The results are replaced by the new references of their terms.
+     */
+    void endConcurrentConstruction(vec<PTRef> & results);
+    // Sets the group of the terms the calling thread creates from now on in the current concurrent construction
+    void setConcurrentGroup(uint32_t group);
+    bool inConcurrentConstruction() const { return concurrent != nullptr; }
+
+    /**
+     * Mark-and-compact garbage collection: drops the terms that are not reachable from the roots and moves the others
+     * to a new, compact allocation. The remaining terms keep the relative order of their references and of their ids,
+     * so the canonical order of arguments and the topological order of the ids still hold.
+     *
+     * The roots are replaced by the new references of their terms, and so are the weak references unless their terms
+     * were dropped, in which case they become PTRef_Undef. All other references to terms are invalid afterwards.
+     *
+     * @return the number of bytes reclaimed
+     */
+    std::size_t collectGarbage(vec<PTRef> & roots, vec<PTRef> & weakRefs);
 
     PtermIter getPtermIter(); // { return PtermIter(idToPTRef); }
 
     std::size_t getNumberOfTerms() const { return pta.getNumTerms(); }
 
 private:
+    struct Slot {
+        PTRef tr;
+        uint32_t hash;
+    };
+
+    struct ConcurrentState {
+        uint64_t session;
+        uint32_t firstId;
+        uint32_t idLimit;
+        uint32_t regionStart;
+        uint32_t regionEnd;
+        std::atomic<uint32_t> nextId;
+        std::atomic<uint64_t> nextChunk;
+        std::atomic<uint64_t> usedWords{0};
+        std::vector<uint32_t> groups; // Of the new terms, indexed from firstId
+    };
+
+    uint32_t findSlot(SymRef sym, vec<PTRef> const & args, uint32_t hash) const;
+    std::size_t memoryUsed() const;
+    void growTable(std::size_t minCapacity);
+    bool matches(PTRef tr, SymRef sym, vec<PTRef> const & args) const;
+    PTRef getOrCreateConcurrent(SymRef sym, vec<PTRef> const & args, uint32_t hash, bool create);
+    PTRef newTermConcurrent(SymRef sym, vec<PTRef> const & args);
+
     static int const ptstore_buf_idx;
     static int const ptstore_vec_idx;
 
@@ -99,9 +163,11 @@ private:
 
     Map<SymRef, PTRef, SymRefHash, Equal<SymRef>> cterm_map; // Mapping constant symbols to terms
 
-    std::unordered_map<PTLKey, PTRef, PTLHash, Equal<PTLKey>> cplx_map; // Mapping complex terms to canonical terms
+    // Open-addressing table of the canonical terms with arguments, compared against the arguments in pta
+    std::vector<Slot> termTable = std::vector<Slot>(1024, Slot{PTRef_Undef, 0});
+    std::size_t termTableSize = 0;
 
-    std::unordered_map<PTLKey, PTRef, PTLHash, Equal<PTLKey>> bool_map; // Mapping boolean terms to canonical terms
+    std::unique_ptr<ConcurrentState> concurrent;
 };
 } // namespace opensmt
 
@@ -1,22 +1,17 @@
 #include "Pterm.h"
 
 namespace opensmt {
-// MB: TODO this calls method that is not implemented
-void PtermAllocator::reloc(PTRef & tr, PtermAllocator & to) {
-    Pterm & t = operator[](tr);
-
-    if (t.reloced()) {
-        tr = t.relocation();
-        return;
+void PtermAllocator::reloc(PTRef & tr, PtermAllocator & to, uint32_t id) const {
+    Pterm const & t = operator[](tr);
+    assert(t.reloced());
+    PTRef const newRef = t.relocation();
+    Pterm * copy = new (to.lea(newRef)) Pterm(t.symb(), {});
+    copy->header = t.header;
+    copy->header.reloced = 0;
+    copy->id.x = id;
+    for (int i = 0; i < t.size(); i++) {
+        copy->args[i] = operator[](t.args[i]).relocation();
     }
-
-    // TODO: this is not implemented!
-    tr = to.alloc(t, false);
-    t.relocate(tr);
-
-    // Copy extra data-fields:
-    to[tr].type(t.type());
-    //        if (to[tr].learnt())         to[tr].activity() = t.activity();
-    //        else if (to[tr].has_extra()) to[tr].calcAbstraction();
+    tr = newRef;
 }
 } // namespace opensmt
@@ -35,27 +35,16 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <symbols/SymRef.h>
 
 namespace opensmt {
-// A key used for pterm resolve lookups
-struct PTLKey {
-    SymRef sym;
-    vec<PTRef> args;
-    friend bool operator==(PTLKey const & k1, PTLKey const & k2) {
-        if (k1.sym != k2.sym) return false;
-        if (k1.args.size() != k2.args.size()) return false;
-        int i;
-        for (i = 0; i < k1.args.size(); i++)
-            if (k1.args[i] != k2.args[i]) break;
-        return i == k1.args.size();
-    }
-};
-
+// Hash of a term given by its symbol and arguments. The arguments are mixed in order, so permutations and terms with
+// small, structured references are spread well.
 struct PTLHash {
-    uint32_t operator()(PTLKey const & s) const {
-        uint32_t v = (uint32_t)s.sym.x;
-        for (int i = 0; i < s.args.size(); i++) {
-            v += (uint32_t)s.args[i].x;
+    uint32_t operator()(SymRef sym, PTRef const * args, int size) const {
+        uint64_t h = (static_cast<uint64_t>(sym.x) + 1) * 0x9e3779b97f4a7c15ull;
+        for (int i = 0; i < size; i++) {
+            h = (h ^ args[i].x) * 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 31;
         }
-        return v;
+        return static_cast<uint32_t>(h ^ (h >> 32));
     }
 };
 
@@ -89,10 +78,14 @@ public:
     SymRef symb() const { return sym; }
     bool has_extra() const { return false; }
     bool reloced() const { return header.reloced; }
-    PTRef relocation() const { return args[0]; }
+    // A relocated term keeps its new reference in place of its id, since nullary terms have no room in the arguments
+    PTRef relocation() const {
+        assert(reloced());
+        return PTRef{id.x};
+    }
     void relocate(PTRef t) {
         header.reloced = 1;
-        args[0] = t;
+        id.x = t.x;
     }
     uint32_t type() const { return header.type; }
     void type(uint32_t m) { header.type = m; }
@@ -153,6 +146,7 @@ public:
 #endif
 private:
     friend class PtermAllocator;
+    friend class PtStore;
     friend void ptermSort(Pterm &);
 
     // MB: Constructor is private to forbid any use outside PtermAllocator, which is a friend
@@ -177,7 +171,7 @@ private:
     } header;
     PTId id;
     SymRef sym;
-    PTRef args[0]; // Either the terms or the relocation reference
+    PTRef args[0];
 };
 
 class PtPair {
@@ -229,9 +223,12 @@ public:
         return tid;
     }
 
-    PTRef alloc(Pterm &, bool) {
-        assert(false);
-        return PTRef_Undef;
+    // Constructs a term in memory that was already allocated, for concurrent construction in PtStore
+    PTRef allocAt(Ref at, SymRef const sym, vec<PTRef> const & ps, uint32_t id) {
+        PTRef tid = {at};
+        new (lea(tid)) Pterm(sym, ps);
+        operator[](tid).setId(id);
+        return tid;
     }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
@@ -253,20 +250,10 @@ public:
         RegionAllocator::free(ptermWord32Size(t.size()));
     }
 
-    void reloc(PTRef & tr, PtermAllocator & to);
-    /*{
-        Pterm& t = operator[](tr);
-
-        if (t.reloced()) { tr = t.relocation(); return; }
-
-        tr = to.alloc(t, false);
-        t.relocate(tr);
+    // Copies a relocated term to its new place in `to`, which must already be allocated, and gives it the new id.
+    // The arguments must have been relocated as well.
+    void reloc(PTRef & tr, PtermAllocator & to, uint32_t id) const;
 
-        // Copy extra data-fields:
-        to[tr].type(t.type());
-//        if (to[tr].learnt())         to[tr].activity() = t.activity();
-//        else if (to[tr].has_extra()) to[tr].calcAbstraction();
-    }*/
 private:
     friend class PtStore;
 
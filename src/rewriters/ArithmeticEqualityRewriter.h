@@ -37,8 +37,8 @@ private:
 
 class ArithmeticEqualityRewriter : public Rewriter<EqualityRewriterConfig> {
 public:
-    explicit ArithmeticEqualityRewriter(ArithLogic & logic)
-        : Rewriter<EqualityRewriterConfig>(logic, config),
+    explicit ArithmeticEqualityRewriter(ArithLogic & logic, RewriteMemo * memo = nullptr)
+        : Rewriter<EqualityRewriterConfig>(logic, config, memo),
           config(logic) {}
 
 private:
@@ -0,0 +1,140 @@
+#ifndef OPENSMT_CARDINALITYREWRITER_H
+#define OPENSMT_CARDINALITYREWRITER_H
+
+#include "Rewriter.h"
+
+#include <itehandler/IteHandler.h>
+#include <logics/ArithLogic.h>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace opensmt {
+/**
+ * Recognizes inequalities over sums of numeric ites with constant branches, such as
+ * (<= (+ (ite b1 1 0) (ite b2 1 0) (ite b3 1 0)) 1), as cardinality or pseudo-Boolean constraints over the conditions
+ * of the ites. Each such inequality is replaced by an equivalent Boolean formula, a sequential weight counter, which
+ * the Cnfizer then turns into clauses. The simplex no longer needs a row for the sum and a column for each ite.
+ *
+ * Only sums of at least two ites are rewritten; the definitions of the auxiliary variables of the ites, which have a
+ * single ite each, must stay as they are.
+ */
+class CardinalityConfig : public DefaultRewriterConfig {
+public:
+    explicit CardinalityConfig(ArithLogic & logic) : logic(logic) {}
+
+    // The constraints are atoms of the Boolean structure, there is nothing to rewrite in the arithmetic terms
+    bool previsit(PTRef term) override { return logic.hasSortBool(term); }
+
+    PTRef rewrite(PTRef term) override {
+        if (not logic.isLeq(term)) { return term; }
+        auto constraint = toPseudoBoolean(term);
+        if (not constraint) { return term; }
+        PTRef encoded = encodeAtLeast(*constraint);
+        return encoded == PTRef_Undef ? term : encoded;
+    }
+
+private:
+    // The limit on the number of the counter terms, i.e., the number of literals times the bound
+    static constexpr std::size_t maxCounterSize = 1u << 16;
+
+    struct WeightedLiteral {
+        PTRef literal;
+        Number weight; // A positive integer
+    };
+
+    // The weights of the true literals sum up to at least the bound
+    struct PseudoBoolean {
+        std::vector<WeightedLiteral> literals;
+        Number bound;
+    };
+
+    ArithLogic & logic;
+
+    PTRef getIte(PTRef var) const {
+        if (logic.isIte(var)) { return var; }
+        auto name = std::string_view(logic.getSymName(var));
+        if (logic.isVar(var) and name.compare(0, IteHandler::itePrefix.size(), IteHandler::itePrefix) == 0) {
+            return IteHandler::getIteTermFor(logic, var);
+        }
+        return PTRef_Undef;
+    }
+
+    std::optional<PseudoBoolean> toPseudoBoolean(PTRef leq) {
+        auto [constant, poly] = logic.leqToConstantAndTerm(leq);
+        if (not logic.isPlus(poly)) { return std::nullopt; }
+        // c <= sum_i a_i * (ite b_i t_i e_i) is sum_i a_i * (t_i - e_i) * [b_i] >= c - sum_i a_i * e_i
+        PseudoBoolean constraint{{}, logic.getNumConst(constant)};
+        vec<PTRef> factors;
+        for (PTRef factor : logic.getPterm(poly)) {
+            factors.push(factor);
+        }
+        for (PTRef factor : factors) {
+            auto [var, coeffTerm] = logic.splitTermToVarAndConst(factor);
+            PTRef ite = getIte(var);
+            if (ite == PTRef_Undef) { return std::nullopt; }
+            PTRef condition = logic.getPterm(ite)[0];
+            PTRef thenTerm = logic.getPterm(ite)[1];
+            PTRef elseTerm = logic.getPterm(ite)[2];
+            if (not logic.isNumConst(thenTerm) or not logic.isNumConst(elseTerm)) { return std::nullopt; }
+            Number const coeff = logic.getNumConst(coeffTerm);
+            constraint.bound -= coeff * logic.getNumConst(elseTerm);
+            Number weight = coeff * (logic.getNumConst(thenTerm) - logic.getNumConst(elseTerm));
+            if (weight.sign() == 0) { continue; }
+            if (not weight.isInteger()) { return std::nullopt; }
+            if (weight.sign() < 0) {
+                // w * [b] is w + |w| * [not b]
+                constraint.bound -= weight;
+                weight = -weight;
+                condition = logic.mkNot(condition);
+            }
+            constraint.literals.push_back({condition, std::move(weight)});
+        }
+        if (constraint.literals.size() < 2) { return std::nullopt; }
+        // The weighted sum is an integer
+        constraint.bound = constraint.bound.ceil();
+        return constraint;
+    }
+
+    // Returns PTRef_Undef if the counter would be too large
+    PTRef encodeAtLeast(PseudoBoolean const & constraint) {
+        Number total = 0;
+        for (auto const & literal : constraint.literals) {
+            total += literal.weight;
+        }
+        if (constraint.bound.sign() <= 0) { return logic.getTerm_true(); }
+        if (constraint.bound > total) { return logic.getTerm_false(); }
+        // At least bound of the weight is true iff at most total - bound is false; count to the smaller of the bounds
+        Number const complementBound = total - constraint.bound + 1;
+        bool const complement = complementBound < constraint.bound;
+        Number const & bound = complement ? complementBound : constraint.bound;
+        if (bound > Number(static_cast<int>(maxCounterSize / constraint.literals.size()))) { return PTRef_Undef; }
+
+        auto const k = static_cast<std::size_t>(bound.get_d());
+        // atLeast[j] holds when the literals processed so far weigh at least j
+        std::vector<PTRef> atLeast(k + 1, logic.getTerm_false());
+        atLeast[0] = logic.getTerm_true();
+        for (auto const & [literal, weight] : constraint.literals) {
+            PTRef const lit = complement ? logic.mkNot(literal) : literal;
+            std::size_t const w = weight >= bound ? k : static_cast<std::size_t>(weight.get_d());
+            for (std::size_t j = k; j >= 1; --j) {
+                atLeast[j] = logic.mkOr(atLeast[j], logic.mkAnd(lit, atLeast[j > w ? j - w : 0]));
+            }
+        }
+        return complement ? logic.mkNot(atLeast[k]) : atLeast[k];
+    }
+};
+
+class CardinalityRewriter : public Rewriter<CardinalityConfig> {
+public:
+    explicit CardinalityRewriter(ArithLogic & logic, RewriteMemo * memo = nullptr)
+        : Rewriter<CardinalityConfig>(logic, config, memo),
+          config(logic) {}
+
+private:
+    CardinalityConfig config;
+};
+} // namespace opensmt
+
+#endif // OPENSMT_CARDINALITYREWRITER_H
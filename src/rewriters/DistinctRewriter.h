@@ -61,7 +61,9 @@ private:
 
 class DistinctRewriter : public Rewriter<DistinctRewriteConfig> {
 public:
-    DistinctRewriter(Logic & logic) : Rewriter<DistinctRewriteConfig>(logic, config), config(logic) {}
+    DistinctRewriter(Logic & logic, RewriteMemo * memo = nullptr)
+        : Rewriter<DistinctRewriteConfig>(logic, config, memo),
+          config(logic) {}
 
 private:
     DistinctRewriteConfig config;
@@ -117,7 +117,12 @@ private:
 
 class DivModRewriter : Rewriter<DivModConfig> {
 public:
-    explicit DivModRewriter(ArithLogic & logic) : Rewriter<DivModConfig>(logic, config), logic(logic), config(logic) {}
+    // With a memo, the definitions of the div and mod terms rewritten by previous calls are not repeated; they must have
+    // been asserted already
+    explicit DivModRewriter(ArithLogic & logic, RewriteMemo * memo = nullptr)
+        : Rewriter<DivModConfig>(logic, config, memo),
+          logic(logic),
+          config(logic) {}
 
     PTRef rewrite(PTRef term) override {
         if (term == PTRef_Undef or not logic.hasSortBool(term)) {
@@ -12,16 +12,63 @@
 #include <logics/Logic.h>
 
 namespace opensmt {
+/**
+ * Results of rewriting kept between the calls of Rewriter::rewrite, so that the subterms rewritten by an earlier call
+ * are not traversed again. It is only valid for configurations whose rewrite of a term is the same in every call.
+ *
+ * The entries are scoped: pop removes the entries added since the matching push, so that the memo can follow the
+ * assertion frames of a solver.
+ */
+class RewriteMemo {
+public:
+    bool peek(PTRef term, PTRef & result) {
+        ++lookups;
+        bool found = results.peek(term, result);
+        hits += found;
+        return found;
+    }
+
+    void insert(PTRef term, PTRef result) {
+        results.insert(term, result);
+        added.push(term);
+    }
+
+    void push() { limits.push(added.size()); }
+
+    void pop() {
+        assert(limits.size() > 0);
+        int limit = limits.last();
+        limits.pop();
+        for (int i = limit; i < added.size(); ++i) {
+            results.remove(added[i]);
+        }
+        added.shrink(added.size() - limit);
+    }
+
+    int size() const { return added.size(); }
+    std::size_t getLookups() const { return lookups; }
+    std::size_t getHits() const { return hits; }
+    double hitRate() const { return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups); }
+
+private:
+    Map<PTRef, PTRef, PTRefHash> results;
+    vec<PTRef> added;
+    vec<int> limits;
+    std::size_t lookups = 0;
+    std::size_t hits = 0;
+};
+
 /**
  * Defines a base class for rewriting terms.
  * Custom rewriters can be obtained by providing a config which defines local rewrites.
  * This base class takes care of propagating the local rewrites to the root of the term structure
  * and ensures that each subterm is visited only once.
+ * With a RewriteMemo, the subterms rewritten by previous calls are not visited at all.
  */
 template<typename TConfig>
 class Rewriter {
 public:
-    Rewriter(Logic & logic, TConfig & cfg) : logic(logic), cfg(cfg) {}
+    Rewriter(Logic & logic, TConfig & cfg, RewriteMemo * memo = nullptr) : logic(logic), cfg(cfg), memo(memo) {}
 
     virtual PTRef rewrite(PTRef root) {
         // MB: If term has no children then single call to config is enough;
@@ -50,6 +97,13 @@ public:
             assert(not termMarks.isMarked(currentId));
             Pterm const & term = logic.getPterm(currentRef);
             unsigned childrenCount = term.size();
+            PTRef memoized;
+            if (memo and currentEntry.nextChild == 0 and childrenCount > 0 and memo->peek(currentRef, memoized)) {
+                if (memoized != currentRef) { substitutions.insert(currentRef, memoized); }
+                termMarks.mark(currentId);
+                toProcess.pop_back();
+                continue;
+            }
             if (currentEntry.nextChild < childrenCount) {
                 PTRef nextChild = term[currentEntry.nextChild];
                 ++currentEntry.nextChild;
@@ -78,6 +132,7 @@ public:
                 assert(logic.getSortRef(currentRef) == logic.getSortRef(rewritten));
                 substitutions.insert(currentRef, rewritten);
             }
+            if (memo and childrenCount > 0) { memo->insert(currentRef, rewritten); }
             termMarks.mark(currentId);
             toProcess.pop_back();
         }
@@ -90,6 +145,7 @@ public:
 protected:
     Logic & logic;
     TConfig & cfg;
+    RewriteMemo * memo;
 };
 
 class DefaultRewriterConfig {
@@ -6,14 +6,15 @@
  */
 
 #include "Rewritings.h"
+#include "CardinalityRewriter.h"
 #include "DistinctRewriter.h"
 #include "DivModRewriter.h"
 
 #include <common/TreeOps.h>
 
 namespace opensmt {
-PTRef rewriteDistincts(Logic & logic, PTRef fla) {
-    return DistinctRewriter(logic).rewrite(fla);
+PTRef rewriteDistincts(Logic & logic, PTRef fla, RewriteMemo * memo) {
+    return DistinctRewriter(logic, memo).rewrite(fla);
 }
 
 PTRef rewriteDistinctsKeepTopLevel(Logic & logic, PTRef fla) {
@@ -25,8 +26,12 @@ PTRef rewriteDistinctsKeepTopLevel(Logic & logic, PTRef fla) {
     return KeepTopLevelDistinctRewriter(logic, std::move(topLevelDistincts)).rewrite(fla);
 }
 
-PTRef rewriteDivMod(ArithLogic & logic, PTRef term) {
-    return DivModRewriter(logic).rewrite(term);
+PTRef rewriteDivMod(ArithLogic & logic, PTRef term, RewriteMemo * memo) {
+    return DivModRewriter(logic, memo).rewrite(term);
+}
+
+PTRef rewriteCardinalities(ArithLogic & logic, PTRef fla, RewriteMemo * memo) {
+    return CardinalityRewriter(logic, memo).rewrite(fla);
 }
 
 std::optional<PTRef> tryGetOriginalDivModTerm(ArithLogic & logic, PTRef tr) {
@@ -14,13 +14,18 @@
 #include <optional>
 
 namespace opensmt {
-PTRef rewriteDistincts(Logic & logic, PTRef fla);
+class RewriteMemo;
+
+PTRef rewriteDistincts(Logic & logic, PTRef fla, RewriteMemo * memo = nullptr);
 
 PTRef rewriteDistinctsKeepTopLevel(Logic & logic, PTRef fla);
 
-PTRef rewriteDivMod(ArithLogic & logic, PTRef fla);
+PTRef rewriteDivMod(ArithLogic & logic, PTRef fla, RewriteMemo * memo = nullptr);
 
 std::optional<PTRef> tryGetOriginalDivModTerm(ArithLogic & logic, PTRef term);
+
+// Encodes the inequalities over sums of numeric ites with constant branches as Boolean formulas over their conditions
+PTRef rewriteCardinalities(ArithLogic & logic, PTRef fla, RewriteMemo * memo = nullptr);
 } // namespace opensmt
 
 #endif // OPENSMT_REWRITINGS_H
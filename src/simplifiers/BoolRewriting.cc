@@ -6,8 +6,14 @@
 
 #include <logics/Logic.h>
 
-#include <unordered_set>
 #include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <exception>
+#include <new>
+#include <optional>
+#include <thread>
+#include <unordered_set>
 
 namespace opensmt {
 
@@ -73,6 +79,203 @@ PTRef rewriteMaxArityClassic(Logic & logic, PTRef root) {
             });
 }
 
+std::vector<vec<PTRef>> independentConjuncts(Logic const & logic, PTRef root) {
+    vec<PTRef> conjuncts;
+    if (logic.isAnd(root)) {
+        for (PTRef conjunct : logic.getPterm(root)) {
+            conjuncts.push(conjunct);
+        }
+    } else {
+        conjuncts.push(root);
+    }
+    // Union-find over the conjuncts; a term belongs to the first conjunct that reaches it
+    std::vector<uint32_t> parent(conjuncts.size_());
+    for (uint32_t i = 0; i < parent.size(); i++) {
+        parent[i] = i;
+    }
+    auto find = [&parent](uint32_t i) {
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
+        }
+        return i;
+    };
+    constexpr uint32_t noOwner = UINT32_MAX;
+    std::vector<uint32_t> owner(Idx(logic.getPterm(root).getId()) + 1, noOwner);
+    vec<PTRef> queue;
+    for (uint32_t i = 0; i < parent.size(); i++) {
+        queue.push(conjuncts[i]);
+        while (queue.size() > 0) {
+            PTRef tr = queue.last();
+            queue.pop();
+            if (logic.isConstant(tr)) { continue; }
+            uint32_t & termOwner = owner[Idx(logic.getPterm(tr).getId())];
+            if (termOwner == noOwner) {
+                termOwner = i;
+                for (PTRef child : logic.getPterm(tr)) {
+                    queue.push(child);
+                }
+            } else {
+                uint32_t a = find(i);
+                uint32_t b = find(termOwner);
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+    std::vector<vec<PTRef>> groups;
+    std::vector<uint32_t> groupOf(parent.size(), noOwner);
+    for (uint32_t i = 0; i < parent.size(); i++) {
+        uint32_t representative = find(i);
+        if (groupOf[representative] == noOwner) {
+            groupOf[representative] = static_cast<uint32_t>(groups.size());
+            groups.emplace_back();
+        }
+        groups[groupOf[representative]].push(conjuncts[i]);
+    }
+    return groups;
+}
+
+namespace {
+// Runs task(i) for i from 0 to count - 1 on the given number of threads, the calling thread included
+template<typename TTask>
+void runInParallel(unsigned threads, std::size_t count, TTask task) {
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto work = [&]() {
+        for (std::size_t i = next++; i < count and not failed; i = next++) {
+            try {
+                task(i);
+            } catch (...) {
+                if (not failed.exchange(true)) { error = std::current_exception(); }
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < std::min<std::size_t>(threads, count); t++) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto & worker : workers) {
+        worker.join();
+    }
+    if (error) { std::rethrow_exception(error); }
+}
+
+struct RewriteBounds {
+    std::size_t terms = 0;
+    std::size_t args = 0;
+};
+
+// Bounds on the terms and arguments rewriteMaxArityClassic creates for the conjunction of the conjuncts: it builds at
+// most a few terms per Boolean operator, each with at most the arguments of its flattened section
+RewriteBounds maxArityRewriteBounds(Logic const & logic, vec<PTRef> const & conjuncts) {
+    std::unordered_map<PTRef, uint32_t, PTRefHash> incoming;
+    std::vector<PTRef> operators;
+    vec<PTRef> queue;
+    for (PTRef conjunct : conjuncts) {
+        queue.push(conjunct);
+    }
+    while (queue.size() > 0) {
+        PTRef tr = queue.last();
+        queue.pop();
+        if (incoming[tr]++ > 0 or not logic.isBooleanOperator(tr)) { continue; }
+        operators.push_back(tr);
+        for (PTRef child : logic.getPterm(tr)) {
+            queue.push(child);
+        }
+    }
+    // Children have smaller ids than their parents
+    std::sort(operators.begin(), operators.end(), [&logic](PTRef a, PTRef b) {
+        return Idx(logic.getPterm(a).getId()) < Idx(logic.getPterm(b).getId());
+    });
+    std::unordered_map<PTRef, std::size_t, PTRefHash> flattened;
+    RewriteBounds bounds{2, 2 * static_cast<std::size_t>(conjuncts.size())};
+    for (PTRef tr : operators) {
+        std::size_t size = 0;
+        for (PTRef child : logic.getPterm(tr)) {
+            auto it = flattened.find(child);
+            size += it != flattened.end() and incoming[child] == 1 ? it->second : 1;
+        }
+        flattened.emplace(tr, size);
+        bounds.terms += 3;
+        bounds.args += 2 * (size + logic.getPterm(tr).size()) + 2;
+    }
+    return bounds;
+}
+
+// Aborts the concurrent construction unless it was ended, e.g., when a worker threw
+class ConcurrentConstruction {
+public:
+    ConcurrentConstruction(Logic & logic, RewriteBounds bounds) : logic(logic) {
+        logic.beginConcurrentConstruction(bounds.terms, bounds.args);
+    }
+    ~ConcurrentConstruction() {
+        if (not ended) { logic.abortConcurrentConstruction(); }
+    }
+    ConcurrentConstruction(ConcurrentConstruction const &) = delete;
+    ConcurrentConstruction & operator=(ConcurrentConstruction const &) = delete;
+
+    void end(vec<PTRef> & results) {
+        logic.endConcurrentConstruction(results);
+        ended = true;
+    }
+
+private:
+    Logic & logic;
+    bool ended = false;
+};
+
+void rewriteGroupsInParallel(Logic & logic, std::vector<vec<PTRef>> const & groups, unsigned threads,
+                             std::size_t maxNewTerms, vec<PTRef> & results) {
+    std::vector<RewriteBounds> bounds(groups.size());
+    runInParallel(threads, groups.size(), [&](std::size_t i) { bounds[i] = maxArityRewriteBounds(logic, groups[i]); });
+    RewriteBounds total;
+    for (RewriteBounds const & groupBounds : bounds) {
+        total.terms += groupBounds.terms;
+        total.args += groupBounds.args;
+    }
+    total.terms = std::min(total.terms, maxNewTerms);
+
+    // Each group builds its terms under its own index, so that they can be put in the order of the groups afterwards
+    results.growTo(static_cast<int>(groups.size()), PTRef_Undef);
+    ConcurrentConstruction construction(logic, total);
+    runInParallel(threads, groups.size(), [&](std::size_t i) {
+        logic.setConcurrentGroup(static_cast<uint32_t>(i));
+        PTRef conjunction = logic.mkAnd(groups[i]);
+        results[static_cast<int>(i)] =
+            logic.isBooleanOperator(conjunction) ? rewriteMaxArityClassic(logic, conjunction) : conjunction;
+    });
+    construction.end(results);
+}
+} // namespace
+
+PTRef rewriteMaxArityParallel(Logic & logic, PTRef root, unsigned threads, std::size_t maxNewTerms) {
+    std::vector<vec<PTRef>> groups = independentConjuncts(logic, root);
+    if (groups.size() <= 1) { return rewriteMaxArityClassic(logic, root); }
+
+    vec<PTRef> results;
+    try {
+        rewriteGroupsInParallel(logic, groups, threads, maxNewTerms, results);
+    } catch (OutOfMemoryException const &) {
+        // The terms did not fit the reserved capacity, and those built so far are dropped
+        return rewriteMaxArityClassic(logic, root);
+    } catch (std::bad_alloc const &) {
+        return rewriteMaxArityClassic(logic, root);
+    }
+
+    vec<PTRef> args;
+    for (PTRef result : results) {
+        if (logic.isAnd(result)) {
+            for (PTRef arg : logic.getPterm(result)) {
+                args.push(arg);
+            }
+        } else {
+            args.push(result);
+        }
+    }
+    return logic.mkAnd(std::move(args));
+}
+
 PTRef rewriteMaxArityAggresive(Logic & logic, PTRef root) {
     return rewriteMaxArity(logic, root,
                     [](PTRef) { return false;});
@@ -329,4 +532,195 @@ PTRef simplifyUnderAssignment_Aggressive(PTRef root, Logic & logic) {
     return simplifyUnderAssignment_Aggressive(root, logic, idom, assignments, cache);
 }
 
+namespace {
+constexpr unsigned sweepMaxSupport = 8;
+using TruthTable = std::bitset<1u << sweepMaxSupport>;
+
+// A Boolean function of the atoms in its support, which is sorted and has only the atoms the function depends on
+struct SweptFunction {
+    std::vector<PTRef> support;
+    TruthTable table; // Bit a is the value when each support[j] has the value of bit j of a
+
+    bool operator==(SweptFunction const & other) const { return support == other.support and table == other.table; }
+};
+
+struct SweptFunctionHash {
+    std::size_t operator()(SweptFunction const & f) const {
+        std::size_t h = std::hash<TruthTable>{}(f.table);
+        for (PTRef atom : f.support) {
+            h = h * 31 + atom.x;
+        }
+        return h;
+    }
+};
+
+enum class Connective { And, Or, Not, Xor, Implies, Iff, Ite };
+
+std::optional<Connective> getConnective(Logic const & logic, PTRef tr) {
+    if (logic.isAnd(tr)) { return Connective::And; }
+    if (logic.isOr(tr)) { return Connective::Or; }
+    if (logic.isNot(tr)) { return Connective::Not; }
+    if (logic.isXor(tr)) { return Connective::Xor; }
+    if (logic.isImplies(tr)) { return Connective::Implies; }
+    if (logic.isIff(tr)) { return Connective::Iff; }
+    if (logic.isIte(tr) and logic.hasSortBool(tr)) { return Connective::Ite; }
+    return std::nullopt;
+}
+
+bool evaluate(Connective connective, std::vector<bool> const & args) {
+    switch (connective) {
+        case Connective::And:
+            return std::all_of(args.begin(), args.end(), [](bool b) { return b; });
+        case Connective::Or:
+            return std::any_of(args.begin(), args.end(), [](bool b) { return b; });
+        case Connective::Not:
+            return not args[0];
+        case Connective::Xor:
+            return std::count(args.begin(), args.end(), true) % 2 == 1;
+        case Connective::Implies:
+            // Right associative: the last argument or the negation of any of the others
+            return args.back() or std::any_of(args.begin(), args.end() - 1, [](bool b) { return not b; });
+        case Connective::Iff:
+            return std::adjacent_find(args.begin(), args.end(), std::not_equal_to<>()) == args.end();
+        case Connective::Ite:
+            return args[0] ? args[1] : args[2];
+    }
+    assert(false);
+    return false;
+}
+
+TruthTable fullTable(std::size_t supportSize) {
+    TruthTable table;
+    for (unsigned a = 0; a < (1u << supportSize); ++a) {
+        table.set(a);
+    }
+    return table;
+}
+
+// Drops the atoms the function does not depend on
+void reduce(SweptFunction & f) {
+    for (std::size_t j = f.support.size(); j-- > 0;) {
+        unsigned const size = 1u << f.support.size();
+        unsigned const bit = 1u << j;
+        bool depends = false;
+        for (unsigned a = 0; a < size and not depends; ++a) {
+            depends = (a & bit) == 0 and f.table[a] != f.table[a | bit];
+        }
+        if (depends) { continue; }
+        TruthTable reduced;
+        for (unsigned a = 0; a < size / 2; ++a) {
+            reduced[a] = f.table[((a & ~(bit - 1)) << 1) | (a & (bit - 1))];
+        }
+        f.table = reduced;
+        f.support.erase(f.support.begin() + static_cast<std::ptrdiff_t>(j));
+    }
+}
+
+// The post-order of the Boolean structure of root, whose leaves are the atoms
+std::vector<PTRef> getBooleanPostOrder(Logic const & logic, PTRef root) {
+    std::vector<PTRef> order;
+    std::unordered_set<PTRef, PTRefHash> visited;
+    std::vector<std::pair<PTRef, bool>> stack{{root, false}};
+    while (not stack.empty()) {
+        auto [tr, expanded] = stack.back();
+        stack.pop_back();
+        if (expanded) {
+            order.push_back(tr);
+            continue;
+        }
+        if (not visited.insert(tr).second) { continue; }
+        stack.emplace_back(tr, true);
+        if (not getConnective(logic, tr)) { continue; }
+        Pterm const & term = logic.getPterm(tr);
+        for (int i = term.size() - 1; i >= 0; --i) {
+            if (not visited.count(term[i])) { stack.emplace_back(term[i], false); }
+        }
+    }
+    return order;
+}
+} // namespace
+
+PTRef sweepEquivalentSubformulas(Logic & logic, PTRef root) {
+    std::unordered_map<PTRef, SweptFunction, PTRefHash> functions;
+    std::unordered_map<SweptFunction, PTRef, SweptFunctionHash> representatives;
+    std::unordered_map<PTRef, PTRef, PTRefHash> rewritten;
+
+    for (PTRef tr : getBooleanPostOrder(logic, root)) {
+        auto connective = getConnective(logic, tr);
+        std::optional<SweptFunction> function;
+        if (logic.isTrue(tr) or logic.isFalse(tr)) {
+            function = SweptFunction{{}, TruthTable(logic.isTrue(tr) ? 1 : 0)};
+        } else if (not connective) {
+            function = SweptFunction{{tr}, TruthTable(0b10)};
+        } else {
+            Pterm const & term = logic.getPterm(tr);
+            std::vector<SweptFunction const *> args;
+            std::vector<PTRef> support;
+            for (PTRef child : term) {
+                auto it = functions.find(child);
+                if (it == functions.end()) { break; }
+                args.push_back(&it->second);
+                support.insert(support.end(), it->second.support.begin(), it->second.support.end());
+            }
+            std::sort(support.begin(), support.end(), [](PTRef a, PTRef b) { return a.x < b.x; });
+            support.erase(std::unique(support.begin(), support.end()), support.end());
+            if (args.size() == static_cast<std::size_t>(term.size()) and support.size() <= sweepMaxSupport) {
+                // The positions of the atoms of each argument in the support of this term
+                std::vector<std::vector<unsigned>> positions;
+                for (auto const * arg : args) {
+                    auto & argPositions = positions.emplace_back();
+                    for (PTRef atom : arg->support) {
+                        auto it = std::lower_bound(support.begin(), support.end(), atom,
+                                                   [](PTRef a, PTRef b) { return a.x < b.x; });
+                        argPositions.push_back(static_cast<unsigned>(it - support.begin()));
+                    }
+                }
+                function = SweptFunction{std::move(support), {}};
+                std::vector<bool> values(args.size());
+                for (unsigned a = 0; a < (1u << function->support.size()); ++a) {
+                    for (std::size_t i = 0; i < args.size(); ++i) {
+                        unsigned index = 0;
+                        for (std::size_t j = 0; j < positions[i].size(); ++j) {
+                            if ((a >> positions[i][j]) & 1) { index |= 1u << j; }
+                        }
+                        values[i] = args[i]->table[index];
+                    }
+                    function->table[a] = evaluate(*connective, values);
+                }
+                reduce(*function);
+            }
+        }
+
+        PTRef result = PTRef_Undef;
+        if (function) {
+            if (function->support.empty()) {
+                result = function->table[0] ? logic.getTerm_true() : logic.getTerm_false();
+            } else if (auto it = representatives.find(*function); it != representatives.end()) {
+                result = it->second;
+            } else {
+                SweptFunction complement{function->support, ~function->table & fullTable(function->support.size())};
+                if (auto cit = representatives.find(complement); cit != representatives.end()) {
+                    result = logic.mkNot(cit->second);
+                }
+            }
+        }
+        if (result == PTRef_Undef) {
+            result = tr;
+            if (connective) {
+                vec<PTRef> args;
+                bool changed = false;
+                for (PTRef child : logic.getPterm(tr)) {
+                    args.push(rewritten.at(child));
+                    changed |= args.last() != child;
+                }
+                if (changed) { result = logic.insertTerm(logic.getSymRef(tr), std::move(args)); }
+            }
+            if (function) { representatives.emplace(*function, result); }
+        }
+        rewritten.emplace(tr, result);
+        if (function) { functions.emplace(tr, std::move(*function)); }
+    }
+    return rewritten.at(root);
+}
+
 }
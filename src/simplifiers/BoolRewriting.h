@@ -8,6 +8,7 @@
 #include <pterms/PTRef.h>
 #include <logics/Logic.h>
 
+#include <limits>
 #include <vector>
 #include <unordered_map>
 
@@ -19,10 +20,27 @@ PTRef rewriteMaxArityAggresive(Logic & logic, PTRef root);
 
 PTRef rewriteMaxArityClassic(Logic & logic, PTRef root);
 
+// Partitions the top-level conjuncts of root into groups that share no subterms except for constants. The groups are
+// ordered by their first conjunct, and the conjuncts keep their order within a group.
+std::vector<vec<PTRef>> independentConjuncts(Logic const & logic, PTRef root);
+
+// Like rewriteMaxArityClassic, but the independent groups of top-level conjuncts are rewritten on the given number of
+// threads. The result, including the references of the new terms, does not depend on the number of threads. Room for
+// at most maxNewTerms terms is reserved for the threads; if they run out of it, or it cannot be reserved, the terms
+// they built are dropped and root is rewritten with rewriteMaxArityClassic instead.
+PTRef rewriteMaxArityParallel(Logic & logic, PTRef root, unsigned threads,
+                              std::size_t maxNewTerms = std::numeric_limits<std::size_t>::max());
+
 PTRef simplifyUnderAssignment(Logic & logic, PTRef root);
 
 PTRef simplifyUnderAssignment_Aggressive(PTRef root, Logic & logic);
 
+// Merges the Boolean subformulas of root that are equivalent when its atoms are taken as propositional variables. Every
+// subformula over a few atoms gets its truth table, reduced to the atoms it depends on, so the tables are canonical like
+// reduced ordered BDDs. The subformulas with equal tables are replaced by the first of them, those with complementary
+// tables by its negation, and the constant ones by true or false.
+PTRef sweepEquivalentSubformulas(Logic & logic, PTRef root);
+
 std::vector<PTRef> getPostOrder(PTRef root, Logic& logic);
 
 std::unordered_map<PTRef, PTRef, PTRefHash> getImmediateDominators(PTRef root, Logic & logic);
@@ -51,6 +51,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <common/ReportUtils.h>
 #include <common/SystemQueries.h>
 #include <models/ModelBuilder.h>
+#include <smtsolvers/ProofTrace.h>
 #include <smtsolvers/ResolutionProof.h>
 
 #include <cmath>
@@ -147,6 +148,9 @@ CoreSMTSolver::initialize()
     if (config.produce_proof() && !resolutionProof) {
         resolutionProof = std::make_unique<ResolutionProof>(this->ca);
     }
+    if (not config.proof_trace().empty() && !proofTrace) {
+        proofTrace = std::make_unique<ProofTraceWriter>(config.proof_trace());
+    }
 
     init = true;
 }
@@ -237,6 +241,7 @@ bool CoreSMTSolver::addOriginalClause_(vec<Lit> && ps, pair<CRef, CRef> & inOutC
     assert(decisionLevel() == 0);
     inOutCRefs = {CRef_Undef, CRef_Undef};
     if (!isOK()) { return false; }
+    if (tracesProof()) { proofTrace->input(ps); }
     bool logProof = this->logsResolutionProof();
     // Check if clause is satisfied and remove false/duplicate literals:
     sort(ps);
@@ -285,6 +290,7 @@ bool CoreSMTSolver::addOriginalClause_(vec<Lit> && ps, pair<CRef, CRef> & inOutC
         }
     }
     if (ps.size() == 0) {
+        if (tracesProof()) { traceRefutation({}); }
         return ok = false;
     }
     if (ps.size() == 1)
@@ -295,6 +301,7 @@ bool CoreSMTSolver::addOriginalClause_(vec<Lit> && ps, pair<CRef, CRef> & inOutC
         uncheckedEnqueue(ps[0], reasonForAssignment);
         CRef confl = propagate();
         ok = (confl == CRef_Undef);
+        if (not ok and tracesProof()) { traceRefutation({}); }
         return ok;
     }
     else
@@ -344,14 +351,18 @@ void CoreSMTSolver::detachClause(CRef cr, bool strict)
 void CoreSMTSolver::removeClause(CRef cr)
 {
     Clause& c = ca[cr];
+    if (tracesProof()) {
+        // The checker does not keep the trail, so the literal implied at level 0 must outlive its reason
+        if (locked(c) and level(var(c[0])) == 0) { proofTrace->addition(vec<Lit>{c[0]}); }
+        proofTrace->deletion(c);
+    }
     detachClause(cr);
     // Don't leave pointers to free'd memory!
     if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
     c.mark(1);
     if (logsResolutionProof()) {
-        // Remove clause and derivations if ref becomes 0
-        // If ref is not 0, we keep it and remove later
-        if (!resolutionProof->deleted(cr)) pleaves.push(cr);
+        // The proof frees the clause once no derivation uses it
+        resolutionProof->clauseRemoved(cr);
     }
     else {
         ca.free(cr);
@@ -669,6 +680,7 @@ void CoreSMTSolver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 #ifdef STATISTICS
             tsolvers_time += cpuTime( ) - start;
 #endif
+            if (tracesProof()) { traceTheoryLemma(r); }
 
             CRef ctr = CRef_Undef;
             if (r.size() > config.sat_learn_up_to_size)
@@ -806,9 +818,11 @@ void CoreSMTSolver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         seen[var(l)] = 0;
     } // ('seen[]' is now cleared)
     assert(std::all_of(seen.begin(), seen.end(), [](char c) { return c == 0; }));
+    if (tracesProof()) { proofTrace->addition(out_learnt); }
     // Cleanup generated lemmata
     if (not logProof) {
         for (CRef cref : cleanup) {
+            if (tracesProof()) { proofTrace->deletion(ca[cref]); }
             ca.free(cref);
         }
     }
@@ -848,6 +862,7 @@ bool CoreSMTSolver::litRedundant(Lit p, uint32_t abstract_levels)
             theory_handler.getReason(p, r);
             // Restoring trail
             cancelUntilVarTempDone( );
+            if (tracesProof()) { traceTheoryLemma(r); }
             CRef ct = CRef_Undef;
             if (r.size() > config.sat_learn_up_to_size)
             {
@@ -931,6 +946,17 @@ void CoreSMTSolver::finalizeResolutionProof(CRef finalConflict) {
 }
 
 
+void CoreSMTSolver::traceTheoryLemma(vec<Lit> const & lemma) {
+    assert(tracesProof());
+    proofTrace->theoryLemma(lemma, [this](Var v) { return theory_handler.getLogic().printTerm(theory_handler.varToTerm(v)); });
+}
+
+void CoreSMTSolver::traceRefutation(vec<Lit> const & failedAssumptions) {
+    assert(tracesProof());
+    proofTrace->addition(failedAssumptions);
+    proofTrace->flush();
+}
+
 CRef CoreSMTSolver::logUnitClauseDerivationAtLevelZero(CRef cref) {
     assert(logsResolutionProof() and decisionLevel() == 0);
     resolutionProof->beginChain(cref);
@@ -978,7 +1004,8 @@ void CoreSMTSolver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
         {
             if (reason(x) == CRef_Undef)
             {
-                if (assumptions_order.has(x)) {
+                // Below the assumptions there are no decisions, so these are exactly the assumptions
+                if (level(x) > 0) {
                     out_conflict.push(~trail[i]);
                     if (logsResolutionProof()) {
                         assert(level(x) > 0);
@@ -1002,6 +1029,7 @@ void CoreSMTSolver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
                         seen[var(r[j])] = 1;
                     }
                     cancelUntilVarTempDone();
+                    if (tracesProof()) { traceTheoryLemma(r); }
                     if (logsResolutionProof()) {
                         CRef theoryClause = ca.alloc(r);
                         vardata[x].reason = theoryClause;
@@ -1180,16 +1208,6 @@ void CoreSMTSolver::reduceDB()
     }
     learnts.shrink(i - j);
     checkGarbage();
-    if (logsResolutionProof()) {
-        // Remove unused leaves
-        // FIXME deal with theory lemmata when proofs will be extended to theories
-        for (i = j = 0; i < pleaves.size(); i++) {
-            CRef cr = pleaves[i];
-            assert(ca[cr].mark() == 1);
-            if (!resolutionProof->deleted(cr)) pleaves[j++] = pleaves[i];
-        }
-        pleaves.shrink(i - j);
-    }
 }
 
 
@@ -1229,8 +1247,10 @@ bool CoreSMTSolver::simplify()
 {
     assert(decisionLevel() == 0);
 
-    if (!ok || propagate() != CRef_Undef)
+    if (!ok || propagate() != CRef_Undef) {
+        if (ok and tracesProof()) { traceRefutation({}); }
         return ok = false;
+    }
 
     if (nAssigns() == simpDB_assigns || (simpDB_props > 0))
         return true;
@@ -1756,6 +1776,7 @@ void CoreSMTSolver::clearSearch()
 }
 
 lbool CoreSMTSolver::zeroLevelConflictHandler() {
+    if (tracesProof()) { traceRefutation(conflict); }
     ok = false;
     return l_False;
 }
@@ -1799,6 +1820,13 @@ void CoreSMTSolver::relocAll(ClauseAllocator& to)
     //
     for (int i = 0; i < clauses.size(); i++)
         ca.reloc(clauses[i], to);
+
+    // The clauses kept only for the proof:
+    //
+    if (logsResolutionProof()) {
+        resolutionProof->relocAll(to);
+        if (clauseRelocationCallback) { clauseRelocationCallback(ca); }
+    }
 }
 
 
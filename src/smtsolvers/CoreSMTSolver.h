@@ -55,6 +55,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <tsolvers/THandler.h>
 
 #include <cstdio>
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <sstream>
@@ -63,6 +64,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 namespace opensmt {
 
 class ResolutionProof;
+class ProofTraceWriter;
 class ModelBuilder;
 
 // Helper method to print Literal to a stream
@@ -145,6 +147,10 @@ public:
     void fillBooleanVars(ModelBuilder & modelBuilder);
 
     ResolutionProof const & getResolutionProof() const { assert(resolutionProof); return *resolutionProof; }
+    // Called when garbage collection moves the clauses of the proof; a kept clause cr is then at ca[cr].relocation()
+    void setClauseRelocationCallback(std::function<void(ClauseAllocator const & ca)> callback) {
+        clauseRelocationCallback = std::move(callback);
+    }
 
     // Resource contraints:
     //
@@ -444,6 +450,7 @@ public:
 	std::string printCnfLearnts  ();
 
     bool logsResolutionProof() const { return static_cast<bool>(resolutionProof); }
+    bool tracesProof() const { return static_cast<bool>(proofTrace); }
     void printResolutionProofSMT2(std::ostream &); // Print proof
 protected:
 
@@ -483,12 +490,19 @@ protected:
     //
     void finalizeResolutionProof(CRef finalConflict);
     std::unique_ptr<ResolutionProof> resolutionProof;                 // (Pointer to) ResolutionProof store
-    vec< CRef >         pleaves;                  // Store clauses that are still involved in the proof
+    std::function<void(ClauseAllocator const &)> clauseRelocationCallback;
 
     /// Given a clause that is unit under assigment at level 0, creates the actual unit clause and logs its derivation
     /// @returns CRef of the newly created unit clause
     /// Assumes that literal at index 0 is unassigned and all other literals are falsified by current assignment
     CRef logUnitClauseDerivationAtLevelZero(CRef);
+
+    //
+    // Proof trace, streamed to a file as the search goes (see ProofTrace.h)
+    //
+    std::unique_ptr<ProofTraceWriter> proofTrace;
+    void traceTheoryLemma(vec<Lit> const & lemma);
+    void traceRefutation(vec<Lit> const & failedAssumptions); // Their clause, empty if no assumptions are involved
     // End of proof production
 
     //
@@ -635,8 +649,6 @@ inline void CoreSMTSolver::claBumpActivity (Clause& c)
 inline void CoreSMTSolver::checkGarbage(void) { return checkGarbage(garbage_frac); }
 inline void CoreSMTSolver::checkGarbage(double gf)
 {
-    // FIXME Relocation not compatible at the moment with proof tracking
-    if (this->logsResolutionProof()) { return; }
     if (ca.wasted() > ca.size() * gf) {
         garbageCollect();
     }
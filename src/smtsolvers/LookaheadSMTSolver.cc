@@ -52,6 +52,7 @@ lbool LookaheadSMTSolver::solve_() {
         case LALoopRes::sat:
             return l_True;
         case LALoopRes::unsat: {
+            if (tracesProof()) { traceRefutation(conflict); }
             ok = false;
             return l_False;
         }
@@ -0,0 +1,244 @@
+#include "ProofTrace.h"
+
+#include <common/ApiException.h>
+
+#include <algorithm>
+
+namespace opensmt {
+
+ProofTraceWriter::ProofTraceWriter(std::string const & fileName) : out(fileName, std::ios::out | std::ios::binary) {
+    if (not out) { throw ApiException("Cannot open the proof trace file " + fileName); }
+}
+
+void ProofTraceWriter::declare(Var v, std::function<std::string(Var)> const & atomOf) {
+    if (static_cast<std::size_t>(v) >= declared.size()) { declared.resize(v + 1, false); }
+    if (declared[v]) { return; }
+    declared[v] = true;
+    out.put('v');
+    writeNumber(static_cast<uint32_t>(v));
+    std::string atom = atomOf(v);
+    out.write(atom.data(), static_cast<std::streamsize>(atom.size()));
+    out.put(0);
+}
+
+void ProofTraceWriter::writeNumber(uint32_t n) {
+    while (n >= 0x80) {
+        out.put(static_cast<char>((n & 0x7f) | 0x80));
+        n >>= 7;
+    }
+    out.put(static_cast<char>(n));
+}
+
+bool ProofTraceChecker::check(std::istream & in) {
+    std::vector<Lit> clause;
+    std::size_t record = 0;
+    for (int tag = in.get(); tag != std::char_traits<char>::eof(); tag = in.get(), ++record) {
+        if (tag == 'v') {
+            uint32_t v;
+            std::string atom;
+            if (not readNumber(in, v) or not std::getline(in, atom, '\0')) {
+                error = "truncated atom in record " + std::to_string(record);
+                return false;
+            }
+            if (v >= atoms.size()) { atoms.resize(v + 1); }
+            atoms[v] = std::move(atom);
+            continue;
+        }
+        if (not readClause(in, clause)) {
+            error = "truncated clause in record " + std::to_string(record);
+            return false;
+        }
+        switch (tag) {
+            case 'i':
+                ++stats.inputs;
+                addClause(clause);
+                break;
+            case 't':
+                ++stats.theoryLemmas;
+                if (lemmaCallback) {
+                    std::vector<std::string> lemmaAtoms;
+                    for (Lit l : clause) {
+                        lemmaAtoms.push_back(static_cast<std::size_t>(var(l)) < atoms.size() ? atoms[var(l)] : "");
+                    }
+                    lemmaCallback(clause, lemmaAtoms);
+                }
+                addClause(clause);
+                break;
+            case 'a':
+                ++stats.additions;
+                if (not implied(clause)) {
+                    error = "the clause added in record " + std::to_string(record) + " is not implied";
+                    return false;
+                }
+                addClause(clause);
+                if (clause.empty()) { refuted = true; }
+                break;
+            case 'd':
+                ++stats.deletions;
+                deleteClause(clause);
+                break;
+            default:
+                error = "unknown tag in record " + std::to_string(record);
+                return false;
+        }
+    }
+    return true;
+}
+
+bool ProofTraceChecker::readNumber(std::istream & in, uint32_t & n) {
+    n = 0;
+    for (unsigned shift = 0; shift < 32; shift += 7) {
+        int byte = in.get();
+        if (byte == std::char_traits<char>::eof()) { return false; }
+        n |= static_cast<uint32_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) { return true; }
+    }
+    return false;
+}
+
+bool ProofTraceChecker::readClause(std::istream & in, std::vector<Lit> & clause) {
+    clause.clear();
+    uint32_t n;
+    while (readNumber(in, n)) {
+        if (n == 0) { return true; }
+        if (n == 1) { return false; }
+        clause.push_back(mkLit(static_cast<Var>((n - 2) >> 1), (n - 2) & 1));
+    }
+    return false;
+}
+
+uint64_t ProofTraceChecker::hashOf(std::vector<Lit> const & sortedClause) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (Lit l : sortedClause) {
+        h = (h ^ static_cast<uint32_t>(toInt(l))) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+void ProofTraceChecker::ensureVar(Var v) {
+    std::size_t const size = 2 * (static_cast<std::size_t>(v) + 1);
+    if (values.size() < size) {
+        values.resize(size, 0);
+        watches.resize(size);
+    }
+}
+
+void ProofTraceChecker::addClause(std::vector<Lit> const & clause) {
+    std::vector<Lit> sorted(clause);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    if (sorted.empty()) {
+        hasEmptyClause = true;
+        return;
+    }
+    auto const id = static_cast<uint32_t>(clauses.size());
+    clauses.push_back({static_cast<uint32_t>(lits.size()), static_cast<uint32_t>(sorted.size()), false});
+    for (Lit l : sorted) {
+        ensureVar(var(l));
+        lits.push_back(l);
+    }
+    index[hashOf(sorted)].push_back(id);
+    if (sorted.size() == 1) {
+        units.push_back(id);
+    } else {
+        watches[toInt(sorted[0])].push_back(id);
+        watches[toInt(sorted[1])].push_back(id);
+    }
+}
+
+void ProofTraceChecker::deleteClause(std::vector<Lit> const & clause) {
+    std::vector<Lit> sorted(clause);
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    auto it = index.find(hashOf(sorted));
+    if (it != index.end()) {
+        auto & ids = it->second;
+        for (std::size_t i = 0; i < ids.size(); ++i) {
+            ClauseInfo & info = clauses[ids[i]];
+            // The watched literals of a clause may have been reordered, so compare as sets
+            if (info.size == sorted.size() and std::is_permutation(sorted.begin(), sorted.end(), lits.begin() + info.offset)) {
+                // Watches and units of deleted clauses are dropped lazily
+                info.deleted = true;
+                ids[i] = ids.back();
+                ids.pop_back();
+                return;
+            }
+        }
+    }
+    ++stats.unmatchedDeletions;
+}
+
+bool ProofTraceChecker::assign(Lit l) {
+    if (values[toInt(l)] != 0) { return values[toInt(l)] > 0; }
+    values[toInt(l)] = 1;
+    values[toInt(~l)] = -1;
+    trail.push_back(l);
+    return true;
+}
+
+bool ProofTraceChecker::propagate() {
+    for (std::size_t qhead = 0; qhead < trail.size(); ++qhead) {
+        Lit const falseLit = ~trail[qhead];
+        auto & ws = watches[toInt(falseLit)];
+        std::size_t i = 0, j = 0;
+        for (; i < ws.size(); ++i) {
+            uint32_t const id = ws[i];
+            ClauseInfo const & info = clauses[id];
+            if (info.deleted) { continue; }
+            Lit * c = lits.data() + info.offset;
+            if (c[0] == falseLit) { std::swap(c[0], c[1]); }
+            if (values[toInt(c[0])] > 0) {
+                ws[j++] = id;
+                continue;
+            }
+            bool moved = false;
+            for (uint32_t k = 2; k < info.size; ++k) {
+                if (values[toInt(c[k])] >= 0) {
+                    std::swap(c[1], c[k]);
+                    watches[toInt(c[1])].push_back(id);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) { continue; }
+            ws[j++] = id;
+            if (not assign(c[0])) {
+                for (++i; i < ws.size(); ++i) {
+                    ws[j++] = ws[i];
+                }
+                ws.resize(j);
+                return false;
+            }
+        }
+        ws.resize(j);
+    }
+    return true;
+}
+
+bool ProofTraceChecker::implied(std::vector<Lit> const & clause) {
+    if (hasEmptyClause) { return true; }
+    auto conflict = [&]() {
+        for (Lit l : clause) {
+            ensureVar(var(l));
+            if (not assign(~l)) { return true; }
+        }
+        std::size_t j = 0;
+        bool unitConflict = false;
+        for (uint32_t id : units) {
+            if (clauses[id].deleted) { continue; }
+            units[j++] = id;
+            unitConflict = unitConflict or not assign(lits[clauses[id].offset]);
+        }
+        units.resize(j);
+        return unitConflict or not propagate();
+    };
+    bool const result = conflict();
+    for (Lit l : trail) {
+        values[toInt(l)] = 0;
+        values[toInt(~l)] = 0;
+    }
+    trail.clear();
+    return result;
+}
+
+} // namespace opensmt
@@ -0,0 +1,130 @@
+#ifndef OPENSMT_PROOFTRACE_H
+#define OPENSMT_PROOFTRACE_H
+
+#include <minisat/core/SolverTypes.h>
+#include <minisat/mtl/Vec.h>
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace opensmt {
+
+/**
+ * A clausal proof trace in a binary format close to binary DRAT. The SAT solver writes it while it runs, so it needs no
+ * memory for the proof itself, unlike ResolutionProof.
+ *
+ * The trace is a sequence of records. A clause record is a tag byte followed by its literals and a terminating zero,
+ * where literal l is written as the number toInt(l) + 2 in the variable-length encoding of binary DRAT (seven bits per
+ * byte, least significant first, the high bit set on all bytes but the last). The tags are:
+ *
+ *  - 'i' an input clause;
+ *  - 'a' a clause implied by the clauses so far by reverse unit propagation;
+ *  - 'd' the deletion of a clause equal, up to the order of literals, to one added before;
+ *  - 't' a theory lemma, trusted by the checker; its negation is the conflicting explanation (a conjunction of PtAsgn)
+ *    the theory solvers gave for it;
+ *  - 'v' not a clause but the atom of a variable, written as the number of the variable in the same encoding followed by
+ *    the SMT-LIB text of the atom and a terminating zero byte. It precedes the first theory lemma that uses the variable.
+ *
+ * The solver ends an unsatisfiable query with an addition of the empty clause, or of the negated failed assumptions.
+ */
+class ProofTraceWriter {
+public:
+    explicit ProofTraceWriter(std::string const & fileName);
+
+    template<typename C> void input(C const & clause) { write('i', clause); }
+    template<typename C> void addition(C const & clause) { write('a', clause); }
+    template<typename C> void deletion(C const & clause) { write('d', clause); }
+    // The atoms of the variables are given by atomOf, which is called once per variable
+    template<typename C> void theoryLemma(C const & clause, std::function<std::string(Var)> const & atomOf) {
+        for (Lit l : clause) {
+            declare(var(l), atomOf);
+        }
+        write('t', clause);
+    }
+    void flush() { out.flush(); }
+
+private:
+    template<typename C> void write(char tag, C const & clause) {
+        out.put(tag);
+        for (Lit l : clause) {
+            writeNumber(static_cast<uint32_t>(toInt(l)) + 2);
+        }
+        out.put(0);
+    }
+    void declare(Var v, std::function<std::string(Var)> const & atomOf);
+    void writeNumber(uint32_t n);
+
+    std::ofstream out;
+    std::vector<bool> declared;
+};
+
+/**
+ * Checks a proof trace of ProofTraceWriter offline: every addition must follow from the clauses present at that point
+ * by reverse unit propagation. Input clauses and theory lemmas are taken as given.
+ */
+class ProofTraceChecker {
+public:
+    struct Stats {
+        std::size_t inputs = 0;
+        std::size_t additions = 0;
+        std::size_t deletions = 0;
+        std::size_t theoryLemmas = 0;
+        std::size_t unmatchedDeletions = 0; // Deletions of clauses that were not present; they are ignored
+    };
+
+    /**
+     * Reads and checks the whole trace.
+     *
+     * @return true if the trace is well-formed and all additions were verified; refutes() then tells whether the empty
+     * clause was derived. On false, getError() describes the first failure.
+     */
+    bool check(std::istream & in);
+
+    bool refutes() const { return refuted; }
+    Stats const & getStats() const { return stats; }
+    std::string const & getError() const { return error; }
+    // Called for each theory lemma with its clause and the atoms of its variables, e.g. to re-check it with another solver
+    void onTheoryLemma(std::function<void(std::vector<Lit> const &, std::vector<std::string> const &)> callback) {
+        lemmaCallback = std::move(callback);
+    }
+
+private:
+    struct ClauseInfo {
+        uint32_t offset;
+        uint32_t size;
+        bool deleted;
+    };
+
+    bool readClause(std::istream & in, std::vector<Lit> & clause);
+    bool readNumber(std::istream & in, uint32_t & n);
+    void addClause(std::vector<Lit> const & clause);
+    void deleteClause(std::vector<Lit> const & clause);
+    bool implied(std::vector<Lit> const & clause);
+    bool assign(Lit l);
+    bool propagate();
+    void ensureVar(Var v);
+    static uint64_t hashOf(std::vector<Lit> const & sortedClause);
+
+    std::vector<Lit> lits;
+    std::vector<ClauseInfo> clauses;
+    std::vector<std::vector<uint32_t>> watches; // Indexed by the literal that, when false, triggers the visit
+    std::vector<uint32_t> units;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> index;
+    std::vector<std::string> atoms;
+    std::vector<signed char> values; // Indexed by literals: 1 true, -1 false, 0 unassigned
+    std::vector<Lit> trail;
+    bool hasEmptyClause = false;
+    bool refuted = false;
+    Stats stats;
+    std::string error;
+    std::function<void(std::vector<Lit> const &, std::vector<std::string> const &)> lemmaCallback;
+};
+
+} // namespace opensmt
+
+#endif // OPENSMT_PROOFTRACE_H
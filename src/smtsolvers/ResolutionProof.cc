@@ -29,6 +29,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <common/InternalException.h>
 
+#include <algorithm>
 #include <unordered_map>
 
 
@@ -94,7 +95,8 @@ void ResolutionProof::endChain(CRef conclusion)
           this->newTheoryClause(conclusion);
       }
       assert( clause_to_proof_der.find( conclusion ) != clause_to_proof_der.end( ) );
-      // No need to update the chain already stored in the proof
+      // No need to update the chain already stored in the proof; the premise is not used by a new derivation
+      --clause_to_proof_der.at(premise).ref;
       current_chain.clear();
   }
   else {
@@ -111,28 +113,65 @@ void ResolutionProof::endChain(CRef conclusion)
   }
 }
 
-bool ResolutionProof::deleted(CRef cr)
+void ResolutionProof::clauseRemoved(CRef cr)
 {
-  // Never remove units
-  if ( cl_al[cr].size( ) == 1 ) return false;
-  assert( clause_to_proof_der.find( cr ) != clause_to_proof_der.end( ) );
-  const ResolutionProofDer& d = clause_to_proof_der[ cr ];
-  assert( d.ref >= 0 );
-  // This clause is still used somewhere else, keep it
-  if ( d.ref > 0 ) { return false; }
-  // No derivation uses this clause as an assumption, it is safe to remove its derivation.
-  // The assumption clauses are notified that there is one less derivation where they are used
-  for ( unsigned i = 0 ; i < d.chain_cla.size( ) ; i ++ )
-  {
-    assert( clause_to_proof_der.find( d.chain_cla[i] ) != clause_to_proof_der.end( ) );
-    ResolutionProofDer & parent = clause_to_proof_der.at(d.chain_cla[i]);
-    parent.ref--;
-  }
-  assert( d.ref == 0 );
-  clause_to_proof_der.erase( cr );
-  // The clause itself can be removed from Clause store
-  cl_al.free( cr );
-  return true;
+    assert(cl_al[cr].mark() == 1);
+    // Never remove units
+    if (cl_al[cr].size() == 1) { return; }
+    assert(clause_to_proof_der.find(cr) != clause_to_proof_der.end());
+    // This clause is still used somewhere else; it is erased with the last derivation that uses it
+    if (clause_to_proof_der.at(cr).ref > 0) { return; }
+    eraseDerivation(cr);
+}
+
+void ResolutionProof::eraseDerivation(CRef cr)
+{
+    std::vector<CRef> toErase{cr};
+    while (not toErase.empty()) {
+        CRef current = toErase.back();
+        toErase.pop_back();
+        auto it = clause_to_proof_der.find(current);
+        assert(it != clause_to_proof_der.end() and it->second.ref == 0);
+        // The premises are notified that there is one less derivation where they are used
+        for (CRef premise : it->second.chain_cla) {
+            ResolutionProofDer & premiseDer = clause_to_proof_der.at(premise);
+            assert(premiseDer.ref > 0);
+            Clause const & premiseClause = cl_al[premise];
+            bool removable = premiseClause.mark() == 1
+                             and (premiseClause.size() > 1 or premiseDer.type == clause_type::CLA_ASSUMPTION);
+            if (--premiseDer.ref == 0 and removable) { toErase.push_back(premise); }
+        }
+        clause_to_proof_der.erase(it);
+        // The clause itself can be removed from Clause store
+        if (current != CRef_Undef) { cl_al.free(current); }
+    }
+}
+
+void ResolutionProof::relocAll(ClauseAllocator & to)
+{
+    assert(not hasOpenChain());
+    // Move the clauses in the order of their old references, so that the new ones do not depend on the hashing
+    std::vector<CRef> clauses;
+    clauses.reserve(clause_to_proof_der.size());
+    for (auto const & entry : clause_to_proof_der) {
+        if (entry.first != CRef_Undef) { clauses.push_back(entry.first); }
+    }
+    std::sort(clauses.begin(), clauses.end());
+    for (CRef cr : clauses) {
+        cl_al.reloc(cr, to);
+    }
+    std::unordered_map<CRef, ResolutionProofDer> relocated;
+    relocated.reserve(clause_to_proof_der.size());
+    for (auto & [cr, derivation] : clause_to_proof_der) {
+        for (CRef & premise : derivation.chain_cla) {
+            premise = cl_al[premise].relocation();
+        }
+        relocated.emplace(cr == CRef_Undef ? CRef_Undef : cl_al[cr].relocation(), std::move(derivation));
+    }
+    clause_to_proof_der = std::move(relocated);
+    for (auto & entry : assumed_literals) {
+        entry.second = cl_al[entry.second].relocation();
+    }
 }
 
 void ResolutionProof::printSMT2(std::ostream & out, CoreSMTSolver & s, THandler & t) const
@@ -261,8 +300,9 @@ void ResolutionProof::printSMT2(std::ostream & out, CoreSMTSolver & s, THandler
 void ResolutionProof::cleanAssumedLiteral(Lit l) {
     CRef unit = assumed_literals.at(l);
     assert(clause_to_proof_der.find(unit) != clause_to_proof_der.end());
-    clause_to_proof_der.erase(unit);
-    cl_al.free(unit);
+    // A unit still used by a derivation is erased with the last such derivation
+    cl_al[unit].mark(1);
+    if (clause_to_proof_der.at(unit).ref == 0) { eraseDerivation(unit); }
 }
 
 //=============================================================================
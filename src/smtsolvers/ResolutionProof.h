@@ -137,7 +137,7 @@ public:
         for (auto const & entry : assumed_literals) {
             if (replacement.find(entry.first) == replacement.end()) {
                 if (entry.second == assumedUnitReason) {
-                    clause_to_proof_der.erase(emptyDerIt);
+                    eraseDerivation(CRef_Undef);
                 }
                 cleanAssumedLiteral(entry.first);
             }
@@ -152,7 +152,15 @@ public:
         return it->second;
     }
 
-    bool deleted(CRef);                             // Remove clauses if possible
+    /**
+     * Notifies the proof that the solver no longer uses the clause, which must be marked as removed. The clause and its
+     * derivation are freed as soon as no other derivation uses them, together with the premises that were only kept for
+     * this derivation. Unit clauses are always kept.
+     */
+    void clauseRemoved(CRef);
+
+    // Moves all the clauses of the proof to `to`; the clauses the solver relocated before keep their new references
+    void relocAll(ClauseAllocator & to);
     inline Clause& getClause(CRef cr) const { return cl_al[cr]; } // Get clause from reference
 
     void printSMT2(std::ostream &, CoreSMTSolver &, THandler &) const;     // Print proof in SMT-LIB format
@@ -171,6 +179,7 @@ public:
 private:
     // Helper methods
     void cleanAssumedLiteral(Lit l);
+    void eraseDerivation(CRef);
     void newLeafClause(CRef, clause_type t);
 };
 
@@ -25,6 +25,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 *********************************************************************/
 
 #include "CoreSMTSolver.h"
+#include "ProofTrace.h"
 #include "ResolutionProof.h"
 
 #include <tsolvers/TSolver.h>
@@ -96,6 +97,7 @@ TPropRes CoreSMTSolver::handleNewSplitClauses(SplitClauses & splitClauses) {
             if (value(l) == l_True) { ++satisfied; }
             else if (value(l) != l_False) { ++unknown; impliedIndex = i; }
         }
+        if (tracesProof()) { traceTheoryLemma(splitClause); }
         assert(satisfied != 0 or unknown != 0); // The clause cannot be falsified
         if (satisfied == 0 and unknown == 1) { // propagate
             // Find the lowest level where all the falsified literals are still falsified
@@ -179,23 +181,27 @@ CoreSMTSolver::handleSat()
             // Maybe do something someday?
         }
         CRef deducedReason = CRef_Fake;
-        if (decisionLevel() == 0 and logsResolutionProof()) {
+        if (decisionLevel() == 0 and (logsResolutionProof() or tracesProof())) {
+            // The reason is needed now, the deduction at level 0 is never undone
             vec<Lit> reasonLits;
             theory_handler.getReason(l, reasonLits);
             assert(reasonLits.size() > 0);
-            CRef theoryReason = ca.alloc(reasonLits);
-            CRef unit = ca.alloc(vec<Lit>{l});
-            resolutionProof->newTheoryClause(theoryReason);
-            resolutionProof->beginChain(theoryReason);
-            Clause const & clause = ca[theoryReason];
-            for (unsigned j = 0; j < clause.size(); ++j) {
-                if (clause[j] != l) {
-                    resolutionProof->addResolutionStep(reason(var(clause[j])), var(clause[j]));
+            if (tracesProof()) { traceTheoryLemma(reasonLits); }
+            if (logsResolutionProof()) {
+                CRef theoryReason = ca.alloc(reasonLits);
+                CRef unit = ca.alloc(vec<Lit>{l});
+                resolutionProof->newTheoryClause(theoryReason);
+                resolutionProof->beginChain(theoryReason);
+                Clause const & clause = ca[theoryReason];
+                for (unsigned j = 0; j < clause.size(); ++j) {
+                    if (clause[j] != l) {
+                        resolutionProof->addResolutionStep(reason(var(clause[j])), var(clause[j]));
+                    }
                 }
+                resolutionProof->endChain(unit);
+                vardata[var(l)].reason = unit;
+                deducedReason = unit;
             }
-            resolutionProof->endChain(unit);
-            vardata[var(l)].reason = unit;
-            deducedReason = unit;
         }
         uncheckedEnqueue(l, deducedReason);
     }
@@ -217,7 +223,7 @@ CoreSMTSolver::handleUnsat()
     // Reset skip step for uns calls
     skip_step = config.sat_initial_skip_step;
 
-    if (!logsResolutionProof()) {
+    if (!logsResolutionProof() and !tracesProof()) {
         // Top-level conflict, problem is T-Unsatisfiable
         if (decisionLevel() == 0) {
             return TPropRes::Unsat;
@@ -230,6 +236,7 @@ CoreSMTSolver::handleUnsat()
 
     theory_handler.getConflict(conflicting, vardata, max_decision_level);
     assert(std::none_of(conflicting.begin(), conflicting.end(), [this](Lit l) { return value(l) == l_Undef; }));
+    if (tracesProof()) { traceTheoryLemma(conflicting); }
 
     assert( max_decision_level <= decisionLevel( ) );
     cancelUntil( max_decision_level );
@@ -276,6 +283,7 @@ CoreSMTSolver::handleUnsat()
         // Get rid of the temporary lemma
         if (learnOnlyTemporary)
         {
+            if (tracesProof()) { proofTrace->deletion(ca[confl]); }
             ca.free(confl);
         }
     }
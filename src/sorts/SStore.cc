@@ -36,6 +36,17 @@ bool SStore::peek(SortSymbol const & symbol, SSymRef & outRef) const {
     return false;
 }
 
+bool SStore::peek(SSymRef symbolRef, vec<SRef> const & args, SRef & outRef) const {
+    vec<SRef> keyArgs;
+    args.copyTo(keyArgs);
+    auto it = sortTable.find(SortKey(symbolRef, std::move(keyArgs)));
+    if (it != sortTable.end()) {
+        outRef = it->second;
+        return true;
+    }
+    return false;
+}
+
 SSymRef SStore::newSortSymbol(SortSymbol symbol) {
     SSymRef res;
     assert(not peek(symbol, res));
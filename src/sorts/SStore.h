@@ -54,6 +54,7 @@ public:
     // Public APIs for sort construction/destruction
 
     bool peek(SortSymbol const & symbol, SSymRef & outRef) const;
+    bool peek(SSymRef symbolRef, vec<SRef> const & args, SRef & outRef) const;
     SSymRef newSortSymbol(SortSymbol symbol);
 
     Sort const & operator[](SRef sr) const { return sa[sr]; }
@@ -39,7 +39,7 @@ SymStore::~SymStore() {
         free(idToName[i]);
 }
 
-SymRef SymStore::newSymb(char const * fname, SRef rsort, vec<SRef> const & args, SymbolConfig const & symConfig) {
+SymRef SymStore::find(char const * fname, SRef rsort, vec<SRef> const & args, SymbolConfig const & symConfig) const {
     // Check if there already is a term called fname with same number of arguments of the same sort
     auto * symrefs = getRefOrNull(fname);
 
@@ -54,23 +54,66 @@ SymRef SymStore::newSymb(char const * fname, SRef rsort, vec<SRef> const & args,
             }
         }
     }
-    bool newsym = (symrefs == nullptr);
+    return SymRef_Undef;
+}
+
+SymRef SymStore::newSymb(char const * fname, SRef rsort, vec<SRef> const & args, SymbolConfig const & symConfig) {
+    SymRef existing = find(fname, rsort, args, symConfig);
+    if (existing != SymRef_Undef) { return existing; }
     SymRef tr = ta.alloc(rsort, args, symConfig);
     SymId id = symbols.size();
     symbols.push(tr);
 
-    char * tmp_name = strdup(fname);
-    idToName.push(tmp_name); // Map the id to name, used in error reporting
+    idToName.push(strdup(fname)); // Map the id to name, used in error reporting
     ta[tr].id = id; // Tell the term its id, used in error reporting, and checking whether two terms could be equal
                     // in future?
-    if (newsym) {
-        vec<SymRef> trs;
-        trs.push(tr);
-        symbolTable.insert(tmp_name, trs);
+    link(tr);
+    return tr;
+}
+
+void SymStore::rename(vec<SymRef> const & syms, std::vector<std::string> const & names) {
+    assert(static_cast<std::size_t>(syms.size()) == names.size());
+    // All the old names go first, so that a new name may be one of them
+    for (SymRef sr : syms) {
+        unlink(sr);
+        free(idToName[ta[sr].getId()]);
+    }
+    for (int i = 0; i < syms.size(); i++) {
+        idToName[ta[syms[i]].getId()] = strdup(names[i].c_str());
+        link(syms[i]);
+    }
+}
+
+void SymStore::forget(SymRef sr) {
+    unlink(sr);
+    SymId id = ta[sr].getId();
+    free(idToName[id]);
+    idToName[id] = nullptr;
+}
+
+void SymStore::link(SymRef sr) {
+    char * name = idToName[ta[sr].getId()];
+    if (symbolTable.has(name)) {
+        symbolTable[name].push(sr); // Map the name to term reference (why not id?), used in parsing
     } else {
-        symbolTable[tmp_name].push(tr); // Map the name to term reference (why not id?), used in parsing
+        vec<SymRef> trs;
+        trs.push(sr);
+        symbolTable.insert(name, trs);
     }
-    return tr;
+}
+
+void SymStore::unlink(SymRef sr) {
+    char const * name = getName(sr);
+    vec<SymRef> homonyms;
+    symbolTable.peek(name, homonyms);
+    // The key of the table is the name of one of the symbols, which may be this one
+    symbolTable.remove(name);
+    int kept = 0;
+    for (SymRef homonym : homonyms) {
+        if (homonym != sr) { homonyms[kept++] = homonym; }
+    }
+    homonyms.shrink(homonyms.size() - kept);
+    if (kept > 0) { symbolTable.insert(idToName[ta[homonyms[0]].getId()], homonyms); }
 }
 
 #ifdef PEDANTIC_DEBUG
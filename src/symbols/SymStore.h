@@ -30,6 +30,9 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <common/StringMap.h>
 
+#include <string>
+#include <vector>
+
 namespace opensmt {
 class SymStore {
 public:
@@ -39,11 +42,18 @@ public:
     SymStore & operator=(SymStore const &) = delete;
     SymStore(SymStore &&) = default;
     SymStore & operator=(SymStore &&) = default;
-    // Constructs a new symbol.
+    // Constructs a new symbol, unless there is one with the same name, sorts and configuration already.
     SymRef newSymb(char const * fname, SRef rsort, vec<SRef> const & args, SymbolConfig const & symConfig);
     SymRef newSymb(char const * fname, SRef rsort, vec<SRef> const & args) {
         return newSymb(fname, rsort, args, SymConf::Default);
     }
+    // The symbol newSymb would return without constructing a new one; SymRef_Undef if there is none
+    SymRef find(char const * fname, SRef rsort, vec<SRef> const & args, SymbolConfig const & symConfig) const;
+    // Gives the symbols the new names, which may be the old names of other symbols in syms
+    void rename(vec<SymRef> const & syms, std::vector<std::string> const & names);
+    // Drops the name of a symbol that is no longer used, so that it cannot be found anymore
+    void forget(SymRef sr);
+    bool isForgotten(SymRef sr) const { return idToName[ta[sr].getId()] == nullptr; }
     bool contains(char const * fname) const { return symbolTable.has(fname); }
     vec<SymRef> const & nameToRef(char const * s) const { return symbolTable[s]; }
     vec<SymRef> & nameToRef(char const * s) { return symbolTable[s]; }
@@ -55,6 +65,12 @@ public:
     char const * getName(SymRef tr) const { return idToName[ta[tr].getId()]; }
 
     vec<SymRef> const & getSymbols() const { return symbols; }
+    // Whether sr refers to a symbol of this store
+    bool isKnown(SymRef sr) const {
+        if (sr == SymRef_Undef or sr.x + sizeof(Symbol) / sizeof(uint32_t) > ta.size()) { return false; }
+        SymId id = ta[sr].getId();
+        return id < symbols.size_() and symbols[id] == sr;
+    }
 
     bool isInterpreted(SymRef sr) const { return ta[sr].isInterpreted(); }
 
@@ -63,6 +79,9 @@ public:
     void check() const;
 #endif
 private:
+    void link(SymRef sr);
+    void unlink(SymRef sr);
+
     static char const * e_duplicate_symbol;
     // For serialization
     static int const symstore_buf_offs_idx;
@@ -35,7 +35,21 @@ lbool UFLATHandler::getPolaritySuggestion(PTRef pt) const {
 
 TRes UFLATHandler::check(bool full) {
     auto res = TSolverHandler::check(full);
-    if (full and res == TRes::SAT and not lasolver->hasNewSplits() and (not arraySolver or not arraySolver->hasNewSplits())) {
+    auto noPendingSplits = [this]() {
+        return not lasolver->hasNewSplits() and (not arraySolver or not arraySolver->hasNewSplits());
+    };
+    // Merges done on behalf of the arithmetic may enable further reasoning in the other solvers, so they run again.
+    // Looking for them scans the whole LA state, which only pays off once per complete check that requested no splits;
+    // checking again with splits pending would request them twice.
+    while (full and res == TRes::SAT and noPendingSplits()) {
+        bool consistent = propagateImpliedEqualities();
+        auto absorbedRoots = ufsolver->takeRootsAbsorbedByImpliedMerges();
+        if (not consistent) { return TRes::UNSAT; }
+        if (absorbedRoots.empty()) { break; }
+        if (arraySolver) { arraySolver->egraphClassesMerged(absorbedRoots); }
+        res = TSolverHandler::check(full);
+    }
+    if (full and res == TRes::SAT and noPendingSplits()) {
         equalitiesToPropagate = ufsolver->collectEqualitiesFor(interfaceVars, equalitiesWithAddedInterfaceClauses);
         // MB: Only collect equalities from LASolver if there are none from UF solver.
         //  This prevents duplication of equalities
@@ -46,6 +60,20 @@ TRes UFLATHandler::check(bool full) {
     return res;
 }
 
+bool UFLATHandler::propagateImpliedEqualities() {
+    // Equalities implied by fixed bounds are merged in the Egraph directly, without new atoms and another round of search
+    for (auto & equality : lasolver->collectImpliedEqualitiesFor(interfaceVars)) {
+        if (not ufsolver->addImpliedEquality(equality.lhs, equality.rhs, std::move(equality.reason))) {
+            return false;
+        }
+    }
+    // Fixed differences let the Egraph equate terms at the same offset from a common term, e.g., f(x+1) and f(y) under y - x = 1
+    for (auto & relation : lasolver->collectOffsetRelationsFor(interfaceVars)) {
+        ufsolver->addOffsetRelation(relation.term, relation.base, std::move(relation.offset), std::move(relation.explain));
+    }
+    return ufsolver->propagateOffsetEqualities();
+}
+
 namespace {
     void addInterfaceClausesForEquality(ArithLogic & logic, PTRef eq, vec<PTRef> & clauses) {
         // create clauses corresponding to "x = y iff x >= y and x <= y"
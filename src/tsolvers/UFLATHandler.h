@@ -48,6 +48,8 @@ class UFLATHandler : public TSolverHandler
     vec<PTRef> interfaceVars;
     vec<PTRef> equalitiesToPropagate;
     std::unordered_set<PTRef, PTRefHash> equalitiesWithAddedInterfaceClauses;
+
+    bool propagateImpliedEqualities(); // Returns false if the Egraph became inconsistent
   public:
     UFLATHandler(SMTConfig & c, ArithLogic & l);
     Logic & getLogic() override { return logic; }
@@ -177,6 +177,15 @@ void ArraySolver::getNewSplits(vec<PTRef> & splits) {
     splitondemand.clear();
 }
 
+void ArraySolver::egraphClassesMerged(std::vector<ERef> const & absorbedRoots) {
+    if (not valid) { return; }
+    // The root that absorbed a class was a root when the graph was built, unless it has been absorbed since as well
+    bool affected = std::any_of(absorbedRoots.begin(), absorbedRoots.end(), [this](ERef root) {
+        return relevantRoots.find(root) != relevantRoots.end() or relevantRoots.find(getRoot(root)) != relevantRoots.end();
+    });
+    if (affected) { clear(); }
+}
+
 
 /*
  * Internal methods for manipulating weak equivalence graph
@@ -265,6 +274,16 @@ void ArraySolver::buildWeakEq() {
         merge(store);
     }
     lemmas = collectLemmaConditions(logic);
+    for (ERef arrayTerm : arrayTerms) {
+        relevantRoots.insert(getRoot(arrayTerm));
+    }
+    for (ERef store : storeTerms) {
+        relevantRoots.insert(getRoot(getIndexFromStore(store)));
+    }
+    for (ERef select : selectTerms) {
+        relevantRoots.insert(getRoot(select));
+        relevantRoots.insert(getRoot(getIndexFromSelect(select)));
+    }
     valid = true;
 }
 
@@ -384,28 +403,24 @@ TRes ArraySolver::checkExtensionality() {
     }
 
     for (auto const & entry : equalitiesToPropagate) {
-        PTRef extensionalityClause = computeExtensionalityClause(entry.first, entry.second);
+        ExplanationCollection antecedent;
+        PTRef extensionalityClause = computeExtensionalityClause(entry.first, entry.second, antecedent);
         assert(logic.isOr(extensionalityClause));
-        // TODO: handle conflicts better: We pass literals twice now.
         // TODO: looks like the above graph traversal could be terminated early if a clause is all-falsified
-        Pterm & literals = logic.getPterm(extensionalityClause);
-        bool allFalsified = std::all_of(literals.begin(), literals.end(),
-                                        [this](PTRef lit) {
-                                            bool negated = logic.isNot(lit);
-                                            PTRef atom = negated ? logic.getPterm(lit)[0] : lit;
-                                            assert(logic.isEquality(atom));
-                                            return negated ? isSatisfied(atom) : isFalsified(atom);
-                                        });
+        PTRef equality = getEquality(getNode(entry.first).term, getNode(entry.second).term, logic);
+        // Literals other than equalities come from the reasons of merges the Egraph did on behalf of other solvers,
+        // which hold in the current context
+        bool allFalsified = isFalsified(equality) and std::all_of(antecedent.begin(), antecedent.end(), [this](PtAsgn lit) {
+            if (not logic.isEquality(lit.tr)) { return true; }
+            return lit.sgn == l_True ? isSatisfied(lit.tr) : isFalsified(lit.tr);
+        });
         if (allFalsified) {
             has_explanation = true;
             explanation.clear();
-            for (PTRef lit : literals) {
-                if (logic.isNot(lit)) {
-                    explanation.push({logic.getPterm(lit)[0], l_True});
-                } else {
-                    explanation.push({lit, l_False});
-                }
+            for (PtAsgn lit : antecedent) {
+                explanation.push(lit);
             }
+            if (not logic.isFalse(equality)) { explanation.push({equality, l_False}); }
             splitondemand.clear();
             return TRes::UNSAT;
         }
@@ -414,9 +429,8 @@ TRes ArraySolver::checkExtensionality() {
     return TRes::SAT;
 }
 
-PTRef ArraySolver::computeExtensionalityClause(NodeRef n1, NodeRef n2) {
+PTRef ArraySolver::computeExtensionalityClause(NodeRef n1, NodeRef n2, ExplanationCollection & explanationCollection) {
     Traversal traversal(*this);
-    ExplanationCollection explanationCollection;
     IndicesCollection indicesCollection;
     ExplanationCursor source(traversal, n1, getNode(n1).term);
     ExplanationCursor destination(traversal, n2, getNode(n2).term);
@@ -597,6 +611,7 @@ void ArraySolver::clear() {
     selectsInfo.clear();
     nodes.clear();
     rootsMap.clear();
+    relevantRoots.clear();
     valid = false;
 
     has_explanation = false;
@@ -102,6 +102,9 @@ class ArraySolver : public TSolver {
     // Whether or not WE-graph has been built for current context
     bool valid = false;
 
+    // Roots of the classes of arrays, selects and indices when the WE-graph was built
+    std::unordered_set<ERef, ERefHash> relevantRoots;
+
     vec<PtAsgn> assertedLiterals;
 
 public:
@@ -133,6 +136,10 @@ public:
 
     void getNewSplits(vec<PTRef> & splits) override;
 
+    // The Egraph merged classes outside of assertLit, e.g., on behalf of the arithmetic solver, absorbing the given
+    // roots. The WE-graph is dropped only if one of the merged classes is one it was built from.
+    void egraphClassesMerged(std::vector<ERef> const & absorbedRoots);
+
     /*
      * Internal methods for traversing weak equivalence graph
      */
@@ -234,7 +241,8 @@ private:
 
     ExplanationCollection readOverWeakEquivalenceConflict(PTRef equality);
 
-    PTRef computeExtensionalityClause(NodeRef n1, NodeRef n2);
+    // Returns the clause and collects the literals whose conjunction implies that n1 and n2 are equal
+    PTRef computeExtensionalityClause(NodeRef n1, NodeRef n2, ExplanationCollection & antecedent);
 
     void explainWeakCongruencePath(ExplanationCollection & explanationCollection, NodeRef source, NodeRef target, ERef index);
 
@@ -0,0 +1,217 @@
+#include "AigStore.h"
+
+#include <utility>
+
+namespace opensmt {
+
+AigStore::AigStore(Logic & logic) : logic(logic) {
+    // Node 0 is the constant; its positive literal is false
+    nodes.push_back({AigLit_False, AigLit_False, PTRef_Undef, lit_Undef, true});
+}
+
+AigLit AigStore::mkInput(PTRef atom) {
+    assert(logic.hasSortBool(atom));
+    auto it = inputs.find(atom);
+    if (it != inputs.end()) { return it->second; }
+    AigLit res = mkLit(static_cast<uint32_t>(nodes.size()), false);
+    nodes.push_back({AigLit_False, AigLit_False, atom, lit_Undef, true});
+    inputs.insert({atom, res});
+    return res;
+}
+
+bool AigStore::rewrite(AigLit & a, AigLit & b, AigLit & result) const {
+    auto hasOperand = [this](AigLit gate, AigLit x) { return left(gate) == x or right(gate) == x; };
+
+    // Rules where only one of the operands is a gate
+    auto oneLevel = [&](AigLit & p, AigLit q) {
+        if (not isAnd(p)) { return false; }
+        if (not p.sign()) {
+            // Contradiction: (p0 & p1) & ~p0 = false
+            if (hasOperand(p, ~q)) {
+                result = AigLit_False;
+                return true;
+            }
+            // Idempotence: (p0 & p1) & p0 = p0 & p1
+            if (hasOperand(p, q)) {
+                result = p;
+                return true;
+            }
+        } else {
+            AigLit g = ~p;
+            // Subsumption: ~(p0 & p1) & ~p0 = ~p0
+            if (hasOperand(g, ~q)) {
+                result = q;
+                return true;
+            }
+            // Substitution: ~(p0 & p1) & p0 = ~p1 & p0
+            if (left(g) == q) {
+                p = ~right(g);
+            } else if (right(g) == q) {
+                p = ~left(g);
+            }
+        }
+        return false;
+    };
+
+    if (oneLevel(a, b) or oneLevel(b, a)) { return true; }
+    if (not isAnd(a) or not isAnd(b)) { return false; }
+
+    AigLit a0 = left(a), a1 = right(a);
+    AigLit b0 = left(b), b1 = right(b);
+    if (not a.sign() and not b.sign()) {
+        // Contradiction: (a0 & a1) & (~a0 & b1) = false
+        if (a0 == ~b0 or a0 == ~b1 or a1 == ~b0 or a1 == ~b1) {
+            result = AigLit_False;
+            return true;
+        }
+    } else if (a.sign() and b.sign()) {
+        // Resolution: ~(x & y) & ~(x & ~y) = ~x
+        auto resolve = [&](AigLit x0, AigLit y0, AigLit x1, AigLit y1) {
+            if (x0 == x1 and y0 == ~y1) {
+                result = ~x0;
+                return true;
+            }
+            return false;
+        };
+        if (resolve(a0, a1, b0, b1) or resolve(a0, a1, b1, b0) or resolve(a1, a0, b0, b1) or
+            resolve(a1, a0, b1, b0)) {
+            return true;
+        }
+    } else {
+        // Subsumption: (a0 & a1) & ~(~a0 & b1) = a0 & a1
+        AigLit pos = a.sign() ? b : a;
+        AigLit neg = a.sign() ? a : b;
+        AigLit p0 = left(pos), p1 = right(pos);
+        AigLit n0 = left(~neg), n1 = right(~neg);
+        if (n0 == ~p0 or n0 == ~p1 or n1 == ~p0 or n1 == ~p1) {
+            result = pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+AigLit AigStore::mkAnd(AigLit a, AigLit b) {
+    while (true) {
+        if (a == AigLit_False or b == AigLit_False) { return AigLit_False; }
+        if (a == AigLit_True) { return b; }
+        if (b == AigLit_True) { return a; }
+        if (a == b) { return a; }
+        if (a == ~b) { return AigLit_False; }
+        if (b < a) { std::swap(a, b); }
+        AigLit oldA = a, oldB = b, result;
+        if (rewrite(a, b, result)) {
+            ++rewrites;
+            return result;
+        }
+        if (a == oldA and b == oldB) { break; }
+        ++rewrites;
+    }
+
+    auto it = strash.find(key(a, b));
+    if (it != strash.end()) {
+        ++strashHits;
+        return mkLit(it->second, false);
+    }
+    auto index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back({a, b, PTRef_Undef, lit_Undef, false});
+    strash.insert({key(a, b), index});
+    return mkLit(index, false);
+}
+
+AigLit AigStore::fromTerm(PTRef formula) {
+    assert(logic.hasSortBool(formula));
+    auto isConnective = [this](PTRef tr) {
+        if (logic.isAnd(tr) or logic.isOr(tr) or logic.isNot(tr) or logic.isXor(tr) or logic.isImplies(tr)) {
+            return true;
+        }
+        if (logic.isIte(tr) and logic.hasSortBool(tr)) { return true; }
+        return logic.isIff(tr) and logic.hasSortBool(logic.getPterm(tr)[0]);
+    };
+
+    std::vector<std::pair<PTRef, bool>> queue;
+    queue.emplace_back(formula, false);
+    while (not queue.empty()) {
+        auto [tr, expanded] = queue.back();
+        queue.pop_back();
+        if (converted.find(tr) != converted.end()) { continue; }
+        if (logic.isTrue(tr) or logic.isFalse(tr)) {
+            converted.insert({tr, logic.isTrue(tr) ? AigLit_True : AigLit_False});
+            continue;
+        }
+        if (not isConnective(tr)) {
+            converted.insert({tr, mkInput(tr)});
+            continue;
+        }
+        Pterm const & term = logic.getPterm(tr);
+        if (not expanded) {
+            queue.emplace_back(tr, true);
+            for (PTRef child : term) {
+                if (converted.find(child) == converted.end()) { queue.emplace_back(child, false); }
+            }
+            continue;
+        }
+        vec<AigLit> args;
+        for (PTRef child : term) {
+            args.push(converted.at(child));
+        }
+        AigLit res;
+        if (logic.isNot(tr)) {
+            res = ~args[0];
+        } else if (logic.isAnd(tr)) {
+            res = AigLit_True;
+            for (AigLit arg : args) { res = mkAnd(res, arg); }
+        } else if (logic.isOr(tr)) {
+            res = AigLit_False;
+            for (AigLit arg : args) { res = mkOr(res, arg); }
+        } else if (logic.isXor(tr)) {
+            res = AigLit_False;
+            for (AigLit arg : args) { res = mkXor(res, arg); }
+        } else if (logic.isImplies(tr)) {
+            res = args.last();
+            for (int i = args.size() - 2; i >= 0; --i) { res = mkOr(~args[i], res); }
+        } else if (logic.isIte(tr)) {
+            res = mkIte(args[0], args[1], args[2]);
+        } else {
+            assert(logic.isIff(tr));
+            res = AigLit_True;
+            for (int i = 1; i < args.size(); ++i) { res = mkAnd(res, mkIff(args[0], args[i])); }
+        }
+        converted.insert({tr, res});
+    }
+    return converted.at(formula);
+}
+
+Lit AigStore::litOf(AigLit lit, InputLit const & inputLit, GateLit const & gateLit) {
+    assert(not isConstant(lit));
+    Node & node = nodes[lit.node()];
+    if (node.lit == lit_Undef) { node.lit = node.atom != PTRef_Undef ? inputLit(node.atom) : gateLit(); }
+    return lit.sign() ? ~node.lit : node.lit;
+}
+
+Lit AigStore::encode(AigLit root, InputLit const & inputLit, GateLit const & gateLit,
+                     std::vector<vec<Lit>> & clauses) {
+    Lit rootLit = litOf(root, inputLit, gateLit);
+    // Clause order is irrelevant, so each gate is defined as soon as it is reached
+    std::vector<uint32_t> queue;
+    queue.push_back(root.node());
+    while (not queue.empty()) {
+        uint32_t n = queue.back();
+        queue.pop_back();
+        if (nodes[n].encoded) { continue; }
+        nodes[n].encoded = true;
+        ++encodedGates;
+        AigLit left = nodes[n].left, right = nodes[n].right;
+        Lit g = litOf(mkLit(n, false), inputLit, gateLit);
+        Lit l = litOf(left, inputLit, gateLit);
+        Lit r = litOf(right, inputLit, gateLit);
+        clauses.push_back({~g, l});
+        clauses.push_back({~g, r});
+        clauses.push_back({g, ~l, ~r});
+        queue.push_back(left.node());
+        queue.push_back(right.node());
+    }
+    return rootLit;
+}
+
+} // namespace opensmt
@@ -0,0 +1,106 @@
+#ifndef OPENSMT_AIGSTORE_H
+#define OPENSMT_AIGSTORE_H
+
+#include <logics/Logic.h>
+#include <minisat/core/SolverTypes.h>
+#include <minisat/mtl/Vec.h>
+#include <pterms/PTRef.h>
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace opensmt {
+
+// A literal of the And-Inverter Graph: the node index shifted left by one, the lowest bit marks complementation.
+struct AigLit {
+    uint32_t x;
+    inline friend bool operator==(AigLit a, AigLit b) { return a.x == b.x; }
+    inline friend bool operator!=(AigLit a, AigLit b) { return a.x != b.x; }
+    inline friend bool operator<(AigLit a, AigLit b) { return a.x < b.x; }
+    inline friend AigLit operator~(AigLit a) { return {a.x ^ 1u}; }
+    uint32_t node() const { return x >> 1; }
+    bool sign() const { return x & 1u; }
+};
+
+static inline constexpr AigLit AigLit_False = {0};
+static inline constexpr AigLit AigLit_True = {1};
+
+/**
+ * And-Inverter Graph sitting between the bit-blaster and the SAT solver.
+ *
+ * Gates are hash-consed, constants are propagated, and each new AND node is simplified
+ * with the local two-level rules of Brummayer and Biere (contradiction, idempotence,
+ * subsumption, substitution and resolution) before it is created. Gates are encoded into
+ * CNF lazily: encode() emits the Tseitin definitions only for the not yet encoded gates in
+ * the cone of influence of the given root, so sub-circuits that are never asserted never
+ * reach the SAT solver. The definitions hold in every frame of the solver, so a gate that is
+ * encoded once is shared by all later roots, also after the frame of its first root was popped.
+ *
+ * The graph does not create terms; the literals of the inputs and of the gates are provided
+ * by the caller.
+ */
+class AigStore {
+public:
+    explicit AigStore(Logic & logic);
+
+    AigLit mkInput(PTRef atom);
+    AigLit mkAnd(AigLit a, AigLit b);
+    AigLit mkOr(AigLit a, AigLit b) { return ~mkAnd(~a, ~b); }
+    AigLit mkXor(AigLit a, AigLit b) { return mkOr(mkAnd(a, ~b), mkAnd(~a, b)); }
+    AigLit mkIff(AigLit a, AigLit b) { return ~mkXor(a, b); }
+    AigLit mkIte(AigLit c, AigLit t, AigLit e) { return mkOr(mkAnd(c, t), mkAnd(~c, e)); }
+
+    // Converts a Boolean formula to the graph; non-Boolean-connective subterms become inputs.
+    AigLit fromTerm(PTRef formula);
+
+    using InputLit = std::function<Lit(PTRef)>;
+    using GateLit = std::function<Lit()>; // A fresh literal for a gate
+
+    // Emits the definitions of the gates in the cone of influence of root that were not encoded before.
+    // The root must not be constant.
+    Lit encode(AigLit root, InputLit const & inputLit, GateLit const & gateLit, std::vector<vec<Lit>> & clauses);
+
+    bool isConstant(AigLit lit) const { return lit.node() == 0; }
+    bool isAnd(AigLit lit) const { return nodes[lit.node()].isAnd(); }
+
+    std::size_t getNumNodes() const { return nodes.size(); }
+    std::size_t getNumEncodedGates() const { return encodedGates; }
+    std::size_t getNumStrashHits() const { return strashHits; }
+    std::size_t getNumRewrites() const { return rewrites; }
+
+private:
+    struct Node {
+        AigLit left;
+        AigLit right;
+        PTRef atom; // PTRef_Undef for gates
+        Lit lit;    // The SAT literal of the node, lit_Undef until it is needed
+        bool encoded;
+        bool isAnd() const { return left != AigLit_False or right != AigLit_False; }
+    };
+
+    static uint64_t key(AigLit a, AigLit b) { return (static_cast<uint64_t>(a.x) << 32) | b.x; }
+
+    AigLit mkLit(uint32_t node, bool sign) const { return {(node << 1) | static_cast<uint32_t>(sign)}; }
+    AigLit left(AigLit lit) const { return nodes[lit.node()].left; }
+    AigLit right(AigLit lit) const { return nodes[lit.node()].right; }
+    Lit litOf(AigLit lit, InputLit const & inputLit, GateLit const & gateLit);
+
+    // Two-level rewriting of a & b. Returns true and sets result if the conjunction simplifies to an existing
+    // literal; may instead replace an operand by a smaller one (substitution rule) and return false.
+    bool rewrite(AigLit & a, AigLit & b, AigLit & result) const;
+
+    Logic & logic;
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, uint32_t> strash;
+    std::unordered_map<PTRef, AigLit, PTRefHash> inputs;
+    std::unordered_map<PTRef, AigLit, PTRefHash> converted;
+    std::size_t encodedGates = 0;
+    std::size_t strashHits = 0;
+    std::size_t rewrites = 0;
+};
+
+} // namespace opensmt
+
+#endif // OPENSMT_AIGSTORE_H
@@ -27,6 +27,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "BitBlaster.h"
 #include "BVStore.h"
 
+#include <logics/BVLogic.h>
 #include <models/ModelBuilder.h>
 #include <api/MainSolver.h>
 #include <common/Real.h>
@@ -57,6 +58,7 @@ const char* BitBlaster::s_bbDistinct    = ".bbDistinct";
 const char* BitBlaster::s_bbBvlsh       = ".bbBvlsh";
 const char* BitBlaster::s_bbBvlrsh      = "s_bbBvlrsh";
 const char* BitBlaster::s_bbBvarsh      = "s_bbBvarsh";
+const char* BitBlaster::s_bbGate        = ".bbGate";
 
 BitBlaster::BitBlaster(SolverId, SMTConfig & c, MainSolver & mainSolver, BVLogic & bvlogic, vec<PtAsgn> & ex,
                        vec<PTRef> & s)
@@ -66,6 +68,7 @@ BitBlaster::BitBlaster(SolverId, SMTConfig & c, MainSolver & mainSolver, BVLogic
     , logic       (bvlogic)
     , thandler    (mainSolver.getTHandler())
     , solverP     (mainSolver.getSMTSolver())
+    , aig         (bvlogic)
     , explanation (ex)
     , suggestions (s)
     , has_model   (false)
@@ -94,11 +97,13 @@ BitBlaster::inform (PTRef tr)
 {
     BVRef result = bbTerm( tr );
 
-    vec<PTRef> bv;
-    bs.copyAsgnTo(result, bv);
-    PTRef tr_out = logic.mkImpl(bs[result].getActVar(), logic.mkAnd(bv));
-    mainSolver.insertFormula(tr_out);
-    return l_Undef;
+    // The bits go through the AIG so that equal sub-circuits of different terms share their gates
+    AigLit bits = AigLit_True;
+    for (int i = 0; i < bs[result].size(); i++)
+        bits = aig.mkAnd(bits, aig.fromTerm(bs[result][i]));
+
+    Lit act = thandler.getTMap().getOrCreateLit(bs[result].getActVar());
+    return assertAig(bits, act) ? l_Undef : l_False;
 }
 
 lbool
@@ -106,9 +111,8 @@ BitBlaster::insert(PTRef tr, BVRef& out)
 {
     out = bbTerm(tr);
 
-    PTRef last_bit = logic.mkEq(bs[out].lsb(), logic.getTerm_true());
-    mainSolver.insertFormula(last_bit);
-    return l_Undef;
+    // Like an inserted formula, the bit holds only while the current frame is not popped
+    return assertAig(aig.fromTerm(bs[out].lsb()), mainSolver.getCurrentFrameGuard()) ? l_Undef : l_False;
 }
 
 lbool
@@ -1451,7 +1455,39 @@ BitBlaster::bbDistinct(PTRef tr)
 bool
 BitBlaster::addClause(vec<Lit> && c)
 {
-    return solverP.addOriginalClause(std::move(c));
+    pair<CRef, CRef> iorefs{CRef_Undef, CRef_Undef};
+    return solverP.addOriginalSMTClause(std::move(c), iorefs);
+}
+
+//
+// Only the cone of influence of an asserted root is translated to CNF, and
+// every gate is encoded at most once regardless of how many roots share it
+//
+bool
+BitBlaster::assertAig(AigLit root, Lit guard)
+{
+    if (root == AigLit_True)
+        return true;
+
+    std::vector<vec<Lit>> clauses;
+    if (root != AigLit_False) {
+        TermMapper & tmap = thandler.getTMap();
+        Lit root_lit = aig.encode(root,
+                                  [&tmap](PTRef atom) { return tmap.getOrCreateLit(atom); },
+                                  [this, &tmap]() { return tmap.getOrCreateLit(mkActVar(s_bbGate)); },
+                                  clauses);
+        clauses.push_back({root_lit});
+    } else {
+        clauses.push_back({});
+    }
+    if (guard != lit_Undef)
+        clauses.back().push(~guard);
+
+    for (auto & clause : clauses) {
+        if (!addClause(std::move(clause)))
+            return false;
+    }
+    return true;
 }
 
 //=============================================================================
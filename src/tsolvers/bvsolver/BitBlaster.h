@@ -26,6 +26,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #ifndef BITBLASTER_H
 #define BITBLASTER_H
 
+#include "AigStore.h"
 #include "BVStore.h"
 
 #include <smtsolvers/SimpSMTSolver.h>
@@ -84,8 +85,10 @@ private:
     SimpSMTSolver& solverP;                       // Solver with proof logger
 
     bool addClause(vec<Lit> && c);
+    bool assertAig(AigLit root, Lit guard); // Encode the cone of root and assert guard -> root
 
     static const char* s_bbEq;
+    static const char* s_bbGate;
     static const char* s_bbAnd;
     static const char* s_bbBvslt;
     static const char* s_bbBvule;
@@ -163,6 +166,7 @@ private:
     Lit                             constFalse;                    // Constant literal set to false
 
     BVStore                         bs;
+    AigStore                        aig;                           // Structurally hashed gates of the encoding
 
     std::vector< Lit >                   cnf_cache;                     // Global cache for cnfizer
     std::vector< Var >                   enode_id_to_var;               // Theory atom to Minisat Var correspondence
@@ -34,6 +34,7 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "EnodeStore.h"
 #include "Explainer.h"
 
+#include <common/Number.h>
 #include <common/Timer.h>
 #include <sorts/SStore.h>
 #include <tsolvers/TSolver.h>
@@ -44,7 +45,9 @@ WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "GCTest.h"
 #endif
 
+#include <functional>
 #include <unordered_set>
+#include <utility>
 
 namespace opensmt {
 
@@ -326,6 +329,19 @@ public:
     bool      addEquality         ( PtAsgn );
     bool      addTrue             ( PTRef );
     bool      addFalse            ( PTRef );
+    // Merges the classes of x and y because another theory solver derived x = y from the given asserted literals;
+    // no equality atom is needed for this
+    bool      addImpliedEquality  ( PTRef x, PTRef y, vec<PtAsgn> && reason );
+    // The roots of the classes absorbed by the merges of addImpliedEquality since the last call
+    std::vector<ERef> takeRootsAbsorbedByImpliedMerges() { return std::exchange(rootsAbsorbedByImpliedMerges, {}); }
+    // Adds the asserted literals that justify an offset relation
+    using OffsetReason = std::function<void(vec<PtAsgn> &)>;
+    // Records that term = base + offset holds; the terms need not be known to the Egraph. The reason is asked for
+    // only if the relation explains a merge. The relations are consumed by the next call to propagateOffsetEqualities
+    void      addOffsetRelation   ( PTRef term, PTRef base, Number offset, OffsetReason reason );
+    // Merges classes that the recorded relations place at the same offset from a common term, so that congruence
+    // over arguments differing by known constants is detected without an interface equality split
+    bool      propagateOffsetEqualities();
 
     void      declareAtom(PTRef) override;
     // Non-recursive declare term
@@ -351,13 +367,22 @@ private:
 
     bool    unmergeable     ( ERef, ERef, Expl& ) const;        // Can two nodes be merged ?
     void    merge           ( ERef, ERef, PtAsgn );               // Merge two nodes
-    bool    mergeLoop       ( PtAsgn reason );                    // Merge loop
+    bool    mergeLoop       ( ExpReason reason );                 // Merge loop
     void    deduce          ( ERef, ERef, PtAsgn );               // Deduce from merging of two nodes (record the reason)
     void    undoMerge       ( ERef );                             // Undoes a merge
     void    undoDisequality ( ERef );                             // Undoes a disequality
     void    undoDistinction ( PTRef );                            // Undoes a distinction
 
 
+    struct OffsetRelation {
+        PTRef term;
+        PTRef base;
+        Number offset;      // term = base + offset
+        OffsetReason reason;
+    };
+    std::vector<OffsetRelation> offsetRelations;            // Recorded since the last propagation of offsets
+    std::vector<ERef> rootsAbsorbedByImpliedMerges;         // Not yet taken by takeRootsAbsorbedByImpliedMerges
+
     vec<pair<ERef,ERef>> pending;                          // Pending merges
     vec<Undo>                 undo_stack_main;                  // Keeps track of terms involved in operations
 
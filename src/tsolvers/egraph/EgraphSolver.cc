@@ -64,6 +64,8 @@ The algorithm and data structures are inspired by the following paper:
 #include <tsolvers/Deductions.h>
 #include <models/ModelBuilder.h>
 
+#include <queue>
+
 namespace opensmt {
 
 static SolverDescr descr_uf_solver("UF Solver", "Solver for Quantifier Free Theory of Uninterpreted Functions with Equalities");
@@ -381,6 +383,127 @@ bool Egraph::addFalse(PTRef term) {
     return res;
 }
 
+bool Egraph::addImpliedEquality(PTRef x, PTRef y, vec<PtAsgn> && reason) {
+    if (not enode_store.has(x) or not enode_store.has(y)) { return true; }
+    ERef ex = termToERef(x);
+    ERef ey = termToERef(y);
+    if (getEnode(ex).getRoot() == getEnode(ey).getRoot()) { return true; }
+    assert(pending.size() == 0);
+    pending.push({ex, ey});
+    auto undoSize = undo_stack_main.size();
+    bool res = mergeLoop(explainer->storeExternalReason(std::move(reason)));
+    for (auto i = undoSize; i < undo_stack_main.size(); ++i) {
+        if (undo_stack_main[i].oper == MERGE) { rootsAbsorbedByImpliedMerges.push_back(undo_stack_main[i].arg.er); }
+    }
+#ifdef STATISTICS
+    if (res == false)
+        generalTSolverStats.unsat_calls++;
+#endif
+    return res;
+}
+
+void Egraph::addOffsetRelation(PTRef term, PTRef base, Number offset, OffsetReason reason) {
+    offsetRelations.push_back({term, base, std::move(offset), std::move(reason)});
+}
+
+bool Egraph::propagateOffsetEqualities() {
+    // The relations connect classes of the Egraph and terms unknown to the Egraph, which act as singleton classes.
+    // Each connected component is explored from one of its classes, assigning to every class the offset of its
+    // value from the value of the starting class along the search tree. Two classes with the same offset are equal.
+    // Their equality is explained by the relations on the two tree paths and by the equalities inside the classes
+    // where consecutive relations meet.
+    auto classOf = [this](PTRef tr) {
+        return enode_store.has(tr) ? ERefToTerm(getEnode(termToERef(tr)).getRoot()) : tr;
+    };
+    struct Arc {
+        PTRef to;
+        std::size_t relation;
+        bool forward; // from the class of the base to the class of the term
+    };
+    std::unordered_map<PTRef, std::vector<Arc>, PTRefHash> arcs;
+    for (std::size_t i = 0; i < offsetRelations.size(); ++i) {
+        PTRef termClass = classOf(offsetRelations[i].term);
+        PTRef baseClass = classOf(offsetRelations[i].base);
+        if (termClass == baseClass) { continue; } // Nothing to learn; an inconsistent offset is for the arithmetic solver to find
+        arcs[baseClass].push_back({termClass, i, true});
+        arcs[termClass].push_back({baseClass, i, false});
+    }
+
+    struct Visit {
+        Number offset;
+        PTRef parent;         // Parent class in the search tree
+        std::size_t relation; // Relation of the tree edge from the parent
+        PTRef inTerm;         // End of the tree edge in this class
+        PTRef outTerm;        // End of the tree edge in the parent class
+    };
+    std::unordered_map<PTRef, Visit, PTRefHash> visited;
+    struct Merge {
+        PTRef x;
+        PTRef y;
+        vec<PtAsgn> reason;
+    };
+    std::vector<Merge> merges;
+
+    auto explainEq = [this](PTRef x, PTRef y, vec<PtAsgn> & reason) {
+        if (x == y) { return; }
+        for (PtAsgn lit : explainer->explain(termToERef(x), termToERef(y))) {
+            reason.push(lit);
+        }
+    };
+    // Explains the offset of term x from the start of the search, returns the term in the starting class where it ends
+    auto explainPathToStart = [&](PTRef x, vec<PtAsgn> & reason) {
+        PTRef current = x;
+        PTRef cls = classOf(x);
+        while (visited.at(cls).parent != PTRef_Undef) {
+            Visit const & visit = visited.at(cls);
+            explainEq(current, visit.inTerm, reason);
+            if (offsetRelations[visit.relation].reason) { offsetRelations[visit.relation].reason(reason); }
+            current = visit.outTerm;
+            cls = visit.parent;
+        }
+        return current;
+    };
+
+    for (auto const & relation : offsetRelations) {
+        PTRef start = classOf(relation.base);
+        if (visited.find(start) != visited.end() or arcs.find(start) == arcs.end()) { continue; }
+        std::unordered_map<Number, PTRef, NumberHash> classWithOffset;
+        visited.insert({start, Visit{Number(0), PTRef_Undef, 0, PTRef_Undef, PTRef_Undef}});
+        if (enode_store.has(start)) { classWithOffset.insert({Number(0), start}); }
+        std::queue<PTRef> queue;
+        queue.push(start);
+        while (not queue.empty()) {
+            PTRef cls = queue.front();
+            queue.pop();
+            for (Arc const & arc : arcs.at(cls)) {
+                if (visited.find(arc.to) != visited.end()) { continue; }
+                OffsetRelation const & rel = offsetRelations[arc.relation];
+                Number offset = arc.forward ? visited.at(cls).offset + rel.offset : visited.at(cls).offset - rel.offset;
+                PTRef inTerm = arc.forward ? rel.term : rel.base;
+                PTRef outTerm = arc.forward ? rel.base : rel.term;
+                visited.insert({arc.to, Visit{offset, cls, arc.relation, inTerm, outTerm}});
+                queue.push(arc.to);
+                if (not enode_store.has(arc.to)) { continue; }
+                auto [it, inserted] = classWithOffset.insert({offset, arc.to});
+                if (inserted) { continue; }
+                Merge merge{it->second, arc.to, {}};
+                PTRef endX = explainPathToStart(merge.x, merge.reason);
+                PTRef endY = explainPathToStart(merge.y, merge.reason);
+                explainEq(endX, endY, merge.reason);
+                merges.push_back(std::move(merge));
+            }
+        }
+    }
+    offsetRelations.clear();
+
+    for (auto & merge : merges) {
+        if (not addImpliedEquality(merge.x, merge.y, std::move(merge.reason))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 //===========================================================================
 // Private Routines for Core Theory Solver
 
@@ -396,13 +519,13 @@ bool Egraph::assertEq ( PTRef tr_x, PTRef tr_y, PtAsgn r ) {
 bool Egraph::assertEq(ERef x, ERef y, PtAsgn r) {
     assert(pending.size() == 0);
     pending.push({x, y});
-    return mergeLoop(r);
+    return mergeLoop(ExpReason(r));
 }
 
 //
 // Merge what is in pending and propagate to parents
 //
-bool Egraph::mergeLoop( PtAsgn reason )
+bool Egraph::mergeLoop( ExpReason reason )
 {
     bool congruence_pending = false;
 
@@ -428,7 +551,7 @@ bool Egraph::mergeLoop( PtAsgn reason )
         // reason even in case of unmergability, to have an
         // automatic way of retrieving a conflict.
 
-        explainer->storeExplanation( p, q, congruence_pending ? PtAsgn(PTRef_Undef, l_Undef) : reason );
+        explainer->storeExplanation( p, q, congruence_pending ? ExpReason() : reason );
 
         // Check if they can't be merged
         Expl reason_inequality;
@@ -436,7 +559,7 @@ bool Egraph::mergeLoop( PtAsgn reason )
 
         // They are not unmergable, so they can be merged
         if ( !res ) {
-            merge( en_p.getRoot( ), en_q.getRoot( ), reason );
+            merge( en_p.getRoot( ), en_q.getRoot( ), reason.isLiteral() ? reason.getLiteral() : PtAsgn_Undef );
             congruence_pending = true;
             continue;
         }
@@ -38,7 +38,7 @@ Enode::Enode(SymRef symbol, span<ERef> children, ERef myRef, PTRef term) :
     pterm(term),
     forbid(ELRef_Undef),
     dist_classes(0),
-    exp_reason(PTRef_Undef, l_Undef),
+    exp_reason(),
     exp_parent(ERef_Undef),
     exp_root(myRef),
     exp_time_stamp(0),
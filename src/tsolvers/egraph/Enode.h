@@ -70,6 +70,30 @@ struct ELRef {
 
 static struct ELRef ELRef_Undef = {UINT32_MAX};
 
+//
+// The reason of an edge of the explanation tree: an asserted literal, a congruence, or the literals from which another
+// theory solver derived the equality, which the Explainer keeps under an index
+//
+class ExpReason {
+public:
+    enum class Kind : uint8_t { Congruence, Literal, External };
+
+    ExpReason() = default; // A congruence
+    explicit ExpReason(PtAsgn literal) : kind(literal.tr == PTRef_Undef ? Kind::Congruence : Kind::Literal), literal(literal) {}
+    static ExpReason external(uint32_t index) { ExpReason r; r.kind = Kind::External; r.index = index; return r; }
+
+    Kind   getKind         () const { return kind; }
+    bool   isLiteral       () const { return kind == Kind::Literal; }
+    bool   isExternal      () const { return kind == Kind::External; }
+    PtAsgn getLiteral      () const { assert(isLiteral()); return literal; }
+    uint32_t getExternalIndex() const { assert(isExternal()); return index; }
+
+private:
+    Kind     kind = Kind::Congruence;
+    PtAsgn   literal = PtAsgn_Undef;
+    uint32_t index = UINT32_MAX;
+};
+
 class EnodeAllocator;
 
 class Enode final
@@ -86,7 +110,7 @@ private:
     dist_t  dist_classes;   // The bit vector for distinction classes
 
     // fields related to explanation
-    PtAsgn      exp_reason;
+    ExpReason   exp_reason;
     ERef        exp_parent;
     ERef        exp_root;
     int         exp_time_stamp;
@@ -118,12 +142,12 @@ public:
     int  getEqSize () const { return eq_size; }
     void setEqSize (int i) { eq_size = i; }
 
-    PtAsgn getExpReason       () const { return exp_reason; }
+    ExpReason getExpReason    () const { return exp_reason; }
     ERef   getExpParent       () const { return exp_parent; }
     ERef   getExpRoot         () const { return exp_root; }
     int    getExpTimeStamp    () const { return exp_time_stamp; }
 
-    void setExpReason     (PtAsgn r)     { exp_reason = r; }
+    void setExpReason     (ExpReason r)  { exp_reason = r; }
     void setExpParent     (ERef r)       { exp_parent = r; }
     void setExpRoot       (ERef r)       { exp_root   = r; }
     void setExpTimeStamp  (const int t)  { exp_time_stamp = t; }
@@ -4,6 +4,8 @@
 
 #include "Explainer.h"
 
+#include <algorithm>
+
 namespace opensmt {
 
 //=============================================================================
@@ -33,7 +35,7 @@ namespace opensmt {
  * @Preconditions: x & y are terms and not in the same equivalence class.
  * @Postcondition: let u, v be the node in {x, y} with the smaller, respectively larger, equivalence graph. The graph of u will be re-rooted on v.
 */
-void Explainer::storeExplanation(ERef x, ERef y, PtAsgn reason)
+void Explainer::storeExplanation(ERef x, ERef y, ExpReason reason)
 {
     assert(getEnode(x).getRoot() != getEnode(y).getRoot());
 
@@ -77,14 +79,14 @@ void Explainer::storeExplanation(ERef x, ERef y, PtAsgn reason)
 void Explainer::reRootOn(ERef x) {
     ERef p = x;
     ERef parent = getEnode(p).getExpParent();
-    PtAsgn reason = getEnode(p).getExpReason();
+    ExpReason reason = getEnode(p).getExpReason();
     getEnode(x).setExpParent(ERef_Undef);
-    getEnode(x).setExpReason(PtAsgn_Undef);
+    getEnode(x).setExpReason(ExpReason());
     while (parent != ERef_Undef) {
         // Save grandparent
         ERef grandparent = getEnode(parent).getExpParent();
         // Save reason
-        PtAsgn saved_reason = reason;
+        ExpReason saved_reason = reason;
         reason = getEnode(parent).getExpReason();
         // Reverse edge & reason
         getEnode(parent).setExpParent(p);
@@ -155,6 +157,17 @@ void Explainer::explainAlongPath(ERef x, ERef y, vec<PtAsgn> &outExplanation, Pe
     while ( v != to ) {
         ERef p = getEnode(v).getExpParent();
         assert(p != ERef_Undef);
+        if (ExpReason r = getEnode(v).getExpReason(); r.isExternal()) {
+            for (PtAsgn lit : externalReasons[r.getExternalIndex()]) {
+                if (not dc.isDup(lit.tr)) {
+                    outExplanation.push(lit);
+                    dc.storeDup(lit.tr);
+                }
+            }
+            makeUnion(v, p);
+            v = findAndCompress(p);
+            continue;
+        }
         PtAsgn edgeExplanation = explainEdge(v, p, pendingExplanations, dc);
         if (edgeExplanation != PtAsgn_Undef) {
             outExplanation.push(edgeExplanation);
@@ -191,12 +204,14 @@ void Explainer::enqueueArguments(ERef x, ERef y, PendingQueue &exp_pending) {
 
 PtAsgn Explainer::explainEdge(const ERef v, const ERef p, PendingQueue &exp_pending, DupChecker &dc) {
     assert(getEnode(v).getExpParent() == p);
-    PtAsgn r = getEnode(v).getExpReason();
+    ExpReason reason = getEnode(v).getExpReason();
+    assert(not reason.isExternal());
 
     PtAsgn expl = PtAsgn_Undef;
 
-    if (r.tr != PTRef_Undef) {
+    if (reason.isLiteral()) {
         // Not a congruence edge
+        PtAsgn r = reason.getLiteral();
         if (not dc.isDup(r.tr)) {
             expl = r;
             dc.storeDup(r.tr);
@@ -312,14 +327,20 @@ void Explainer::removeExplanation() {
     // of the explanation trees, because it doesn't affect
     // correctness. We just have to reroot y on itself
     assert( getEnode(x).getExpParent() == y || getEnode(y).getExpParent() == x);
-    if (getEnode(x).getExpParent() == y ) {
-        getEnode(x).setExpParent(ERef_Undef);
-        getEnode(x).setExpReason(PtAsgn_Undef);
-    }
-    else {
-        getEnode(y).setExpParent(ERef_Undef);
-        getEnode(y).setExpReason(PtAsgn_Undef);
+    ERef child = getEnode(x).getExpParent() == y ? x : y;
+    if (getEnode(child).getExpReason().isExternal()) {
+        // Merges are undone in reverse order, so the reason of this one is the last one stored
+        assert(getEnode(child).getExpReason().getExternalIndex() + 1 == externalReasons.size());
+        externalReasons.pop_back();
     }
+    getEnode(child).setExpParent(ERef_Undef);
+    getEnode(child).setExpReason(ExpReason());
+}
+
+ExpReason Explainer::storeExternalReason(vec<PtAsgn> && reason) {
+    assert(std::all_of(reason.begin(), reason.end(), [](PtAsgn lit) { return lit.sgn != l_Undef; }));
+    externalReasons.emplace_back(std::move(reason));
+    return ExpReason::external(static_cast<uint32_t>(externalReasons.size() - 1));
 }
 
 PtAsgn InterpolatingExplainer::explainEdge(ERef from, ERef to, PendingQueue &exp_pending, DupChecker &dc) {
@@ -328,7 +349,10 @@ PtAsgn InterpolatingExplainer::explainEdge(ERef from, ERef to, PendingQueue &exp
     const Enode& to_node = getEnode(to);
     cgraph->addCNode( from_node.getTerm() );
     cgraph->addCNode( to_node.getTerm() );
-    cgraph->addCEdge( from_node.getTerm(), to_node.getTerm(), from_node.getExpReason().tr);
+    // Merges implied by other theories are not used together with interpolation
+    ExpReason reason = from_node.getExpReason();
+    assert(not reason.isExternal());
+    cgraph->addCEdge( from_node.getTerm(), to_node.getTerm(), reason.isLiteral() ? reason.getLiteral().tr : PTRef_Undef);
     return expl;
 }
 
@@ -9,6 +9,7 @@
 #include "UFInterpolator.h"
 
 #include <memory>
+#include <vector>
 
 namespace opensmt {
 
@@ -77,12 +78,16 @@ protected:
     int             time_stamp = 0;                   // Need for finding NCA
 
     vec<pair<PTRef,PTRef>> congruences;
+
+    // Reasons of merges implied by other theory solvers, in the order of the corresponding merges
+    std::vector<vec<PtAsgn>> externalReasons;
 public:
     Explainer(EnodeStore & store) : store(store) {}
     virtual ~Explainer() = default;
 
-    void                storeExplanation    (ERef, ERef, PtAsgn);        // Store the explanation for the merge
+    void                storeExplanation    (ERef, ERef, ExpReason);     // Store the explanation for the merge
     void                removeExplanation   ();                          // Undoes the effect of storeExplanation
+    ExpReason           storeExternalReason (vec<PtAsgn> && reason);     // Returns the reason to use in storeExplanation
     virtual vec<PtAsgn> explain             (ERef, ERef);                // Return explanation of why the given two terms are equal
     const vec<pair<PTRef,PTRef>> &getCongruences() const { return congruences; }
 };
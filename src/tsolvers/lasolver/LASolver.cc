@@ -138,6 +138,8 @@ void LASolver::clearSolver()
 
     int_vars.clear();
     int_vars_map.clear();
+    differenceVars.clear();
+    differencesOf.clear();
     // TODO: clear statistics
 //    this->egraphStats.clear();
 }
@@ -317,6 +319,13 @@ LVRef LASolver::registerArithmeticTerm(PTRef expr) {
             // MB: Notify must be called before the query isIntVar!
             isInt &= isIntVar(term.var) && term.coeff.isInteger();
         }
+        if (poly->size() == 2 and poly->begin()->coeff == -std::next(poly->begin())->coeff) {
+            auto const & first = *poly->begin();
+            auto const & second = *std::next(poly->begin());
+            differenceVars.push_back({x, getVarPTRef(first.var), getVarPTRef(second.var), first.coeff});
+            differencesOf[differenceVars.back().term].push_back(differenceVars.size() - 1);
+            differencesOf[differenceVars.back().base].push_back(differenceVars.size() - 1);
+        }
         simplex.newRow(x, std::move(poly));
         if (isInt) {
             markVarAsInt(x);
@@ -952,6 +961,93 @@ TRes LASolver::cutFromProof() {
     return TRes::SAT;
 }
 
+std::vector<LASolver::ImpliedEquality> LASolver::collectImpliedEqualitiesFor(vec<PTRef> const & vars) {
+    struct FixedTerm {
+        PTRef term;
+        std::vector<LABoundRef> bounds;
+    };
+    // For each value, the first term fixed to it; the others are equated with this one
+    std::unordered_map<Real, FixedTerm, NumberHash> representatives;
+    std::vector<ImpliedEquality> equalities;
+    std::vector<LABoundRef> fixingBounds;
+    for (PTRef var : vars) {
+        fixingBounds.clear();
+        Real value;
+        if (logic.isNumConst(var)) {
+            value = logic.getNumConst(var);
+        } else {
+            assert(logic.isNumVar(var));
+            if (not laVarMapper.hasVar(var)) { continue; }
+            LVRef v = laVarMapper.getVarByPTId(logic.getPterm(var).getId());
+            if (not simplex.collectFixingBounds(v, fixingBounds)) { continue; }
+            Delta const & val = simplex.getValuation(v);
+            assert(not val.hasDelta());
+            value = val.R();
+        }
+        auto [it, inserted] = representatives.try_emplace(value, FixedTerm{var, fixingBounds});
+        if (inserted) { continue; }
+        FixedTerm const & representative = it->second;
+        ImpliedEquality equality{representative.term, var, {}};
+        for (LABoundRef bound : representative.bounds) {
+            equality.reason.push(getAsgnByBound(bound));
+        }
+        for (LABoundRef bound : fixingBounds) {
+            equality.reason.push(getAsgnByBound(bound));
+        }
+        equalities.push_back(std::move(equality));
+    }
+    return equalities;
+}
+
+std::vector<LASolver::OffsetRelation> LASolver::collectOffsetRelationsFor(vec<PTRef> const & vars) {
+    std::vector<OffsetRelation> relations;
+    // Search from the given variables along the differences fixed by the bounds
+    std::unordered_set<PTRef, PTRefHash> reached;
+    std::vector<bool> examined(differenceVars.size(), false);
+    std::vector<PTRef> queue;
+    for (PTRef var : vars) {
+        if (not logic.isNumConst(var) and reached.insert(var).second) { queue.push_back(var); }
+    }
+    std::vector<LABoundRef> fixingBounds;
+    while (not queue.empty()) {
+        PTRef term = queue.back();
+        queue.pop_back();
+        auto it = differencesOf.find(term);
+        if (it == differencesOf.end()) { continue; }
+        for (std::size_t index : it->second) {
+            if (examined[index]) { continue; }
+            examined[index] = true;
+            DifferenceVar const & difference = differenceVars[index];
+            fixingBounds.clear();
+            if (not simplex.collectFixingBounds(difference.var, fixingBounds)) { continue; }
+            Delta const & val = simplex.getValuation(difference.var);
+            assert(not val.hasDelta());
+            auto explain = [this, var = difference.var](vec<PtAsgn> & reason) {
+                std::vector<LABoundRef> bounds;
+                [[maybe_unused]] bool fixed = simplex.collectFixingBounds(var, bounds);
+                assert(fixed);
+                for (LABoundRef bound : bounds) {
+                    reason.push(getAsgnByBound(bound));
+                }
+            };
+            relations.push_back({difference.term, difference.base, val.R() / difference.coeff, std::move(explain)});
+            for (PTRef end : {difference.term, difference.base}) {
+                if (reached.insert(end).second) { queue.push_back(end); }
+            }
+        }
+    }
+    if (relations.empty()) { return relations; }
+    // Constants are related through their values, so that relations ending in different constants connect
+    std::unordered_map<SRef, PTRef, SRefHash> firstConstant;
+    for (PTRef var : vars) {
+        if (not logic.isNumConst(var)) { continue; }
+        auto [it, inserted] = firstConstant.try_emplace(logic.getSortRef(var), var);
+        if (inserted) { continue; }
+        relations.push_back({var, it->second, logic.getNumConst(var) - logic.getNumConst(it->second), {}});
+    }
+    return relations;
+}
+
 vec<PTRef> LASolver::collectEqualitiesFor(vec<PTRef> const & vars, std::unordered_set<PTRef, PTRefHash> const & knownEqualities) {
     struct DeltaHash {
         std::size_t operator()(Delta const & d) const {
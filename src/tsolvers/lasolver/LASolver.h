@@ -19,6 +19,7 @@
 #include <logics/ArithLogic.h>
 #include <tsolvers/TSolver.h>
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -69,6 +70,25 @@ public:
     vec<PTRef> collectEqualitiesFor(vec<PTRef> const & vars,
                                     std::unordered_set<PTRef, PTRefHash> const & knownEqualities) override;
 
+    struct ImpliedEquality {
+        PTRef lhs;
+        PTRef rhs;
+        vec<PtAsgn> reason; // the asserted bounds that fix both sides to the same value
+    };
+    // Equalities between the given variables (or constants) that are implied by the currently active bounds
+    std::vector<ImpliedEquality> collectImpliedEqualitiesFor(vec<PTRef> const & vars);
+
+    struct OffsetRelation {
+        PTRef term;
+        PTRef base;
+        Real offset; // term = base + offset
+        std::function<void(vec<PtAsgn> &)> explain; // adds the asserted bounds that fix the difference; empty for constants
+    };
+    // Relations between terms whose difference is fixed by the currently active bounds, and between the constants
+    // among the given variables. Only differences reachable from the given variables through fixed differences are
+    // considered. The explanations are valid until the bounds change.
+    std::vector<OffsetRelation> collectOffsetRelationsFor(vec<PTRef> const & vars);
+
     PTRef getRealInterpolant(ipartitions_t const &, ItpColorMap *, PartitionManager & pmanager);
     PTRef getIntegerInterpolant(ItpColorMap const &);
 
@@ -173,6 +193,16 @@ private:
 
     Map<LVRef, bool, LVRefHash> int_vars_map; // stores problem variables for duplicate check
     vec<LVRef> int_vars;                      // stores the list of problem variables without duplicates
+
+    struct DifferenceVar {
+        LVRef var;  // var = coeff * (term - base)
+        PTRef term;
+        PTRef base;
+        Real coeff;
+    };
+    std::vector<DifferenceVar> differenceVars; // Rows with two opposite coefficients, candidates for offset relations
+    std::unordered_map<PTRef, std::vector<std::size_t>, PTRefHash> differencesOf; // Indices to differenceVars by term
+
     double seed = 123;
 
     std::vector<Real> concrete_model; // Save here the concrete model for the vars indexed by Id
@@ -398,6 +398,31 @@ Delta Simplex::getValuation(LVRef v) const {
     return val;
 }
 
+bool Simplex::collectFixingBounds(LVRef v, std::vector<LABoundRef> & fixingBounds) const {
+    auto isFixed = [this](LVRef x) {
+        return model->hasLBound(x) and model->hasUBound(x) and not model->Lb(x).hasDelta() and model->Lb(x) == model->Ub(x);
+    };
+    auto addBoundsOf = [&](LVRef x) {
+        fixingBounds.push_back(model->readLBoundRef(x));
+        fixingBounds.push_back(model->readUBoundRef(x));
+    };
+    if (isFixed(v)) {
+        addBoundsOf(v);
+        return true;
+    }
+    // Rows of quasi-basic variables are not kept up to date, these are not activated just for this check
+    if (not tableau.isBasic(v)) { return false; }
+    // The row is a definition of v, so fixed values of all variables in the row fix the value of v
+    auto const & row = tableau.getRowPoly(v);
+    if (not std::all_of(row.begin(), row.end(), [&](auto const & term) { return isFixed(term.var); })) {
+        return false;
+    }
+    for (auto const & term : row) {
+        addBoundsOf(term.var);
+    }
+    return true;
+}
+
 Real Simplex::computeDelta() const {
 
     /*
@@ -94,6 +94,9 @@ public:
 
     Real computeDelta() const;
     Delta getValuation(LVRef) const; // Understands also variables deleted by gaussian elimination
+    // Checks if the active bounds fix the value of the variable, either directly or through its row in the tableau.
+    // If so, the bounds responsible are added to 'fixingBounds'.
+    bool collectFixingBounds(LVRef v, std::vector<LABoundRef> & fixingBounds) const;
     //    Delta read(LVRef v) const { assert(!tableau.isQuasiBasic(v)); return model->read(v); } // ignores unsafely
     //    variables deleted by gaussian elimination
     LABoundRef const readLBoundRef(LVRef const & v) const { return model->readLBoundRef(v); }
@@ -13,15 +13,25 @@ class STPGraphManager {
 public:
     explicit STPGraphManager(STPStore<T> & store, STPMapper<T> & mapper) : store(store), mapper(mapper), timestamp(0) {}
 
+    // Adding edge 'e' of a negative cycle is rejected by updatePotential; the cycle without 'e' is then stored here
+    std::vector<EdgeRef> const & getNegativeCycle() const { return negativeCycle; }
+
+    T getPotential(VertexRef v) const;
+
     EdgeGraph const & getGraph() const { return graph; }
 
     bool isTrue(EdgeRef e) const;
 
     uint32_t getAddedCount() const { return timestamp; }
 
+    // Restores the feasibility of the potential function for the graph extended by 'e' (Cotton & Maler, 2006).
+    // Returns false if adding 'e' closes a negative cycle; the potential is left unchanged in that case.
+    bool updatePotential(EdgeRef e);
+
     void setTrue(EdgeRef e, PtAsgn asgn);
 
-    std::vector<EdgeRef> findConsequences(EdgeRef e);
+    // 'bound' limits the number of vertices expanded in each direction; 0 means unbounded
+    std::vector<EdgeRef> findConsequences(EdgeRef e, size_t bound = 0);
 
     void findExplanation(EdgeRef e, vec<PtAsgn> & v);
 
@@ -30,19 +40,26 @@ public:
     void clear();
 
 private:
-    // helper struct to return results of DFS
-    struct DFSResult {
-        std::vector<bool> visited; // map of which vertices were visited
-        std::vector<T> distance;   // map of distances to each visited vertex
-        size_t total{};            // sum of all edges each vertex appears in
-
-        DFSResult(std::vector<bool> && vis, std::vector<T> && dist, size_t total)
-            : visited(std::move(vis)),
-              distance(std::move(dist)),
-              total(total) {}
+    // scratch space of a graph search, kept between calls so that a search only pays for the vertices it reaches
+    struct SearchBuffer {
+        std::vector<uint32_t> stamp;    // vertex was reached in the current search iff its stamp equals 'epoch'
+        std::vector<uint32_t> closed;   // similarly, marks vertices whose distance can't change anymore
+        std::vector<T> distance;        // map of distances to each reached vertex
+        std::vector<EdgeRef> pred;      // last edge of the path to each reached vertex
+        std::vector<VertexRef> reached; // list of vertices reached in the current search
+        size_t total{};                 // sum of all edges each reached vertex appears in
+        uint32_t epoch{};
+
+        void reset(size_t n);
+        bool isReached(VertexRef v) const { return stamp[v.x] == epoch; }
+        bool isClosed(VertexRef v) const { return closed[v.x] == epoch; }
+        void close(VertexRef v) { closed[v.x] = epoch; }
+        void reach(VertexRef v, T dist, EdgeRef e);
     };
 
-    DFSResult dfsSearch(VertexRef init, bool forward);
+    void dfsSearch(VertexRef init, bool forward, size_t bound, SearchBuffer & res);
+
+    std::vector<EdgeRef> const & edgesFrom(VertexRef v) const;
 
     void setDeduction(EdgeRef e);
 
@@ -55,6 +72,14 @@ private:
     uint32_t timestamp; // timestamp of the latest 'setTrue' call
 
     std::vector<EdgeRef> deductions;
+
+    std::vector<T> potential;             // feasible potential of the graph: pi(to) <= pi(from) + cost for each edge
+
+    std::vector<EdgeRef> negativeCycle;
+
+    SearchBuffer backwardSearch, forwardSearch, explanationSearch, potentialSearch;
+
+    std::vector<std::pair<T, VertexRef>> heap; // priority queue of 'updatePotential'
 };
 } // namespace opensmt
 
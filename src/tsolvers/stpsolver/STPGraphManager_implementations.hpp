@@ -4,6 +4,7 @@
 #include "STPGraphManager.h"
 #include "Converter.h"
 
+#include <algorithm>
 #include <stack>
 
 namespace opensmt {
@@ -13,6 +14,98 @@ bool STPGraphManager<T>::isTrue(EdgeRef e) const {
     return e != EdgeRef_Undef && store.getEdge(e).setTime != 0;
 }
 
+template<class T>
+T STPGraphManager<T>::getPotential(VertexRef v) const {
+    return v.x < potential.size() ? potential[v.x] : Converter<T>::getValue(0);
+}
+
+template<class T>
+std::vector<EdgeRef> const & STPGraphManager<T>::edgesFrom(VertexRef v) const {
+    static std::vector<EdgeRef> const none;
+    return v.x < graph.outgoing.size() ? graph.outgoing[v.x] : none;
+}
+
+template<class T>
+void STPGraphManager<T>::SearchBuffer::reset(size_t n) {
+    if (stamp.size() < n) {
+        stamp.resize(n, 0);
+        closed.resize(n, 0);
+        distance.resize(n);
+        pred.resize(n, EdgeRef_Undef);
+    }
+    if (++epoch == 0) {  // on overflow, the stale stamps have to be cleared explicitly
+        std::fill(stamp.begin(), stamp.end(), 0);
+        std::fill(closed.begin(), closed.end(), 0);
+        epoch = 1;
+    }
+    reached.clear();
+    total = 0;
+}
+
+template<class T>
+void STPGraphManager<T>::SearchBuffer::reach(VertexRef v, T dist, EdgeRef e) {
+    if (stamp[v.x] != epoch) {
+        stamp[v.x] = epoch;
+        reached.push_back(v);
+    }
+    distance[v.x] = dist;
+    pred[v.x] = e;
+}
+
+// Adding 'u --c--> v' can only violate the potential at 'v'. The required decrease 'gamma' is propagated in the
+// order of the reduced costs 'pi(s) + cost - pi(t) >= 0' of the graph edges, i.e., by Dijkstra's algorithm, so each
+// affected vertex is finalized at most once. The new edge closes a negative cycle iff its source needs to decrease.
+template<class T>
+bool STPGraphManager<T>::updatePotential(EdgeRef e) {
+    size_t n = store.vertexNum();
+    if (potential.size() < n) potential.resize(n, Converter<T>::getValue(0));
+
+    Edge<T> const & edge = store.getEdge(e);
+    T gamma = potential[edge.from.x] + edge.cost - potential[edge.to.x];
+    if (gamma >= Converter<T>::getValue(0)) return true;
+
+    auto & res = potentialSearch;
+    res.reset(n);
+    auto cmp = [](std::pair<T, VertexRef> const & a, std::pair<T, VertexRef> const & b) { return a.first > b.first; };
+    heap.clear();
+    res.reach(edge.to, gamma, e);
+    heap.emplace_back(gamma, edge.to);
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        VertexRef s = heap.back().second;
+        heap.pop_back();
+        if (res.isClosed(s)) continue;  // stale entry, the vertex was already reached with a lower 'gamma'
+
+        if (s == edge.from) {
+            negativeCycle.clear();
+            for (EdgeRef back = res.pred[s.x]; back != e; back = res.pred[store.getEdge(back).from.x]) {
+                negativeCycle.push_back(back);
+            }
+            return false;
+        }
+        res.close(s);
+        T newPotential = potential[s.x] + res.distance[s.x];
+        for (EdgeRef eRef : edgesFrom(s)) {
+            Edge<T> const & out = store.getEdge(eRef);
+            VertexRef t = out.to;
+            if (res.isClosed(t)) continue;
+            T g = newPotential + out.cost - potential[t.x];
+            if (g >= Converter<T>::getValue(0)) continue;
+            if (!res.isReached(t) || res.distance[t.x] > g) {
+                res.reach(t, g, eRef);
+                heap.emplace_back(g, t);
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+
+    for (VertexRef v : res.reached) {
+        potential[v.x] = potential[v.x] + res.distance[v.x];
+    }
+    return true;
+}
+
 template<class T>
 void STPGraphManager<T>::setTrue(EdgeRef e, PtAsgn asgn) {
     Edge<T> &edge = store.getEdge(e);
@@ -32,30 +125,30 @@ void STPGraphManager<T>::setDeduction(EdgeRef e) {
 
 // Searches through the graph to find consequences of currently assigned edges, starting from 'e'
 template<class T>
-std::vector<EdgeRef> STPGraphManager<T>::findConsequences(EdgeRef e) {
-    size_t n = store.vertexNum();
-
+std::vector<EdgeRef> STPGraphManager<T>::findConsequences(EdgeRef e, size_t bound) {
     auto &start = store.getEdge(e);
     // find potential starts/ends of an edge with a path going through 'e'
-    auto aRes = dfsSearch(start.from, false);
-    auto bRes = dfsSearch(start.to, true);
+    auto &aRes = backwardSearch;
+    auto &bRes = forwardSearch;
+    dfsSearch(start.from, false, bound, aRes);
+    dfsSearch(start.to, true, bound, bRes);
 
     // we scan through the side which appears in fewer total edges
-    auto &thisRes = aRes.total < bRes.total ? aRes : bRes;
-    auto &otherRes = aRes.total < bRes.total ? bRes : aRes;
+    bool backwardSide = aRes.total < bRes.total;
+    auto &thisRes = backwardSide ? aRes : bRes;
+    auto &otherRes = backwardSide ? bRes : aRes;
 
     std::vector<EdgeRef> ret;
     // for each (WLOG) 'a', go through its edges and find each 'a -> b' edge that has cost higher than length found by DFS
     // such edges are consequences of the current graph
-    for (uint32_t i = 0; i < n; ++i) {
-        if (!thisRes.visited[i]) continue;
-        for (auto eRef : mapper.edgesOf(VertexRef{i})) {
+    for (VertexRef v : thisRes.reached) {
+        for (auto eRef : mapper.edgesOf(v)) {
             if (eRef == e) continue;
             const Edge<T> &edge = store.getEdge(eRef);
-            auto thisSide = (aRes.total < bRes.total) ? edge.from.x : edge.to.x;
-            auto otherSide = (aRes.total < bRes.total) ? edge.to.x : edge.from.x;
-            if (thisSide == i && otherRes.visited[otherSide]
-                && edge.cost >= thisRes.distance[thisSide] + start.cost + otherRes.distance[otherSide]) {
+            VertexRef thisSide = backwardSide ? edge.from : edge.to;
+            VertexRef otherSide = backwardSide ? edge.to : edge.from;
+            if (thisSide == v && otherRes.isReached(otherSide)
+                && edge.cost >= thisRes.distance[thisSide.x] + start.cost + otherRes.distance[otherSide.x]) {
                 if (edge.setTime == 0) {
                     ret.push_back(eRef);
                     setDeduction(eRef);
@@ -67,37 +160,35 @@ std::vector<EdgeRef> STPGraphManager<T>::findConsequences(EdgeRef e) {
     return ret;
 }
 
-// DFS through the graph to find shortest paths to all reachable vertices from 'init' in the given direction
+// DFS through the graph to find shortest paths to all reachable vertices from 'init' in the given direction.
+// If 'bound' is non-zero, at most 'bound' vertices are expanded; the distances found are then lengths of existing
+// paths, though not necessarily the shortest ones, so the consequences derived from them are still valid.
 template<class T>
-typename STPGraphManager<T>::DFSResult STPGraphManager<T>::dfsSearch(VertexRef init, bool forward) {
-    std::vector<bool> visited(store.vertexNum());
-    std::vector<T> length(store.vertexNum());
-    size_t total = 0;
+void STPGraphManager<T>::dfsSearch(VertexRef init, bool forward, size_t bound, SearchBuffer & res) {
+    res.reset(store.vertexNum());
     std::stack<VertexRef> open;
-    visited[init.x] = true;
-    length[init.x] = Converter<T>::getValue(0);
+    res.reach(init, Converter<T>::getValue(0), EdgeRef_Undef);
     open.push(init);
+    size_t expanded = 0;
 
-    while (!open.empty()) {
+    while (!open.empty() && (bound == 0 || expanded < bound)) {
         VertexRef curr = open.top();
         open.pop();
+        ++expanded;
         auto &toScan = forward ? graph.outgoing[curr.x] : graph.incoming[curr.x];
         for (auto eRef : toScan) {
             const Edge<T> &edge = store.getEdge(eRef);
             auto next = forward ? edge.to : edge.from;
-            if (!visited[next.x]) {
-                visited[next.x] = true;
+            if (!res.isReached(next)) {
+                res.reach(next, res.distance[curr.x] + edge.cost, eRef);
                 open.push(next);
-                length[next.x] = length[curr.x] + edge.cost;
-                total += mapper.edgesOf(next).size();
-            } else if (length[next.x] > length[curr.x] + edge.cost) {
-                length[next.x] = length[curr.x] + edge.cost;
+                res.total += mapper.edgesOf(next).size();
+            } else if (res.distance[next.x] > res.distance[curr.x] + edge.cost) {
+                res.reach(next, res.distance[curr.x] + edge.cost, eRef);
                 open.push(next);
             }
         }
     }
-
-    return DFSResult(std::move(visited), std::move(length), total);
 }
 
 // removes all edges that have timestamp strictly later than 'point' from the graph
@@ -141,15 +232,16 @@ void STPGraphManager<T>::findExplanation(EdgeRef e, vec<PtAsgn> &v) {
         return;
     }
 
-    std::vector<EdgeRef> visited(store.vertexNum(), EdgeRef_Undef);
-    std::vector<T> length(store.vertexNum());
+    auto &res = explanationSearch;
+    res.reset(store.vertexNum());
     std::stack<VertexRef> open;
 
+    res.reach(expl.from, Converter<T>::getValue(0), EdgeRef_Undef);
     open.push(expl.from);
     while (!open.empty()) {
         auto curr = open.top();
         open.pop();
-        if (curr == expl.to && length[curr.x] <= expl.cost) break;
+        if (curr == expl.to && res.distance[curr.x] <= expl.cost) break;
         for (auto eRef : graph.outgoing[curr.x]) {
             if (eRef == e) continue;
             const Edge<T> &edge = store.getEdge(eRef);
@@ -157,22 +249,21 @@ void STPGraphManager<T>::findExplanation(EdgeRef e, vec<PtAsgn> &v) {
             assert(mapper.getAssignment(eRef) != PtAsgn_Undef); // deductions aren't stored in graph
 
             auto next = edge.to;
-            if (visited[next.x] == EdgeRef_Undef || length[next.x] > length[curr.x] + edge.cost) {
-                visited[next.x] = eRef;
-                length[next.x] = length[curr.x] + edge.cost;
+            if (!res.isReached(next) || res.distance[next.x] > res.distance[curr.x] + edge.cost) {
+                res.reach(next, res.distance[curr.x] + edge.cost, eRef);
                 open.push(next);
             }
         }
     }
 
-    auto backtrack = visited[expl.to.x];
+    auto backtrack = res.pred[expl.to.x];
     while (true) {
         assert(backtrack != EdgeRef_Undef);
         const Edge<T> &edge = store.getEdge(backtrack);
         assert(mapper.getAssignment(backtrack) != PtAsgn_Undef);
         v.push(mapper.getAssignment(backtrack));
         if (edge.from == expl.from) break;
-        backtrack = visited[edge.from.x];
+        backtrack = res.pred[edge.from.x];
     }
 }
 
@@ -180,6 +271,8 @@ template<class T>
 void STPGraphManager<T>::clear() {
     timestamp = 0;
     graph.clear();
+    potential.clear();
+    negativeCycle.clear();
 }
 
 }
@@ -8,10 +8,12 @@
 
 namespace opensmt {
 // holds the mapping from vertices to their values
+// the values are read off the potential function maintained by the graph manager, which is feasible for its graph
 template<class T>
 class STPModel {
 public:
-    STPModel(STPStore<T> & store, EdgeGraph graph) : store(store), graph(std::move(graph)) {}
+    STPModel(STPStore<T> const & store, STPGraphManager<T> const & graphMgr)
+        : store(store), graphMgr(graphMgr), graph(graphMgr.getGraph()) {}
 
     void createModel();
 
@@ -28,15 +30,12 @@ public:
 private:
     std::vector<VertexRef> vertsInGraph() const;
 
-    VertexRef addStartingPoint();
-
-    void bellmanFord(VertexRef start);
-
     void shiftZero();
 
-    STPStore<T> & store;
+    STPStore<T> const & store;
+    STPGraphManager<T> const & graphMgr;
     EdgeGraph graph;
-    std::unordered_map<uint32_t, T> valMap; // for each vertex, distance from the added starting vertex
+    std::unordered_map<uint32_t, T> valMap; // for each vertex, its potential (a valid assignment is its inverse)
 };
 } // namespace opensmt
 
@@ -3,9 +3,6 @@
 
 #include "STPModel.h"
 
-#include <memory>
-#include <queue>
-
 namespace opensmt {
 
 // returns a list of all vertices present in graph
@@ -28,41 +25,6 @@ std::vector<VertexRef> STPModel<T>::vertsInGraph() const {
     return found;
 }
 
-// creates a common point from which to start the search, and connects it to all vertices in graph
-template<class T>
-VertexRef STPModel<T>::addStartingPoint() {
-    VertexRef start = store.createVertex();
-
-    for (VertexRef v : vertsInGraph()) {
-        EdgeRef eRef = store.createEdge(start, v, Converter<T>::getValue(0));
-        graph.addEdge(eRef, start, v);
-    }
-
-    return start;
-}
-
-template<class T>
-void STPModel<T>::bellmanFord(VertexRef start) {
-    std::unordered_map<uint32_t, T> dist;
-    std::queue<VertexRef> open;
-    dist.emplace(start.x, 0);
-    open.push(start);
-
-    while (!open.empty()) {
-        VertexRef v = open.front();
-        open.pop();
-        for (auto eRef : graph.outgoing[v.x]) {
-            const Edge<T> &edge = store.getEdge(eRef);
-            if (!dist.count(edge.to.x) || dist[edge.to.x] > dist[v.x] + edge.cost) {
-                dist[edge.to.x] = dist[v.x] + edge.cost;
-                open.push(edge.to);
-            }
-        }
-    }
-
-    valMap = std::move(dist);
-}
-
 // shifts 'valMap' values so that valMap[zero] == 0
 template<class T>
 void STPModel<T>::shiftZero() {
@@ -78,8 +40,10 @@ void STPModel<T>::shiftZero() {
 template<class T>
 void STPModel<T>::createModel() {
     if (graph.isEmpty()) { return; }
-    VertexRef start = addStartingPoint();
-    bellmanFord(start);
+    // pi(to) <= pi(from) + cost holds for each edge in graph, so the potential needs no further search
+    for (VertexRef v : vertsInGraph()) {
+        valMap.emplace(v.x, graphMgr.getPotential(v));
+    }
     shiftZero();
 }
 
@@ -68,6 +68,9 @@ private:
 
     size_t inv_bpoint; // backtrack point where we entered an inconsistent state
     PtAsgn inv_asgn;
+    bool inv_cycle;    // inconsistency was found as a negative cycle by the potential update, not by propagation
+
+    std::vector<EdgeRef> toPropagate; // asserted edges whose consequences are searched for in the next 'check'
 
     std::unique_ptr<STPModel<T>> model; // mapping of vertices (vars) to valid assignments, if it was computed
 };
@@ -7,6 +7,8 @@
 #include "STPSolver.h"
 #include "Converter.h"
 
+#include <algorithm>
+
 namespace opensmt {
 
 static SolverDescr descr_stp_solver("STP Solver", "Solver for Simple Temporal Problem (Difference Logic)");
@@ -16,7 +18,7 @@ STPSolver<T>::STPSolver(SMTConfig &c, ArithLogic &l)
         : TSolver((SolverId) descr_stp_solver, (const char *) descr_stp_solver, c), logic(l),
           mapper(l, store)          // store is initialized before mapper and graph, so these constructors are valid
         , graphMgr(store, mapper)   // similarly, mapper is initialized before graph (per declaration in header)
-        , inv_bpoint(-1), inv_asgn(PtAsgn_Undef) {}
+        , inv_bpoint(-1), inv_asgn(PtAsgn_Undef), inv_cycle(false) {}
 
 template<class T>
 typename STPSolver<T>::ParsedPTRef STPSolver<T>::parseRef(PTRef ref) const {
@@ -122,23 +124,21 @@ bool STPSolver<T>::assertLit(PtAsgn asgn) {
         return false;
     }
 
-    // The assignment isn't decided yet, so we set it as true and find all of its consequences
+    // The assignment isn't decided yet; if it doesn't close a negative cycle, we set it as true
+    if (!graphMgr.updatePotential(set)) {
+        inv_bpoint = backtrack_points.size();
+        inv_asgn = asgn;
+        inv_cycle = true;
+        has_explanation = true;
+        return false;
+    }
     graphMgr.setTrue(set, asgn);
-    std::vector<EdgeRef> deductions = graphMgr.findConsequences(set);
+    // the search for consequences of the edge is postponed to 'check', where it is done for all pending edges at once
+    toPropagate.push_back(set);
 
-    // pass all found deductions to TSolver
     PTRef nleq = mapper.getPTRef(nset);
     if (nleq != PTRef_Undef)
         storeDeduction(PtAsgn_reason(nleq, l_False, PTRef_Undef));
-
-    for (auto eRef : deductions) {
-        PTRef leq = mapper.getPTRef(eRef);
-        nleq = mapper.getPTRef(store.getNegation(eRef));
-        if (leq != PTRef_Undef && !hasPolarity(leq))
-            storeDeduction(PtAsgn_reason(leq, l_True, PTRef_Undef));
-        if (nleq != PTRef_Undef && !hasPolarity(nleq))
-            storeDeduction(PtAsgn_reason(nleq, l_False, PTRef_Undef));
-    }
     return true;
 }
 
@@ -148,12 +148,32 @@ TRes STPSolver<T>::check(bool) {
     // Return SAT if the current set of constraints is satisfiable, UNSAT if unsatisfiable
 
     // we check the validity of each assertLit, so this just returns the consistency of current state
-    return inv_asgn == PtAsgn_Undef ? TRes::SAT : TRes::UNSAT;
+    if (inv_asgn != PtAsgn_Undef) {
+        toPropagate.clear();
+        return TRes::UNSAT;
+    }
+
+    auto bound = static_cast<size_t>(std::max(config.dl_propagation_bound(), 0));
+    for (EdgeRef e : toPropagate) {
+        std::vector<EdgeRef> deductions = graphMgr.findConsequences(e, bound);
+        // pass all found deductions to TSolver
+        for (auto eRef : deductions) {
+            PTRef leq = mapper.getPTRef(eRef);
+            PTRef nleq = mapper.getPTRef(store.getNegation(eRef));
+            if (leq != PTRef_Undef && !hasPolarity(leq))
+                storeDeduction(PtAsgn_reason(leq, l_True, PTRef_Undef));
+            if (nleq != PTRef_Undef && !hasPolarity(nleq))
+                storeDeduction(PtAsgn_reason(nleq, l_False, PTRef_Undef));
+        }
+    }
+    toPropagate.clear();
+    return TRes::SAT;
 }
 
 template<class T>
 void STPSolver<T>::clearSolver() {
     TSolver::clearSolver();
+    toPropagate.clear();
     graphMgr.clear();
     mapper.clear();
     store.clear();
@@ -183,8 +203,10 @@ void STPSolver<T>::popBacktrackPoints(unsigned int i) {
     if (inv_bpoint > backtrack_points.size_() - i) {  // if we returned back to a consistent state, we reset inv_bpoint
         inv_bpoint = 0;
         inv_asgn = PtAsgn_Undef;
+        inv_cycle = false;
         has_explanation = false;
     }
+    toPropagate.clear(); // pending edges may be removed below; skipping their propagation is sound
 
     backtrack_points.shrink(i - 1); // pop 'i-1' values from the backtrack stack
     graphMgr.removeAfter(backtrack_points.last());
@@ -202,7 +224,7 @@ void STPSolver<T>::computeModel() {
         return;
     }
     // In case of satisfiability prepare a model witnessing the satisfiability of the current set of constraints
-    model = std::unique_ptr<STPModel<T>>(new STPModel<T>(store, graphMgr.getGraph()));
+    model = std::make_unique<STPModel<T>>(store, graphMgr);
     model->createModel();
 }
 
@@ -210,6 +232,13 @@ template<class T>
 void STPSolver<T>::getConflict(vec<PtAsgn> & conflict) {
     if (inv_asgn == PtAsgn_Undef) return;
     conflict.push(inv_asgn);
+    if (inv_cycle) {
+        for (EdgeRef e : graphMgr.getNegativeCycle()) {
+            assert(mapper.getAssignment(e) != PtAsgn_Undef);
+            conflict.push(mapper.getAssignment(e));
+        }
+        return;
+    }
     EdgeRef e = mapper.getEdgeRef(inv_asgn.tr);
     if (inv_asgn.sgn == l_True) {
         e = store.getNegation(e);
@@ -9,6 +9,9 @@
 #include <logics/Logic.h>
 #include <smtsolvers/ResolutionProof.h>
 
+#include <algorithm>
+#include <iterator>
+#include <numeric>
 #include <unordered_set>
 #include <vector>
 
@@ -22,8 +25,13 @@ std::unique_ptr<UnsatCore> UnsatCoreBuilder::build() {
 }
 
 void UnsatCoreBuilder::buildBody() {
-    computeClauses();
-    computeTerms();
+    if (proof) {
+        computeClauses();
+        computeTerms();
+    } else if (terms.size() == 0) {
+        // unsatisfiable only under the assumptions of the query
+        return;
+    }
     computeNamedTerms();
 
     if (config.minimal_unsat_cores()) { minimize(); }
@@ -37,7 +45,7 @@ std::unique_ptr<UnsatCore> UnsatCoreBuilder::buildReturn() {
 void UnsatCoreBuilder::computeClauses() {
     clauses.clear();
 
-    auto const & derivations = proof.getProof();
+    auto const & derivations = proof->getProof();
     std::vector<CRef> stack;
     stack.push_back(CRef_Undef);
     std::unordered_set<CRef> processed;
@@ -66,11 +74,11 @@ void UnsatCoreBuilder::computeTerms() {
 
     Partitions partitions;
     for (CRef cref : clauses) {
-        auto const & partition = partitionManager.getClauseClassMask(cref);
+        auto const & partition = partitionManager->getClauseClassMask(cref);
         orbit(partitions, partitions, partition);
     }
 
-    terms = partitionManager.getPartitions(partitions);
+    terms = partitionManager->getPartitions(partitions);
 }
 
 void UnsatCoreBuilder::computeNamedTerms() {
@@ -118,7 +126,12 @@ std::unique_ptr<UnsatCoreBuilder::SMTSolver> UnsatCoreBuilder::newSmtSolver(SMTC
 
 void UnsatCoreBuilder::minimize() {
     minimizeInit();
-    minimizeAlg();
+    // this algorithm will minimize the contents of the `candidates` vector
+    if (candidates.size() == 0) { return; }
+
+    SMTConfig smtSolverConfig = makeSmtSolverConfig();
+    std::unique_ptr<SMTSolver> smtSolverPtr = newSmtSolver(smtSolverConfig);
+    minimizeAlg(*smtSolverPtr);
     minimizeFinish();
 }
 
@@ -126,81 +139,151 @@ void UnsatCoreBuilder::minimizeInit() {
     assert(terms.size() > 0);
     assert(terms.size() >= namedTerms.size());
     assert(size_t(namedTerms.size()) == namedTermsIdxs.size());
-}
 
-void UnsatCoreBuilder::minimizeAlgNaive() {
-    bool const fullCore = config.print_cores_full();
-
-    // this algorithm will minimize the contents of the `namedTerms` vector
-
-    if (fullCore) {
+    hardTerms.clear();
+    candidates.clear();
+    if (config.print_cores_full()) {
         // special case: we don't care about named terms, hence we must minimize everything
         assert(namedTerms.size() == 0);
-        std::swap(terms, namedTerms);
-        assert(namedTerms.size() > 0);
-    } else if (namedTerms.size() == 0) {
+        terms.copyTo(candidates);
         return;
     }
 
-    SMTConfig smtSolverConfig = makeSmtSolverConfig();
-    std::unique_ptr<SMTSolver> smtSolverPtr = newSmtSolver(smtSolverConfig);
-
-    decltype(terms) newTerms;
-    if (not fullCore) {
-        // the default: we focus on named terms -> we must distinguish between `namedTerms` and the others in `terms`
-        auto const namedTermsIdxsEnd = namedTermsIdxs.end();
-        auto const isNamedTerm = [namedTermsIdxsEnd](size_t idx, auto namedTermsIdxsIt) {
-            if (namedTermsIdxsIt == namedTermsIdxsEnd) { return false; }
-            assert(idx <= *namedTermsIdxsIt);
-            return (idx == *namedTermsIdxsIt);
-        };
-
-        size_t const termsSize = terms.size();
-        for (auto [idx, namedTermsIdxsIt] = std::tuple{size_t{0}, namedTermsIdxs.begin()}; idx < termsSize; ++idx) {
-            if (isNamedTerm(idx, namedTermsIdxsIt)) {
-                ++namedTermsIdxsIt;
-                continue;
-            }
-            // the term that we do not care about -> can be hard-asserted
-            PTRef term = terms[idx];
-            smtSolverPtr->insertFormula(term);
-            newTerms.push(term);
+    // the default: we focus on named terms, the others can be hard-asserted
+    auto namedTermsIdxsIt = namedTermsIdxs.begin();
+    size_t const termsSize = terms.size();
+    for (size_t idx = 0; idx < termsSize; ++idx) {
+        if (namedTermsIdxsIt != namedTermsIdxs.end() and idx == *namedTermsIdxsIt) {
+            ++namedTermsIdxsIt;
+            candidates.push(terms[idx]);
+        } else {
+            hardTerms.push(terms[idx]);
         }
     }
+}
 
-    // minimize the contents of the `namedTerms` vector (given the already asserted hard constraints)
-
-    decltype(namedTerms) newNamedTerms;
-    size_t const namedTermsSize = namedTerms.size();
-    for (size_t namedIdx = 0; namedIdx < namedTermsSize; ++namedIdx) {
-        smtSolverPtr->push();
-
-        // try to ignore namedTerms[namedIdx]
-
-        for (size_t keptNamedIdx = namedIdx + 1; keptNamedIdx < namedTermsSize; ++keptNamedIdx) {
-            PTRef term = namedTerms[keptNamedIdx];
-            smtSolverPtr->insertFormula(term);
-        }
+void UnsatCoreBuilder::minimizeAlg(SMTSolver & smtSolver) {
+    for (PTRef term : hardTerms) {
+        smtSolver.insertFormula(term);
+    }
 
-        sstat const res = smtSolverPtr->check();
-        assert(res == s_True || res == s_False);
-        bool const isRedundant = (res == s_False);
+    // Each candidate is enabled by assuming its guard, so all the checks share one solver and its learnt clauses
+    guards.clear();
+    guardIdxs.clear();
+    size_t const candidatesSize = candidates.size();
+    for (size_t idx = 0; idx < candidatesSize; ++idx) {
+        PTRef guard = logic.mkBoolVar((".ucore" + std::to_string(idx)).c_str());
+        guards.push(guard);
+        guardIdxs.emplace(guard, idx);
+        smtSolver.insertFormula(logic.mkImpl(guard, candidates[idx]));
+    }
 
-        smtSolverPtr->pop();
+    Candidates all(candidatesSize);
+    std::iota(all.begin(), all.end(), 0);
+    Candidates open;
+    if (not isUnsatAssuming(smtSolver, all, &open)) {
+        assert(false);
+        kept = std::move(all);
+        return;
+    }
+    if (open.empty()) {
+        // the hard terms are unsatisfiable on their own
+        kept.clear();
+        return;
+    }
 
-        if (isRedundant) continue;
+    if (config.minimal_unsat_cores_alg() == 1) {
+        kept = minimizeAlgQuickXplain(smtSolver, {}, false, open);
+        std::sort(kept.begin(), kept.end());
+    } else {
+        kept = minimizeAlgDeletion(smtSolver, std::move(open));
+    }
+}
 
-        // namedTerms[namedIdx] is not redundant - include it
+void UnsatCoreBuilder::minimizeFinish() {
+    bool const fullCore = config.print_cores_full();
 
-        PTRef term = namedTerms[namedIdx];
-        smtSolverPtr->insertFormula(term);
+    decltype(terms) newTerms;
+    decltype(namedTerms) newNamedTerms;
+    hardTerms.copyTo(newTerms);
+    for (size_t idx : kept) {
+        PTRef term = candidates[idx];
         newTerms.push(term);
         if (not fullCore) { newNamedTerms.push(term); }
     }
 
-    assert(not fullCore or newNamedTerms.size() == 0);
     terms = std::move(newTerms);
     namedTerms = std::move(newNamedTerms);
 }
 
+UnsatCoreBuilder::Candidates UnsatCoreBuilder::minimizeAlgDeletion(SMTSolver & smtSolver, Candidates open) {
+    assert(std::is_sorted(open.begin(), open.end()));
+
+    Candidates needed;
+    Candidates assumed;
+    Candidates failed;
+    while (not open.empty()) {
+        // try to ignore the last open candidate
+        size_t const candidate = open.back();
+        open.pop_back();
+
+        assumed = needed;
+        assumed.insert(assumed.end(), open.begin(), open.end());
+        if (isUnsatAssuming(smtSolver, assumed, &failed)) {
+            // the candidate is redundant, and so are the open ones that the check did not need
+            Candidates refined;
+            std::set_intersection(open.begin(), open.end(), failed.begin(), failed.end(), std::back_inserter(refined));
+            open = std::move(refined);
+        } else {
+            needed.push_back(candidate);
+        }
+    }
+
+    std::sort(needed.begin(), needed.end());
+    return needed;
+}
+
+UnsatCoreBuilder::Candidates UnsatCoreBuilder::minimizeAlgQuickXplain(SMTSolver & smtSolver,
+                                                                       Candidates const & background, bool hasDelta,
+                                                                       Candidates const & open) {
+    assert(not open.empty());
+    // the background together with the open candidates is unsatisfiable
+    if (hasDelta and isUnsatAssuming(smtSolver, background)) { return {}; }
+    if (open.size() == 1) { return open; }
+
+    auto const middle = open.begin() + open.size() / 2;
+    Candidates const firstHalf(open.begin(), middle);
+    Candidates const secondHalf(middle, open.end());
+
+    Candidates assumed = background;
+    assumed.insert(assumed.end(), firstHalf.begin(), firstHalf.end());
+    Candidates secondCore = minimizeAlgQuickXplain(smtSolver, assumed, true, secondHalf);
+
+    assumed = background;
+    assumed.insert(assumed.end(), secondCore.begin(), secondCore.end());
+    Candidates core = minimizeAlgQuickXplain(smtSolver, assumed, not secondCore.empty(), firstHalf);
+
+    core.insert(core.end(), secondCore.begin(), secondCore.end());
+    return core;
+}
+
+bool UnsatCoreBuilder::isUnsatAssuming(SMTSolver & smtSolver, Candidates const & assumed, Candidates * failed) {
+    vec<PTRef> assumptions;
+    for (size_t idx : assumed) {
+        assumptions.push(guards[idx]);
+    }
+    sstat const res = smtSolver.checkAssuming(assumptions);
+    assert(res == s_True || res == s_False);
+    if (res != s_False) { return false; }
+
+    if (failed) {
+        failed->clear();
+        for (PTRef guard : smtSolver.getUnsatAssumptions()) {
+            failed->push_back(guardIdxs.at(guard));
+        }
+        std::sort(failed->begin(), failed->end());
+    }
+    return true;
+}
+
 } // namespace opensmt
@@ -7,6 +7,7 @@
 #include <options/SMTConfig.h>
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace opensmt {
@@ -28,9 +29,16 @@ public:
                      TermNames const & names)
         : config{conf},
           logic{logic_},
-          proof{proof_},
-          partitionManager{pmanager},
+          proof{&proof_},
+          partitionManager{&pmanager},
           termNames{names} {}
+    // The terms of the core are already known, e.g. from the failed assumptions; they are only named and minimized
+    UnsatCoreBuilder(SMTConfig const & conf, Logic & logic_, vec<PTRef> const & coreTerms, TermNames const & names)
+        : config{conf},
+          logic{logic_},
+          termNames{names} {
+        coreTerms.copyTo(terms);
+    }
 
     std::unique_ptr<UnsatCore> build();
 
@@ -50,15 +58,23 @@ protected:
     void minimize();
 
     void minimizeInit();
-    void minimizeAlg() { minimizeAlgNaive(); }
-    void minimizeFinish() {}
+    void minimizeAlg(SMTSolver &);
+    void minimizeFinish();
+
+    using Candidates = std::vector<size_t>; // Indices into `candidates`
 
-    void minimizeAlgNaive();
+    // Drops the candidates one by one, each unsatisfiable check also drops the candidates outside its failed assumptions
+    Candidates minimizeAlgDeletion(SMTSolver &, Candidates open);
+    // QuickXplain: splits the candidates in halves, which needs a logarithmic number of checks per element of the core
+    Candidates minimizeAlgQuickXplain(SMTSolver &, Candidates const & background, bool hasDelta, Candidates const & open);
+
+    // Checks the candidates assumed by their guards; if unsatisfiable, `failed` receives the ones that were needed
+    bool isUnsatAssuming(SMTSolver &, Candidates const & assumed, Candidates * failed = nullptr);
 
     SMTConfig const & config;
     Logic & logic;
-    Proof const & proof;
-    PartitionManager const & partitionManager;
+    Proof const * proof{nullptr};
+    PartitionManager const * partitionManager{nullptr};
     TermNames const & termNames;
 
     vec<CRef> clauses{};
@@ -66,6 +82,13 @@ protected:
     vec<PTRef> namedTerms{};
 
     std::vector<size_t> namedTermsIdxs{};
+
+    // Minimization: the terms that are asserted as they are and the ones that are minimized, each behind its guard
+    vec<PTRef> hardTerms{};
+    vec<PTRef> candidates{};
+    vec<PTRef> guards{};
+    std::unordered_map<PTRef, size_t, PTRefHash> guardIdxs{};
+    Candidates kept{};
 };
 
 } // namespace opensmt
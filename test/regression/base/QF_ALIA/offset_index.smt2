@@ -0,0 +1,14 @@
+(set-logic QF_ALIA)
+(declare-fun a () (Array Int Int))
+(declare-fun b () (Array Int Int))
+(declare-fun x () Int)
+(declare-fun y () Int)
+(declare-fun z () Int)
+(assert (<= (- y x) 1))
+(assert (>= (- y x) 1))
+(assert (= b (store a y 7)))
+(assert (= (select a z) (select b (+ z 1))))
+(check-sat)
+(assert (not (= (select b (+ x 1)) 7)))
+(check-sat)
+(exit)
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <api/MainSolver.h>
+#include <logics/BVLogic.h>
+#include <tsolvers/bvsolver/AigStore.h>
+#include <tsolvers/bvsolver/BitBlaster.h>
+
+namespace opensmt {
+
+class AigStoreTest : public ::testing::Test {
+protected:
+    AigStoreTest()
+        : logic{Logic_t::QF_BOOL},
+          aig(logic),
+          a(logic.mkBoolVar("a")),
+          b(logic.mkBoolVar("b")),
+          c(logic.mkBoolVar("c")) {}
+
+    Lit encode(AigLit root, std::vector<vec<Lit>> & clauses) {
+        return aig.encode(
+            root, [this](PTRef atom) { return mkLit(inputVar(atom)); }, [this]() { return mkLit(nextGateVar++); }, clauses);
+    }
+
+    Var inputVar(PTRef atom) const { return atom == a ? 0 : atom == b ? 1 : 2; }
+
+    Logic logic;
+    AigStore aig;
+    PTRef a, b, c;
+    Var nextGateVar = 3;
+};
+
+TEST_F(AigStoreTest, test_StructuralHashing) {
+    AigLit la = aig.mkInput(a), lb = aig.mkInput(b);
+    AigLit ab = aig.mkAnd(la, lb);
+    EXPECT_EQ(aig.mkAnd(lb, la), ab);
+    EXPECT_EQ(aig.getNumStrashHits(), 1u);
+    EXPECT_EQ(aig.fromTerm(logic.mkAnd(b, a)), ab);
+    EXPECT_EQ(aig.fromTerm(logic.mkNot(logic.mkOr(logic.mkNot(a), logic.mkNot(b)))), ab);
+    EXPECT_EQ(aig.getNumNodes(), 4u);
+}
+
+TEST_F(AigStoreTest, test_TwoLevelRewriting) {
+    AigLit la = aig.mkInput(a), lb = aig.mkInput(b), lc = aig.mkInput(c);
+    AigLit ab = aig.mkAnd(la, lb);
+    EXPECT_EQ(aig.mkAnd(ab, ~la), AigLit_False);                         // Contradiction
+    EXPECT_EQ(aig.mkAnd(ab, lb), ab);                                    // Idempotence
+    EXPECT_EQ(aig.mkAnd(~ab, ~la), ~la);                                 // Subsumption
+    EXPECT_EQ(aig.mkAnd(~ab, la), aig.mkAnd(~lb, la));                   // Substitution
+    EXPECT_EQ(aig.mkAnd(~aig.mkAnd(la, lc), ~aig.mkAnd(la, ~lc)), ~la); // Resolution
+    EXPECT_GT(aig.getNumRewrites(), 0u);
+}
+
+TEST_F(AigStoreTest, test_SharedConeEncodedOnce) {
+    std::size_t const terms = logic.getNumberOfTerms();
+    AigLit la = aig.mkInput(a), lb = aig.mkInput(b), lc = aig.mkInput(c);
+    AigLit ab = aig.mkAnd(la, lb);
+    std::vector<vec<Lit>> clauses;
+    Lit first = encode(aig.mkAnd(ab, lc), clauses);
+    EXPECT_EQ(clauses.size(), 6u);
+    clauses.clear();
+    Lit second = encode(aig.mkAnd(~ab, lc), clauses);
+    EXPECT_EQ(clauses.size(), 3u);
+    EXPECT_NE(first, second);
+    clauses.clear();
+    EXPECT_EQ(encode(~ab, clauses), ~encode(ab, clauses));
+    EXPECT_TRUE(clauses.empty());
+    EXPECT_EQ(aig.getNumEncodedGates(), 3u);
+    // The literals of the gates come from the caller, the graph does not build terms
+    EXPECT_EQ(logic.getNumberOfTerms(), terms);
+}
+
+class BitBlasterAigTest : public ::testing::Test {
+protected:
+    BitBlasterAigTest()
+        : logic{Logic_t::QF_UF, 4},
+          solver(logic, config, "test"),
+          blaster(SolverId{0}, config, solver, logic, explanation, suggestions),
+          x(logic.mkBVNumVar("x")) {}
+
+    lbool insertEq(PTRef lhs, PTRef rhs) {
+        BVRef out;
+        return blaster.insertEq(logic.mkBVEq(lhs, rhs), out);
+    }
+
+    BVLogic logic;
+    SMTConfig config;
+    MainSolver solver;
+    vec<PtAsgn> explanation;
+    vec<PTRef> suggestions;
+    BitBlaster blaster;
+    PTRef x;
+};
+
+TEST_F(BitBlasterAigTest, test_InsertedBitsArePoppedWithFrame) {
+    solver.push();
+    ASSERT_NE(insertEq(x, logic.mkBVConst(3)), l_False);
+    ASSERT_NE(insertEq(x, logic.mkBVConst(5)), l_False);
+    EXPECT_EQ(solver.check(), s_False);
+    ASSERT_TRUE(solver.pop());
+    EXPECT_EQ(solver.check(), s_True);
+}
+
+TEST_F(BitBlasterAigTest, test_GatesSharedAcrossFrames) {
+    solver.push();
+    ASSERT_NE(insertEq(x, logic.mkBVConst(3)), l_False);
+    EXPECT_EQ(solver.check(), s_True);
+    ASSERT_TRUE(solver.pop());
+    int const clausesBefore = solver.getSMTSolver().nClauses();
+    solver.push();
+    // The gates of the equality are already defined, only the guarded root is new
+    ASSERT_NE(insertEq(x, logic.mkBVConst(3)), l_False);
+    EXPECT_LE(solver.getSMTSolver().nClauses(), clausesBefore + 1);
+    ASSERT_NE(insertEq(x, logic.mkBVConst(5)), l_False);
+    EXPECT_EQ(solver.check(), s_False);
+    ASSERT_TRUE(solver.pop());
+    EXPECT_EQ(solver.check(), s_True);
+}
+
+} // namespace opensmt
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <common/ApiException.h>
+#include <logics/Logic.h>
+
+#include <thread>
+#include <vector>
+
+namespace opensmt {
+
+class ConcurrentTermsTest : public ::testing::Test {
+protected:
+    ConcurrentTermsTest() : logic{Logic_t::QF_UF} {
+        SRef U = logic.declareUninterpretedSort("U");
+        f = logic.declareFun("f", U, {U, U});
+        for (int i = 0; i < 20; ++i) {
+            vars.push_back(logic.mkVar(U, ("x" + std::to_string(i)).c_str()));
+            bools.push_back(logic.mkBoolVar(("b" + std::to_string(i)).c_str()));
+        }
+    }
+
+    // The same formula for the same seed, built from many shared subterms
+    PTRef build(int seed) {
+        vec<PTRef> conjuncts;
+        for (int i = 0; i < 20; ++i) {
+            for (int j = 0; j < 20; ++j) {
+                PTRef app = logic.mkUninterpFun(f, {vars[i], vars[(i * j + seed) % 20]});
+                PTRef eq = logic.mkEq(app, vars[j]);
+                conjuncts.push(logic.mkOr(eq, logic.mkNot(bools[(i + j) % 20])));
+            }
+        }
+        return logic.mkAnd(std::move(conjuncts));
+    }
+
+    Logic logic;
+    SymRef f;
+    std::vector<PTRef> vars;
+    std::vector<PTRef> bools;
+};
+
+TEST_F(ConcurrentTermsTest, test_SameTermsFromAllThreads) {
+    constexpr int numThreads = 4;
+    constexpr int numFormulas = 8;
+    std::vector<std::vector<PTRef>> results(numThreads);
+    logic.beginConcurrentConstruction(100000, 300000);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([this, t, &results]() {
+            for (int k = 0; k < numFormulas; ++k) {
+                results[t].push_back(build((k + t) % numFormulas));
+            }
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    logic.endConcurrentConstruction();
+
+    for (int t = 0; t < numThreads; ++t) {
+        for (int k = 0; k < numFormulas; ++k) {
+            // Each formula was hash-consed to a single term, which sequential construction finds again
+            EXPECT_EQ(results[t][k], results[0][(k + t) % numFormulas]);
+            EXPECT_EQ(results[t][k], build((k + t) % numFormulas));
+        }
+    }
+}
+
+TEST_F(ConcurrentTermsTest, test_ChildrenHaveSmallerIds) {
+    logic.beginConcurrentConstruction(100000, 300000);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([this, t]() { build(t); });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+    logic.endConcurrentConstruction();
+    PTRef root = build(1);
+    std::vector<PTRef> queue{root};
+    while (not queue.empty()) {
+        PTRef tr = queue.back();
+        queue.pop_back();
+        for (PTRef child : logic.getPterm(tr)) {
+            ASSERT_LT(Idx(logic.getPterm(child).getId()), Idx(logic.getPterm(tr).getId()));
+            queue.push_back(child);
+        }
+    }
+    // Construction continues sequentially afterwards
+    PTRef fresh = logic.mkAnd(root, logic.mkBoolVar("fresh"));
+    EXPECT_TRUE(logic.isAnd(fresh));
+}
+
+TEST_F(ConcurrentTermsTest, test_NoNewNullaryTerms) {
+    logic.beginConcurrentConstruction(1000, 1000);
+    EXPECT_THROW(logic.mkBoolVar("new"), ApiException);
+    logic.endConcurrentConstruction();
+}
+
+TEST_F(ConcurrentTermsTest, test_NoNewSymbolsSortsOrDistinctions) {
+    SRef U = logic.declareUninterpretedSort("U");
+    logic.beginConcurrentConstruction(1000, 1000);
+    EXPECT_EQ(logic.mkBoolVar("b0"), bools[0]);
+    EXPECT_EQ(logic.declareFun("f", U, {U, U}), f);
+    EXPECT_EQ(logic.declareUninterpretedSort("U"), U);
+    EXPECT_THROW(logic.declareFun("g", U, {U}), ApiException);
+    EXPECT_THROW(logic.declareUninterpretedSort("V"), ApiException);
+    EXPECT_THROW(logic.mkDistinct({vars[0], vars[1], vars[2]}), ApiException);
+    EXPECT_THROW(logic.mkUniqueAbstractValue(U), ApiException);
+    logic.endConcurrentConstruction();
+    EXPECT_FALSE(logic.hasSym("g"));
+}
+
+namespace {
+// Formulas of groups that share no terms with each other
+class GroupedProblem {
+public:
+    GroupedProblem() : logic{Logic_t::QF_UF} {
+        SRef U = logic.declareUninterpretedSort("U");
+        f = logic.declareFun("f", U, {U, U});
+        for (int i = 0; i < 4 * numGroups; ++i) {
+            vars.push_back(logic.mkVar(U, ("x" + std::to_string(i)).c_str()));
+            bools.push_back(logic.mkBoolVar(("b" + std::to_string(i)).c_str()));
+        }
+    }
+
+    PTRef build(int group) {
+        vec<PTRef> conjuncts;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                PTRef app = logic.mkUninterpFun(f, {vars[4 * group + i], vars[4 * group + (i + j) % 4]});
+                PTRef eq = logic.mkEq(app, vars[4 * group + j]);
+                conjuncts.push(logic.mkOr(eq, logic.mkNot(bools[4 * group + (i * j) % 4])));
+            }
+        }
+        return logic.mkAnd(std::move(conjuncts));
+    }
+
+    static constexpr int numGroups = 5;
+    Logic logic;
+    SymRef f;
+    std::vector<PTRef> vars;
+    std::vector<PTRef> bools;
+};
+}
+
+TEST(ConcurrentTermsGroupsTest, test_SameReferencesAsSequentialConstruction) {
+    GroupedProblem sequential;
+    vec<PTRef> expected;
+    for (int g = 0; g < GroupedProblem::numGroups; ++g) {
+        expected.push(sequential.build(g));
+    }
+    for (int round = 0; round < 3; ++round) {
+        GroupedProblem concurrent;
+        vec<PTRef> results;
+        results.growTo(GroupedProblem::numGroups, PTRef_Undef);
+        concurrent.logic.beginConcurrentConstruction(100000, 300000);
+        std::vector<std::thread> threads;
+        // Build the groups in reverse order of their indices, the order of the groups decides the references
+        for (int g = GroupedProblem::numGroups - 1; g >= 0; --g) {
+            threads.emplace_back([&concurrent, &results, g]() {
+                concurrent.logic.setConcurrentGroup(static_cast<uint32_t>(g));
+                results[g] = concurrent.build(g);
+            });
+        }
+        for (auto & thread : threads) {
+            thread.join();
+        }
+        concurrent.logic.endConcurrentConstruction(results);
+        for (int g = 0; g < GroupedProblem::numGroups; ++g) {
+            EXPECT_EQ(results[g], expected[g]);
+            EXPECT_EQ(concurrent.logic.pp(results[g]), sequential.logic.pp(expected[g]));
+        }
+        EXPECT_EQ(concurrent.logic.getNumberOfTerms(), sequential.logic.getNumberOfTerms());
+    }
+}
+
+} // namespace opensmt
@@ -7,6 +7,7 @@
 #include <gtest/gtest.h>
 #include <tsolvers/egraph/Egraph.h>
 #include <common/TreeOps.h>
+#include <logics/ArithLogic.h>
 
 namespace opensmt {
 
@@ -142,4 +143,49 @@ TEST_F(EgraphTest, test_IncrementalAddition) {
     ASSERT_EQ(egraph.check(true), TRes::SAT);
 }
 
+TEST(EgraphOffsetTest, test_OffsetEquality) {
+    ArithLogic logic{Logic_t::QF_UFLIA};
+    SMTConfig c;
+    Egraph egraph(c, logic);
+    PTRef x = logic.mkIntVar("x"); // Not known to the egraph
+    PTRef y = logic.mkIntVar("y");
+    PTRef p = logic.mkIntVar("p");
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    SymRef f = logic.declareFun("f", logic.getSort_int(), {logic.getSort_int()});
+
+    PTRef eq = logic.mkEq(logic.mkUninterpFun(f, {p}), logic.mkUninterpFun(f, {y}));
+    egraph.declareAtom(eq);
+    egraph.pushBacktrackPoint();
+    ASSERT_TRUE(egraph.assertLit({eq, l_False}));
+
+    auto because = [](PtAsgn lit, int & asked) {
+        return [lit, &asked](vec<PtAsgn> & reason) { ++asked; reason.push(lit); };
+    };
+    int askedA = 0, askedB = 0, askedC = 0;
+    // p = x + 1 and y = x + 1 imply p = y, and hence f(p) = f(y)
+    egraph.addOffsetRelation(p, x, 1, because(PtAsgn(a, l_True), askedA));
+    egraph.addOffsetRelation(x, y, -1, because(PtAsgn(b, l_True), askedB));
+    // Does not lead to a merge, so it is not explained
+    egraph.addOffsetRelation(logic.mkIntVar("z"), x, 3, because(PtAsgn(logic.mkBoolVar("c"), l_True), askedC));
+    ASSERT_FALSE(egraph.propagateOffsetEqualities());
+    EXPECT_EQ(askedA, 1);
+    EXPECT_EQ(askedB, 1);
+    EXPECT_EQ(askedC, 0);
+
+    vec<PtAsgn> expl;
+    egraph.getConflict(expl);
+    ASSERT_EQ(expl.size(), 3);
+    for (auto pta : vec<PtAsgn>{{eq, l_False}, {a, l_True}, {b, l_True}}) {
+        ASSERT_NE(std::find(expl.begin(), expl.end(), pta), expl.end());
+    }
+
+    egraph.popBacktrackPoint();
+    egraph.pushBacktrackPoint();
+    egraph.addOffsetRelation(p, x, 1, because(PtAsgn(a, l_True), askedA));
+    egraph.addOffsetRelation(y, x, 2, because(PtAsgn(b, l_True), askedB));
+    ASSERT_TRUE(egraph.propagateOffsetEqualities());
+    ASSERT_TRUE(egraph.assertLit({eq, l_False}));
+}
+
 }
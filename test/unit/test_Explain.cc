@@ -51,12 +51,12 @@ TEST_F(UFExplainTest, test_UFExplain) {
     PTRef eq7 = logic.mkEq(f_c1_c0.tr, c1.tr);
 
     Explainer explainer(store);
-    explainer.storeExplanation(c2.er, c1.er, {eq1, l_True});
-    explainer.storeExplanation(f_f_c2_c0_c0.er, c0.er, {eq3, l_True});
-    explainer.storeExplanation(c1.er, f_c1_c0.er, {eq7, l_True});
-    explainer.storeExplanation(f_c1_c0.er, f_f_c2_c0_c0.er, PtAsgn_Undef);
+    explainer.storeExplanation(c2.er, c1.er, ExpReason({eq1, l_True}));
+    explainer.storeExplanation(f_f_c2_c0_c0.er, c0.er, ExpReason({eq3, l_True}));
+    explainer.storeExplanation(c1.er, f_c1_c0.er, ExpReason({eq7, l_True}));
+    explainer.storeExplanation(f_c1_c0.er, f_f_c2_c0_c0.er, ExpReason());
     ASSERT_THROW(explainer.explain(c1.er, f_c2_c0.er), InternalException);
-    explainer.storeExplanation(f_c2_c0.er, f_c1_c0.er, PtAsgn_Undef);
+    explainer.storeExplanation(f_c2_c0.er, f_c1_c0.er, ExpReason());
     ASSERT_NO_THROW(explainer.explain(c1.er, f_c2_c0.er));
     ASSERT_NO_THROW(explainer.explain(c2.er, c0.er));
     std::cout << logic.pp(c2.tr) << " = " << logic.pp(c0.tr) << ": " << std::endl;
@@ -75,4 +75,25 @@ TEST_F(UFExplainTest, test_UFExplain) {
 
 }
 
+TEST_F(UFExplainTest, test_ExternalReason) {
+    PTRef eq1 = logic.mkEq(c2.tr, c1.tr);
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+
+    Explainer explainer(store);
+    explainer.storeExplanation(c2.er, c1.er, ExpReason({eq1, l_True}));
+    ExpReason external = explainer.storeExternalReason({PtAsgn(a, l_True), PtAsgn(b, l_False)});
+    ASSERT_TRUE(external.isExternal());
+    ASSERT_FALSE(external.isLiteral());
+    explainer.storeExplanation(c1.er, c0.er, external);
+
+    auto explanation = explainer.explain(c2.er, c0.er);
+    ASSERT_EQ(explanation.size(), 3);
+    for (PtAsgn lit : {PtAsgn(eq1, l_True), PtAsgn(a, l_True), PtAsgn(b, l_False)}) {
+        ASSERT_NE(std::find(explanation.begin(), explanation.end(), lit), explanation.end());
+    }
+    explainer.removeExplanation();
+    ASSERT_THROW(explainer.explain(c2.er, c0.er), InternalException);
+}
+
 }
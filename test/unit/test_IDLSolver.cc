@@ -112,6 +112,72 @@ TEST_F(IDLSolverTest, test_SimpleTest){
     ASSERT_GT(numY, -2);
 }
 
+TEST_F(IDLSolverTest, test_PropagationBound){
+    PTRef w = logic.mkIntVar("w");
+    PTRef wx = logic.mkLeq(logic.mkMinus(w, x), logic.getTerm_IntZero());
+    PTRef xy = logic.mkLeq(logic.mkMinus(x, y), logic.getTerm_IntZero());
+    PTRef yz = logic.mkLeq(logic.mkMinus(y, z), logic.getTerm_IntZero());
+    PTRef wz = logic.mkLeq(logic.mkMinus(w, z), logic.getTerm_IntZero());
+
+    auto deducesWZ = [&](SMTConfig & conf) {
+        IDLSolver solver(conf, logic);
+        for (PTRef ineq : {wx, xy, yz, wz}) { solver.declareAtom(ineq); }
+        solver.pushBacktrackPoint();
+        for (PTRef ineq : {xy, yz, wx}) {
+            EXPECT_TRUE(solver.assertLit(PtAsgn(ineq, l_True)));
+            EXPECT_EQ(solver.check(false), TRes::SAT);
+        }
+        bool found = false;
+        for (PtAsgn_reason ded = solver.getDeduction(); ded.tr != PTRef_Undef; ded = solver.getDeduction()) {
+            found |= ded.tr == wz and ded.sgn == l_True;
+        }
+        return found;
+    };
+
+    EXPECT_EQ(config.dl_propagation_bound(), 0);
+    EXPECT_TRUE(deducesWZ(config));
+
+    SMTConfig bounded;
+    char const * msg = "ok";
+    EXPECT_FALSE(bounded.setOption(SMTConfig::o_dl_propagation_bound, SMTOption(-1), msg));
+    ASSERT_TRUE(bounded.setOption(SMTConfig::o_dl_propagation_bound, SMTOption(1), msg));
+    EXPECT_EQ(bounded.dl_propagation_bound(), 1);
+    EXPECT_FALSE(deducesWZ(bounded));
+}
+
+TEST_F(IDLSolverTest, test_NegativeCycleConflict){
+    PTRef ineq1 = logic.mkLeq(logic.mkMinus(x, y), logic.getTerm_IntZero());
+    PTRef ineq2 = logic.mkLeq(logic.mkMinus(y, z), logic.getTerm_IntZero());
+    PTRef ineq3 = logic.mkLeq(logic.mkMinus(z, x), logic.mkIntConst(-1));
+
+    IDLSolver solver(config, logic);
+    solver.declareAtom(ineq1);
+    solver.declareAtom(ineq2);
+    solver.declareAtom(ineq3);
+
+    // no check in between, so the cycle is not found by propagation
+    solver.pushBacktrackPoint();
+    ASSERT_TRUE(solver.assertLit(PtAsgn(ineq1, l_True)));
+    ASSERT_TRUE(solver.assertLit(PtAsgn(ineq2, l_True)));
+    ASSERT_FALSE(solver.assertLit(PtAsgn(ineq3, l_True)));
+    ASSERT_EQ(solver.check(true), TRes::UNSAT);
+
+    vec<PtAsgn> conflict;
+    solver.getConflict(conflict);
+    ASSERT_EQ(conflict.size(), 3);
+    for (PTRef ineq : {ineq1, ineq2, ineq3}) {
+        bool found = false;
+        for (PtAsgn asgn : conflict) { found |= asgn == PtAsgn(ineq, l_True); }
+        ASSERT_TRUE(found);
+    }
+
+    solver.popBacktrackPoints(1);
+    solver.pushBacktrackPoint();
+    ASSERT_TRUE(solver.assertLit(PtAsgn(ineq1, l_True)));
+    ASSERT_TRUE(solver.assertLit(PtAsgn(ineq3, l_True)));
+    ASSERT_EQ(solver.check(true), TRes::SAT);
+}
+
 class SafeIntTest : public ::testing::Test {};
 
 TEST_F(SafeIntTest, test_add_pass){
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <api/Interpret.h>
+#include <parsers/smt2new/smt2mappedlexer.h>
+#include <parsers/smt2new/smt2newcontext.h>
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace opensmt {
+
+namespace {
+std::vector<std::string_view> textsOf(Smt2MappedLexer & lexer) {
+    std::vector<std::string_view> texts;
+    for (auto token = lexer.next(); token.kind != 0; token = lexer.next()) {
+        EXPECT_NE(token.kind, Smt2MappedLexer::invalidToken) << lexer.getError();
+        texts.push_back(token.text);
+    }
+    return texts;
+}
+}
+
+TEST(MappedLexerTest, test_TokensViewTheInput) {
+    std::string const input = "(assert (= x -12 3.5 #x1F |a b| \"s\\\"t\")) ; comment\n:named";
+    Smt2MappedLexer lexer(input);
+    auto texts = textsOf(lexer);
+    std::vector<std::string_view> expected = {"(", "assert", "(", "=", "x", "-12", "3.5", "#x1F", "a b", "s\\\"t", ")", ")", ":named"};
+    EXPECT_EQ(texts, expected);
+    for (auto text : texts) {
+        EXPECT_GE(text.data(), input.data());
+        EXPECT_LE(text.data() + text.size(), input.data() + input.size());
+    }
+}
+
+TEST(MappedLexerTest, test_TokenAtTheEndOfTheMapping) {
+    std::string const input = "(pop 123)";
+    Smt2MappedLexer lexer(std::string_view(input).substr(0, 7));
+    EXPECT_EQ(lexer.next().kind, '(');
+    EXPECT_EQ(lexer.next().text, "pop");
+    auto numeral = lexer.next();
+    EXPECT_EQ(numeral.text, "12");
+    EXPECT_EQ(lexer.next().kind, 0);
+    EXPECT_EQ(lexer.next().kind, 0);
+}
+
+TEST(MappedLexerTest, test_UnterminatedAtTheEndOfTheMapping) {
+    std::string const input = "|ab| \"cd\"";
+    Smt2MappedLexer symbol(std::string_view(input).substr(0, 3));
+    EXPECT_EQ(symbol.next().kind, Smt2MappedLexer::invalidToken);
+    EXPECT_EQ(symbol.getError(), "unterminated quoted symbol");
+    Smt2MappedLexer string(std::string_view(input).substr(5, 3));
+    EXPECT_EQ(string.next().kind, Smt2MappedLexer::invalidToken);
+    EXPECT_EQ(string.getError(), "unterminated string");
+}
+
+TEST(MappedLexerTest, test_InvalidCharacter) {
+    Smt2MappedLexer lexer("(push \x01)");
+    EXPECT_EQ(lexer.next().kind, '(');
+    EXPECT_EQ(lexer.next().text, "push");
+    EXPECT_EQ(lexer.next().kind, Smt2MappedLexer::invalidToken);
+    EXPECT_FALSE(lexer.getError().empty());
+    EXPECT_EQ(lexer.next().kind, ')');
+}
+
+TEST(MappedLexerTest, test_ErrorReportedByTheParser) {
+    Smt2MappedLexer lexer("(set-logic QF_UF)(assert |a\\b|)");
+    Smt2newContext context(lexer);
+    ::testing::internal::CaptureStdout();
+    EXPECT_NE(osmt_yyparse(&context), 0);
+    EXPECT_NE(::testing::internal::GetCapturedStdout().find("not allowed inside | ... |"), std::string::npos);
+}
+
+class MappedInterpretTest : public ::testing::Test {
+protected:
+    MappedInterpretTest() : interpret(config) {}
+
+    std::string run(std::string const & script) {
+        std::FILE * file = std::tmpfile();
+        EXPECT_NE(file, nullptr);
+        std::fputs(script.c_str(), file);
+        std::rewind(file);
+        ::testing::internal::CaptureStdout();
+        interpret.interpMapped(file, false);
+        std::fclose(file);
+        return ::testing::internal::GetCapturedStdout();
+    }
+
+    SMTConfig config;
+    Interpret interpret;
+};
+
+TEST_F(MappedInterpretTest, test_NumbersParsedInPlace) {
+    EXPECT_EQ(run("(set-option :produce-models true)(set-logic QF_LRA)(declare-fun x () Real)"
+                  "(assert (= x (+ 1234567890123456789012345 0.0000000001 (- 1.5))))(check-sat)(get-value (x))"),
+              "sat\n((x (/ 12345678901234567890123435000000001 10000000000)))\n");
+}
+
+TEST_F(MappedInterpretTest, test_DecimalInIntegerLogic) {
+    std::string output = run("(set-logic QF_LIA)(declare-fun x () Int)(assert (= x 1.5))(check-sat)");
+    EXPECT_EQ(output, "(error \"assertion returns an unknown sort\")\n\nsat\n");
+}
+
+}
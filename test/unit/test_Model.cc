@@ -401,4 +401,98 @@ TEST_F(ModelIntegrationTest, testIteWithSubstitution_SubtermsHaveValue) {
     EXPECT_EQ(model->evaluate(c), logic.getTerm_false());
 }
 
+TEST_F(ModelIntegrationTest, testDifferenceLogicValues) {
+    auto osmt = std::unique_ptr<Opensmt>(new Opensmt(opensmt_logic::qf_idl, "test"));
+    ArithLogic& logic = osmt->getLIALogic();
+    PTRef x = logic.mkIntVar("x");
+    PTRef y = logic.mkIntVar("y");
+    PTRef z = logic.mkIntVar("z");
+    PTRef a = logic.mkBoolVar("a");
+    PTRef xy = logic.mkLeq(logic.mkMinus(x, y), logic.mkIntConst(-2));
+    PTRef yz = logic.mkLeq(logic.mkMinus(y, z), logic.mkIntConst(-3));
+    PTRef zx = logic.mkLeq(logic.mkMinus(z, x), logic.mkIntConst(5));
+    PTRef fla = logic.mkAnd({xy, logic.mkOr(a, yz), logic.mkOr(logic.mkNot(a), yz), zx});
+    MainSolver& mainSolver = osmt->getMainSolver();
+    mainSolver.insertFormula(fla);
+    ASSERT_EQ(mainSolver.check(), s_True);
+    auto values = mainSolver.getValues({fla, xy, yz, zx, logic.mkMinus(z, x)});
+    ASSERT_EQ(values.size(), 5);
+    EXPECT_EQ(values[0], logic.getTerm_true());
+    EXPECT_EQ(values[1], logic.getTerm_true());
+    EXPECT_EQ(values[2], logic.getTerm_true());
+    EXPECT_EQ(values[3], logic.getTerm_true());
+    EXPECT_EQ(values[4], logic.mkIntConst(5));
+}
+
+TEST_F(ModelIntegrationTest, testPolarityAwareCnf) {
+    Logic logic{Logic_t::QF_UF};
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_polarity_aware_cnf, SMTOption(true), msg);
+    MainSolver mainSolver(logic, config, "test");
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef d = logic.mkBoolVar("d");
+    PTRef ab = logic.mkAnd(a, b);
+    PTRef cd = logic.mkAnd(c, d);
+    PTRef fla = logic.mkOr(ab, cd);
+    mainSolver.insertFormula(fla);
+    mainSolver.insertFormula(logic.mkOr(logic.mkNot(c), logic.mkNot(d)));
+    ASSERT_EQ(mainSolver.check(), s_True);
+    // The conjunctions are only encoded positively, but their values come from their arguments
+    EXPECT_EQ(mainSolver.getTermValue(ab), l_True);
+    EXPECT_EQ(mainSolver.getTermValue(cd), l_False);
+    EXPECT_EQ(mainSolver.getTermValue(fla), l_True);
+    EXPECT_EQ(mainSolver.getModel()->evaluate(fla), logic.getTerm_true());
+
+    // The negative occurrence needs the other halves of the definitions
+    mainSolver.push();
+    mainSolver.insertFormula(logic.mkNot(fla));
+    EXPECT_EQ(mainSolver.check(), s_False);
+    mainSolver.pop();
+    mainSolver.push();
+    mainSolver.insertFormula(logic.mkNot(ab));
+    EXPECT_EQ(mainSolver.check(), s_False);
+    mainSolver.pop();
+    EXPECT_EQ(mainSolver.check(), s_True);
+}
+
+TEST_F(ModelIntegrationTest, testDefinitionsSharedAcrossFrames) {
+    Logic logic{Logic_t::QF_UF};
+    SMTConfig config;
+    MainSolver mainSolver(logic, config, "test");
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef d = logic.mkBoolVar("d");
+    PTRef ab = logic.mkAnd(a, b);
+    PTRef cd = logic.mkAnd(c, d);
+    PTRef fla = logic.mkXor(ab, cd);
+    mainSolver.push();
+    mainSolver.insertFormula(fla);
+    ASSERT_EQ(mainSolver.check(), s_True);
+    mainSolver.pop();
+    ASSERT_EQ(mainSolver.check(), s_True);
+    int const clausesBefore = mainSolver.getSMTSolver().nClauses();
+
+    // The definitions stay, only the assertion is added again
+    mainSolver.push();
+    mainSolver.insertFormula(fla);
+    ASSERT_EQ(mainSolver.check(), s_True);
+    EXPECT_LE(mainSolver.getSMTSolver().nClauses(), clausesBefore + 1);
+    mainSolver.insertFormula(logic.mkNot(ab));
+    mainSolver.insertFormula(logic.mkNot(cd));
+    EXPECT_EQ(mainSolver.check(), s_False);
+    mainSolver.pop();
+
+    // The definitions do not force the popped assertion
+    mainSolver.push();
+    mainSolver.insertFormula(logic.mkNot(fla));
+    mainSolver.insertFormula(ab);
+    ASSERT_EQ(mainSolver.check(), s_True);
+    EXPECT_EQ(mainSolver.getTermValue(cd), l_True);
+    mainSolver.pop();
+}
+
 }
@@ -93,6 +93,32 @@ TEST(ProofTest, test_mergeClauses_PivotAfterFirstEnd) {
 
 // Reduction algorithms
 
+TEST(ProofTest, test_FlatLists_GrowAndCompact) {
+    FlatLists<clauseid_t> lists;
+    FlatLists<clauseid_t>::List first;
+    FlatLists<clauseid_t>::List second;
+    lists.insertSorted(first, 5);
+    lists.insertSorted(second, 7);
+    // The first list moves past the second one when it grows
+    for (clauseid_t id : {3u, 9u, 1u, 5u}) {
+        lists.insertSorted(first, id);
+    }
+    lists.eraseSorted(second, 7);
+    lists.insertSorted(second, 2);
+    EXPECT_EQ(std::vector<clauseid_t>(lists.view(first).begin(), lists.view(first).end()),
+              (std::vector<clauseid_t>{1, 3, 5, 9}));
+    EXPECT_GT(lists.unusedSize(), 0);
+    lists.compact([&](auto const & visit) {
+        visit(second);
+        visit(first);
+    });
+    EXPECT_EQ(lists.unusedSize(), 0);
+    EXPECT_EQ(lists.usedSize(), 5);
+    EXPECT_TRUE(lists.containsSorted(first, 9));
+    EXPECT_FALSE(lists.containsSorted(first, 2));
+    EXPECT_EQ(lists.view(second)[0], 2);
+}
+
 class ReductionTest : public ::testing::Test {
 protected:
     ReductionTest(): logic{Logic_t::QF_BOOL}, config{}, theory{config, logic}, partitionManager{logic}, termMapper{logic}, ca{}, proof{ca} {}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <api/MainSolver.h>
+#include <logics/ArithLogic.h>
+#include <smtsolvers/ProofTrace.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+namespace opensmt {
+
+class ProofTraceTest : public ::testing::Test {
+protected:
+    // Every test writes its own file, so that the tests can run in parallel
+    ProofTraceTest()
+        : traceFile(::testing::TempDir() + "opensmt_proof_trace_" +
+                    ::testing::UnitTest::GetInstance()->current_test_info()->name() + "_" + std::to_string(getpid()) +
+                    ".bin") {
+        char const * msg = "ok";
+        config.setOption(SMTConfig::o_proof_trace, SMTOption(traceFile.c_str()), msg);
+    }
+    ~ProofTraceTest() override { std::remove(traceFile.c_str()); }
+
+    bool checkTrace(ProofTraceChecker & checker) const {
+        std::ifstream in(traceFile, std::ios::in | std::ios::binary);
+        return checker.check(in);
+    }
+
+    std::string traceFile;
+    SMTConfig config;
+};
+
+TEST_F(ProofTraceTest, test_PigeonholeRefutation) {
+    Logic logic{Logic_t::QF_BOOL};
+    {
+        MainSolver solver(logic, config, "trace");
+        constexpr int holes = 5;
+        auto in = [&](int pigeon, int hole) {
+            return logic.mkBoolVar(("p" + std::to_string(pigeon) + "h" + std::to_string(hole)).c_str());
+        };
+        for (int p = 0; p <= holes; ++p) {
+            vec<PTRef> holesOfPigeon;
+            for (int h = 0; h < holes; ++h) {
+                holesOfPigeon.push(in(p, h));
+            }
+            solver.insertFormula(logic.mkOr(std::move(holesOfPigeon)));
+        }
+        for (int h = 0; h < holes; ++h) {
+            for (int p = 0; p <= holes; ++p) {
+                for (int q = p + 1; q <= holes; ++q) {
+                    solver.insertFormula(logic.mkOr(logic.mkNot(in(p, h)), logic.mkNot(in(q, h))));
+                }
+            }
+        }
+        ASSERT_EQ(solver.check(), s_False);
+    }
+    ProofTraceChecker checker;
+    ASSERT_TRUE(checkTrace(checker)) << checker.getError();
+    EXPECT_TRUE(checker.refutes());
+    EXPECT_GT(checker.getStats().additions, 1u);
+    EXPECT_EQ(checker.getStats().unmatchedDeletions, 0u);
+}
+
+TEST_F(ProofTraceTest, test_TheoryLemmas) {
+    ArithLogic logic{Logic_t::QF_LRA};
+    {
+        MainSolver solver(logic, config, "trace");
+        PTRef x = logic.mkRealVar("x");
+        PTRef y = logic.mkRealVar("y");
+        PTRef z = logic.mkRealVar("z");
+        PTRef b = logic.mkBoolVar("b");
+        // x < y < z < x, with two of the bounds behind a case split on b
+        solver.insertFormula(logic.mkOr(logic.mkLt(x, y), b));
+        solver.insertFormula(logic.mkOr(logic.mkLt(x, y), logic.mkNot(b)));
+        solver.insertFormula(logic.mkOr(logic.mkLt(z, x), b));
+        solver.insertFormula(logic.mkOr(logic.mkLt(z, x), logic.mkNot(b)));
+        solver.insertFormula(logic.mkLt(y, z));
+        ASSERT_EQ(solver.check(), s_False);
+    }
+    ProofTraceChecker checker;
+    std::size_t lemmasWithAtoms = 0;
+    checker.onTheoryLemma([&](std::vector<Lit> const & clause, std::vector<std::string> const & atoms) {
+        ASSERT_EQ(clause.size(), atoms.size());
+        if (std::none_of(atoms.begin(), atoms.end(), [](auto const & atom) { return atom.empty(); })) {
+            ++lemmasWithAtoms;
+        }
+    });
+    ASSERT_TRUE(checkTrace(checker)) << checker.getError();
+    EXPECT_TRUE(checker.refutes());
+    EXPECT_GT(checker.getStats().theoryLemmas, 0u);
+    EXPECT_EQ(lemmasWithAtoms, checker.getStats().theoryLemmas);
+}
+
+TEST_F(ProofTraceTest, test_RejectsUnimpliedClause) {
+    Lit a = mkLit(0), b = mkLit(1);
+    {
+        ProofTraceWriter writer(traceFile);
+        writer.input(vec<Lit>{a, b});
+        writer.input(vec<Lit>{~a, b});
+        writer.addition(vec<Lit>{b});
+        writer.deletion(vec<Lit>{b, ~a});
+        writer.addition(vec<Lit>{~a});
+    }
+    ProofTraceChecker checker;
+    EXPECT_FALSE(checkTrace(checker));
+    EXPECT_FALSE(checker.refutes());
+    EXPECT_EQ(checker.getStats().additions, 2u);
+    EXPECT_EQ(checker.getStats().deletions, 1u);
+}
+
+} // namespace opensmt
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include <logics/ArithLogic.h>
 #include <logics/Logic.h>
 #include <api/MainSolver.h>
 #include <common/VerificationUtils.h>
@@ -178,4 +179,132 @@ TEST_F(ResolutionProofIncrementalInterpolationTest, test_McMillanInterpolant) {
     ASSERT_TRUE(verifyInterpolant(A_part, B_part, itp));
 }
 
+// Pigeonhole problem, hard enough for the solver to delete learnt clauses and collect garbage while logging the proof
+TEST(ResolutionProofGarbageTest, test_InterpolantAfterClauseDeletion) {
+    Logic logic{Logic_t::QF_UF};
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    MainSolver solver(logic, config, "test");
+    constexpr int holes = 6;
+    auto in = [&](int pigeon, int hole) {
+        return logic.mkBoolVar(("p" + std::to_string(pigeon) + "h" + std::to_string(hole)).c_str());
+    };
+    vec<PTRef> somewhere;
+    for (int p = 0; p <= holes; ++p) {
+        vec<PTRef> holesOfPigeon;
+        for (int h = 0; h < holes; ++h) {
+            holesOfPigeon.push(in(p, h));
+        }
+        somewhere.push(logic.mkOr(std::move(holesOfPigeon)));
+    }
+    vec<PTRef> alone;
+    for (int h = 0; h < holes; ++h) {
+        for (int p = 0; p <= holes; ++p) {
+            for (int q = p + 1; q <= holes; ++q) {
+                alone.push(logic.mkOr(logic.mkNot(in(p, h)), logic.mkNot(in(q, h))));
+            }
+        }
+    }
+    PTRef A = logic.mkAnd(std::move(somewhere));
+    PTRef B = logic.mkAnd(std::move(alone));
+    solver.insertFormula(A);
+    solver.insertFormula(B);
+    ASSERT_EQ(solver.check(), s_False);
+
+    auto itpContext = solver.getInterpolationContext();
+    vec<PTRef> itps;
+    ipartitions_t A_mask = 1;
+    itpContext->getSingleInterpolant(itps, A_mask);
+    EXPECT_TRUE(VerificationUtils(logic).verifyInterpolantInternal(A, B, itps.last()));
+}
+
+// A cycle x0 < x1 < ... < x5 < x0 split into one partition per inequality, all prefixes interpolated at once
+TEST(SequenceInterpolationTest, test_SharedTraversalMatchesSingleInterpolants) {
+    ArithLogic logic{Logic_t::QF_LRA};
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    MainSolver solver(logic, config, "test");
+    constexpr int length = 6;
+    vec<PTRef> partitions;
+    for (int i = 0; i < length; ++i) {
+        PTRef from = logic.mkRealVar(("x" + std::to_string(i)).c_str());
+        PTRef to = logic.mkRealVar(("x" + std::to_string((i + 1) % length)).c_str());
+        // A Boolean case split, so that the proof also has resolution steps on shared variables
+        PTRef split = logic.mkBoolVar(("b" + std::to_string(i)).c_str());
+        partitions.push(logic.mkAnd(logic.mkOr(split, logic.mkLt(from, to)),
+                                    logic.mkOr(logic.mkNot(split), logic.mkLt(from, to))));
+        solver.insertFormula(partitions.last());
+    }
+    ASSERT_EQ(solver.check(), s_False);
+
+    auto itpContext = solver.getInterpolationContext();
+    std::vector<ipartitions_t> A_masks;
+    for (int i = 0; i < length - 1; ++i) {
+        ipartitions_t A_mask = A_masks.empty() ? 0 : A_masks.back();
+        setbit(A_mask, static_cast<unsigned int>(i));
+        A_masks.push_back(A_mask);
+    }
+    vec<PTRef> itps;
+    ASSERT_TRUE(itpContext->getPathInterpolants(itps, A_masks));
+    ASSERT_EQ(itps.size(), length - 1);
+    for (int i = 0; i < length - 1; ++i) {
+        vec<PTRef> single;
+        itpContext->getSingleInterpolant(single, A_masks[i]);
+        EXPECT_EQ(single.last(), itps[i]);
+        vec<PTRef> A, B;
+        for (int j = 0; j < length; ++j) {
+            (j <= i ? A : B).push(partitions[j]);
+        }
+        EXPECT_TRUE(VerificationUtils(logic).verifyInterpolantInternal(logic.mkAnd(A), logic.mkAnd(B), itps[i]));
+    }
+
+    // The same traversal serves arbitrary partitionings, e.g. the subtrees of a tree interpolation problem
+    vec<PTRef> treeItps;
+    std::vector<vec<int>> treePartitions(3);
+    treePartitions[0] = {0, 2};
+    treePartitions[1] = {1};
+    treePartitions[2] = {3, 4, 5};
+    itpContext->getInterpolants(treePartitions, treeItps);
+    ASSERT_EQ(treeItps.size(), 3);
+    EXPECT_TRUE(VerificationUtils(logic).verifyInterpolantInternal(
+        logic.mkAnd(partitions[0], partitions[2]), logic.mkAnd({partitions[1], partitions[3], partitions[4], partitions[5]}),
+        treeItps[0]));
+}
+
+// The same cycle with the interpolants swept for equivalent subformulas
+TEST(SequenceInterpolationTest, test_SweptInterpolants) {
+    ArithLogic logic{Logic_t::QF_LRA};
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_produce_inter, SMTOption(true), msg);
+    config.setOption(SMTConfig::o_simplify_inter, SMTOption(5), msg);
+    MainSolver solver(logic, config, "test");
+    constexpr int length = 4;
+    vec<PTRef> partitions;
+    for (int i = 0; i < length; ++i) {
+        PTRef from = logic.mkRealVar(("x" + std::to_string(i)).c_str());
+        PTRef to = logic.mkRealVar(("x" + std::to_string((i + 1) % length)).c_str());
+        PTRef split = logic.mkBoolVar(("b" + std::to_string(i)).c_str());
+        partitions.push(logic.mkAnd(logic.mkOr(split, logic.mkLt(from, to)),
+                                    logic.mkOr(logic.mkNot(split), logic.mkLt(from, to))));
+        solver.insertFormula(partitions.last());
+    }
+    ASSERT_EQ(solver.check(), s_False);
+
+    auto itpContext = solver.getInterpolationContext();
+    for (int i = 0; i < length - 1; ++i) {
+        ipartitions_t A_mask = 0;
+        vec<PTRef> A, B;
+        for (int j = 0; j < length; ++j) {
+            if (j <= i) { setbit(A_mask, static_cast<unsigned int>(j)); }
+            (j <= i ? A : B).push(partitions[j]);
+        }
+        vec<PTRef> itps;
+        itpContext->getSingleInterpolant(itps, A_mask);
+        EXPECT_TRUE(VerificationUtils(logic).verifyInterpolantInternal(logic.mkAnd(A), logic.mkAnd(B), itps.last()));
+    }
+}
+
 }
@@ -10,6 +10,7 @@
 #include <logics/ArithLogic.h>
 #include <simplifiers/BoolRewriting.h>
 #include <logics/Logic.h>
+#include <logics/UFLATheory.h>
 #include <rewriters/ArithmeticEqualityRewriter.h>
 #include <api/MainSolver.h>
 #include <rewriters/Rewritings.h>
@@ -64,6 +65,87 @@ TEST(Rewriting_test, test_RewriteClassicUnderNegation)
     ASSERT_EQ(res, logic.mkNot(logic.mkAnd({a,b,c})));
 }
 
+namespace {
+// Conjuncts over disjoint variables, except that every third one shares a variable with the previous one
+PTRef mkIndependentConjuncts(Logic & logic, int count) {
+    vec<PTRef> conjuncts;
+    for (int i = 0; i < count; ++i) {
+        std::string suffix = std::to_string(i % 3 == 2 ? i - 1 : i);
+        PTRef a = logic.mkBoolVar(("a" + suffix).c_str());
+        PTRef b = logic.mkBoolVar(("b" + std::to_string(i)).c_str());
+        PTRef c = logic.mkBoolVar(("c" + std::to_string(i)).c_str());
+        conjuncts.push(logic.mkOr(logic.mkOr(a, logic.mkNot(b)), logic.mkAnd(b, c)));
+    }
+    return logic.mkAnd(std::move(conjuncts));
+}
+} // namespace
+
+TEST(Rewriting_test, test_IndependentConjuncts)
+{
+    Logic logic{Logic_t::QF_UF};
+    PTRef fla = mkIndependentConjuncts(logic, 9);
+    auto groups = independentConjuncts(logic, fla);
+    ASSERT_EQ(groups.size(), 6);
+    int conjuncts = 0;
+    for (auto const & group : groups) {
+        EXPECT_LE(group.size(), 2);
+        conjuncts += group.size();
+    }
+    EXPECT_EQ(conjuncts, 9);
+}
+
+TEST(Rewriting_test, test_RewriteParallelDoesNotDependOnThreads)
+{
+    std::vector<std::string> printed;
+    std::vector<uint32_t> refs;
+    for (unsigned threads : {1, 2, 4}) {
+        Logic logic{Logic_t::QF_UF};
+        PTRef fla = mkIndependentConjuncts(logic, 60);
+        PTRef res = rewriteMaxArityParallel(logic, fla, threads);
+        printed.push_back(logic.pp(res));
+        refs.push_back(res.x);
+        // Every or is flattened, as in the classic rewriting
+        EXPECT_EQ(logic.getPterm(res).size(), logic.getPterm(rewriteMaxArityClassic(logic, fla)).size());
+    }
+    EXPECT_EQ(printed[0], printed[1]);
+    EXPECT_EQ(printed[0], printed[2]);
+    EXPECT_EQ(refs[0], refs[1]);
+    EXPECT_EQ(refs[0], refs[2]);
+}
+
+TEST(Rewriting_test, test_RewriteParallelFallsBackWhenOutOfRoom)
+{
+    Logic serialLogic{Logic_t::QF_UF};
+    PTRef expected = rewriteMaxArityClassic(serialLogic, mkIndependentConjuncts(serialLogic, 60));
+    Logic logic{Logic_t::QF_UF};
+    PTRef fla = mkIndependentConjuncts(logic, 60);
+    // The threads run out of the room reserved for their terms
+    PTRef res = rewriteMaxArityParallel(logic, fla, 4, 5);
+    // The terms they built are gone, and the serial rewriting finds the old ones again
+    EXPECT_EQ(res, expected);
+    EXPECT_EQ(logic.pp(res), serialLogic.pp(expected));
+    EXPECT_EQ(logic.getNumberOfTerms(), serialLogic.getNumberOfTerms());
+    EXPECT_NO_THROW(logic.mkBoolVar("fresh")); // The construction has ended
+}
+
+TEST(Rewriting_test, test_ParallelPreprocessingInSolver)
+{
+    Logic logic{Logic_t::QF_UF};
+    PTRef fla = mkIndependentConjuncts(logic, 30);
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_preprocessing_threads, SMTOption(4), msg);
+    MainSolver solver(logic, config, "test");
+    solver.insertFormula(fla);
+    EXPECT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(logic.mkAnd(logic.mkBoolVar("b5"), logic.mkNot(logic.mkBoolVar("c5"))));
+    solver.insertFormula(logic.mkNot(logic.mkBoolVar("a4")));
+    EXPECT_EQ(solver.check(), s_False);
+    solver.pop();
+    EXPECT_EQ(solver.check(), s_True);
+}
+
 TEST(Rewriting_test, test_RewriteEquality)
 {
     ArithLogic logic{Logic_t::QF_LRA};
@@ -76,6 +158,138 @@ TEST(Rewriting_test, test_RewriteEquality)
     ASSERT_EQ(res, rewriter.rewrite(res));
 }
 
+TEST(Rewriting_test, test_SweepAbsorption)
+{
+    Logic logic{Logic_t::QF_UF};
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    PTRef c = logic.mkBoolVar("c");
+    // (and c (or a (and a b))) is equivalent to (and c a)
+    PTRef fla = logic.mkAnd(c, logic.mkOr(a, logic.mkAnd(a, b)));
+    ASSERT_EQ(sweepEquivalentSubformulas(logic, fla), logic.mkAnd(c, a));
+}
+
+TEST(Rewriting_test, test_SweepComplement)
+{
+    Logic logic{Logic_t::QF_UF};
+    PTRef a = logic.mkBoolVar("a");
+    PTRef b = logic.mkBoolVar("b");
+    PTRef c = logic.mkBoolVar("c");
+    PTRef x = logic.mkBoolVar("x");
+    PTRef y = logic.mkBoolVar("y");
+    PTRef f = logic.mkOr(logic.mkAnd(a, b), c);
+    PTRef g = logic.mkAnd(logic.mkOr(logic.mkNot(a), logic.mkNot(b)), logic.mkNot(c));
+    // g is the complement of f
+    PTRef fla = logic.mkAnd(logic.mkOr(f, x), logic.mkOr(g, y));
+    // Whichever of f and g is visited first represents the other
+    PTRef res = sweepEquivalentSubformulas(logic, fla);
+    ASSERT_TRUE(res == logic.mkAnd(logic.mkOr(f, x), logic.mkOr(logic.mkNot(f), y))
+                or res == logic.mkAnd(logic.mkOr(logic.mkNot(g), x), logic.mkOr(g, y)));
+}
+
+TEST(Rewriting_test, test_SweepConstants)
+{
+    ArithLogic logic{Logic_t::QF_LRA};
+    PTRef x = logic.mkRealVar("x");
+    PTRef p = logic.mkLeq(x, logic.getTerm_RealZero());
+    PTRef q = logic.mkBoolVar("q");
+    // (or (and p q) (not p) (not q)) is valid regardless of what the atoms mean
+    PTRef valid = logic.mkOr({logic.mkAnd(p, q), logic.mkNot(p), logic.mkNot(q)});
+    ASSERT_EQ(sweepEquivalentSubformulas(logic, valid), logic.getTerm_true());
+    ASSERT_EQ(sweepEquivalentSubformulas(logic, logic.mkAnd(q, logic.mkNot(valid))), logic.getTerm_false());
+    // Formulas over too many atoms are kept
+    vec<PTRef> atoms;
+    for (int i = 0; i < 10; ++i) {
+        atoms.push(logic.mkBoolVar(("v" + std::to_string(i)).c_str()));
+    }
+    PTRef wide = logic.mkOr(atoms);
+    ASSERT_EQ(sweepEquivalentSubformulas(logic, wide), wide);
+}
+
+TEST(Rewriting_test, test_RewriteCardinality)
+{
+    ArithLogic logic{Logic_t::QF_LIA};
+    vec<PTRef> ites;
+    for (int i = 0; i < 3; ++i) {
+        PTRef b = logic.mkBoolVar(("b" + std::to_string(i)).c_str());
+        ites.push(logic.mkIte(b, logic.getTerm_IntOne(), logic.getTerm_IntZero()));
+    }
+    PTRef atMostOne = logic.mkLeq(logic.mkPlus(ites), logic.getTerm_IntOne());
+    PTRef rewritten = rewriteCardinalities(logic, atMostOne);
+    ASSERT_TRUE(logic.isBooleanOperator(rewritten));
+    // A single ite, e.g., in the definition of its auxiliary variable, is kept
+    PTRef single = logic.mkLeq(ites[0], logic.getTerm_IntZero());
+    ASSERT_EQ(rewriteCardinalities(logic, single), single);
+}
+
+TEST(Rewriting_test, test_CardinalityEncodingInSolver)
+{
+    ArithLogic logic{Logic_t::QF_LIA};
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_encode_cardinalities, SMTOption(true), msg);
+    MainSolver solver(logic, config, "test");
+    vec<PTRef> conditions;
+    for (int i = 0; i < 3; ++i) {
+        conditions.push(logic.mkBoolVar(("b" + std::to_string(i)).c_str()));
+    }
+    // 3 * [b0] + 2 * [b1] + [not b2] >= 3
+    vec<PTRef> ites{logic.mkIte(conditions[0], logic.mkIntConst(3), logic.getTerm_IntZero()),
+                    logic.mkIte(conditions[1], logic.mkIntConst(2), logic.getTerm_IntZero()),
+                    logic.mkIte(conditions[2], logic.getTerm_IntZero(), logic.getTerm_IntOne())};
+    solver.insertFormula(logic.mkGeq(logic.mkPlus(ites), logic.mkIntConst(3)));
+    for (int assignment = 0; assignment < 8; ++assignment) {
+        vec<PTRef> assumptions;
+        for (int i = 0; i < 3; ++i) {
+            assumptions.push(assignment & (1 << i) ? conditions[i] : logic.mkNot(conditions[i]));
+        }
+        int weight = (assignment & 1 ? 3 : 0) + (assignment & 2 ? 2 : 0) + (assignment & 4 ? 0 : 1);
+        EXPECT_EQ(solver.checkAssuming(assumptions), weight >= 3 ? s_True : s_False) << "assignment " << assignment;
+    }
+}
+
+TEST(Rewriting_test, test_CardinalityEncodingWithUninterpretedFunctions)
+{
+    ArithLogic logic{Logic_t::QF_UFLIA};
+    SMTConfig config;
+    char const * msg = "ok";
+    config.setOption(SMTConfig::o_encode_cardinalities, SMTOption(true), msg);
+    MainSolver solver(logic, config, "test");
+    SymRef f = logic.declareFun("f", logic.getSort_int(), {logic.getSort_int()});
+    PTRef x = logic.mkIntVar("x");
+    vec<PTRef> conditions;
+    vec<PTRef> ites;
+    for (int i = 0; i < 3; ++i) {
+        conditions.push(logic.mkBoolVar(("b" + std::to_string(i)).c_str()));
+        ites.push(logic.mkIte(conditions[i], logic.getTerm_IntOne(), logic.getTerm_IntZero()));
+    }
+    PTRef atMostOne = logic.mkLeq(logic.mkPlus(ites), logic.getTerm_IntOne());
+    PTRef fla = logic.mkAnd(atMostOne, logic.mkEq(logic.mkUninterpFun(f, {x}), x));
+
+    // The sum is encoded before the uninterpreted functions are purified
+    UFLATheory theory(config, logic);
+    PTRef preprocessed = theory.preprocessAfterSubstitutions(fla, PreprocessingContext{});
+    std::vector<PTRef> queue{preprocessed};
+    while (not queue.empty()) {
+        PTRef tr = queue.back();
+        queue.pop_back();
+        ASSERT_FALSE(logic.isPlus(tr)) << logic.pp(tr);
+        for (PTRef child : logic.getPterm(tr)) {
+            queue.push_back(child);
+        }
+    }
+
+    solver.insertFormula(fla);
+    for (int assignment = 0; assignment < 8; ++assignment) {
+        vec<PTRef> assumptions;
+        for (int i = 0; i < 3; ++i) {
+            assumptions.push(assignment & (1 << i) ? conditions[i] : logic.mkNot(conditions[i]));
+        }
+        int count = (assignment & 1) + (assignment >> 1 & 1) + (assignment >> 2 & 1);
+        EXPECT_EQ(solver.checkAssuming(assumptions), count <= 1 ? s_True : s_False) << "assignment " << assignment;
+    }
+}
+
 TEST(Rewriting_test, test_RewriteDivMod) {
     ArithLogic logic{Logic_t::QF_LIA};
     PTRef x = logic.mkIntVar("x");
@@ -142,4 +356,32 @@ TEST_F(RewriteDistinctTest, test_RewriteDistinct_Negated) {
     }
 }
 
+TEST_F(RewriteDistinctTest, test_RewriteDistinct_Memo) {
+    PTRef dist = logic.mkDistinct({x, y, z});
+    PTRef fla = logic.mkOr(b, logic.mkNot(dist));
+    RewriteMemo memo;
+    PTRef rewritten = rewriteDistincts(logic, fla, &memo);
+    EXPECT_EQ(rewritten, rewriteDistincts(logic, fla));
+    EXPECT_EQ(memo.getHits(), 0u);
+    // The second call finds the whole formula in the memo
+    EXPECT_EQ(rewriteDistincts(logic, logic.mkAnd(fla, b), &memo), logic.mkAnd(rewritten, b));
+    EXPECT_EQ(memo.getHits(), 1u);
+}
+
+TEST_F(RewriteDistinctTest, test_RewriteDistinct_MemoPop) {
+    PTRef fla1 = logic.mkNot(logic.mkDistinct({x, y}));
+    PTRef fla2 = logic.mkNot(logic.mkDistinct({y, z}));
+    RewriteMemo memo;
+    rewriteDistincts(logic, fla1, &memo);
+    int sizeBefore = memo.size();
+    memo.push();
+    rewriteDistincts(logic, fla2, &memo);
+    EXPECT_GT(memo.size(), sizeBefore);
+    memo.pop();
+    EXPECT_EQ(memo.size(), sizeBefore);
+    PTRef result;
+    EXPECT_TRUE(memo.peek(fla1, result));
+    EXPECT_FALSE(memo.peek(fla2, result));
+}
+
 }
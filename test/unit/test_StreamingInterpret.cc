@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <api/Interpret.h>
+
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace opensmt {
+
+namespace {
+// Reports every check-sat as it happens
+class RecordingInterpret : public Interpret {
+public:
+    using Interpret::Interpret;
+    std::promise<sstat> firstCheck;
+
+protected:
+    sstat checkSat() override {
+        sstat res = Interpret::checkSat();
+        if (++checks == 1) { firstCheck.set_value(res); }
+        return res;
+    }
+
+private:
+    int checks = 0;
+};
+}
+
+class StreamingInterpretTest : public ::testing::Test {
+protected:
+    StreamingInterpretTest() : interpret(config) {
+        int fds[2];
+        EXPECT_EQ(pipe(fds), 0);
+        in = fdopen(fds[0], "r");
+        writeEnd = fds[1];
+    }
+    ~StreamingInterpretTest() override {
+        closeInput();
+        std::fclose(in);
+    }
+
+    void send(std::string const & text) const {
+        ASSERT_EQ(write(writeEnd, text.data(), text.size()), static_cast<ssize_t>(text.size()));
+    }
+
+    void closeInput() {
+        if (writeEnd >= 0) { close(writeEnd); }
+        writeEnd = -1;
+    }
+
+    SMTConfig config;
+    RecordingInterpret interpret;
+    FILE * in;
+    int writeEnd;
+};
+
+TEST_F(StreamingInterpretTest, test_SeveralCommands) {
+    send("(set-logic QF_UF)\n(declare-fun a () Bool)(assert a)\n(check-sat)\n(push 1)(assert (not a))(check-sat)\n(pop 1)\n");
+    closeInput();
+    ::testing::internal::CaptureStdout();
+    EXPECT_EQ(interpret.interpStream(in), 0);
+    EXPECT_EQ(::testing::internal::GetCapturedStdout(), "sat\nunsat\n");
+}
+
+TEST_F(StreamingInterpretTest, test_CommandSplitAcrossReads) {
+    std::thread writer([this]() {
+        send("(set-logic QF_UF)(declare-fun a () Bool)(declare-fun b () Bool)(assert (and a");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        send(" (not b)))(che");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        send("ck-sat)");
+        closeInput();
+    });
+    ::testing::internal::CaptureStdout();
+    EXPECT_EQ(interpret.interpStream(in), 0);
+    writer.join();
+    EXPECT_EQ(::testing::internal::GetCapturedStdout(), "sat\n");
+}
+
+TEST_F(StreamingInterpretTest, test_CheckSatBeforeLaterInput) {
+    std::future<sstat> firstCheck = interpret.firstCheck.get_future();
+    std::thread writer([this, &firstCheck]() {
+        send("(set-logic QF_UF)(declare-fun a () Bool)(assert a)(check-sat)\n");
+        // The answer must not wait for the rest of the input
+        EXPECT_EQ(firstCheck.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        send("(assert (not a))(check-sat)(exit)");
+        closeInput();
+    });
+    ::testing::internal::CaptureStdout();
+    EXPECT_EQ(interpret.interpStream(in), 0);
+    writer.join();
+    EXPECT_EQ(::testing::internal::GetCapturedStdout(), "sat\nunsat\n");
+    EXPECT_TRUE(interpret.gotExit());
+}
+
+// The pipe reader reads the standard input, the fixture replaces it with a pipe
+class PipeInterpretTest : public ::testing::Test {
+protected:
+    PipeInterpretTest() : interpret(config) {
+        int fds[2];
+        EXPECT_EQ(pipe(fds), 0);
+        savedStdin = dup(STDIN_FILENO);
+        dup2(fds[0], STDIN_FILENO);
+        close(fds[0]);
+        writeEnd = fds[1];
+    }
+    ~PipeInterpretTest() override {
+        dup2(savedStdin, STDIN_FILENO);
+        close(savedStdin);
+    }
+
+    // Writes the input from another thread, since it does not fit the pipe
+    std::string run(std::string const & input) {
+        std::thread writer([this, &input]() {
+            for (std::size_t written = 0; written < input.size();) {
+                ssize_t res = write(writeEnd, input.data() + written, input.size() - written);
+                ASSERT_GT(res, 0);
+                written += static_cast<std::size_t>(res);
+            }
+            close(writeEnd);
+        });
+        ::testing::internal::CaptureStdout();
+        EXPECT_EQ(interpret.interpPipe(), 0);
+        writer.join();
+        return ::testing::internal::GetCapturedStdout();
+    }
+
+    static constexpr std::size_t initialBufferSize = 1 << 16;
+
+    SMTConfig config;
+    Interpret interpret;
+    int savedStdin;
+    int writeEnd;
+};
+
+TEST_F(PipeInterpretTest, test_CommandStraddlesCompaction) {
+    std::string input = "(set-logic QF_UF)(declare-fun a () Bool)(declare-fun b () Bool)";
+    std::string const padding = "(assert a)\n";
+    std::string const straddling = "(assert (and b (not a)))";
+    // The command crosses the end of the full buffer, so only it is moved when the buffer is compacted
+    std::size_t const straddlingStart = initialBufferSize - straddling.size() / 2;
+    while (input.size() + padding.size() <= straddlingStart) {
+        input += padding;
+    }
+    input.resize(straddlingStart, ' ');
+    input += straddling + "(check-sat)";
+    EXPECT_EQ(run(input), "unsat\n");
+}
+
+TEST_F(PipeInterpretTest, test_CommandLargerThanBuffer) {
+    std::string input = "(set-logic QF_UF)(declare-fun a () Bool)(declare-fun b () Bool)(assert (or";
+    for (int i = 0; input.size() < 3 * initialBufferSize; ++i) {
+        input += i % 2 == 0 ? " (and a b)" : " (not a)";
+    }
+    input += "))(check-sat)(assert (not b))(check-sat)(assert a)(check-sat)";
+    EXPECT_EQ(run(input), "sat\nsat\nunsat\n");
+}
+
+}
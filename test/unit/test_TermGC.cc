@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <common/ApiException.h>
+#include <itehandler/IteHandler.h>
+#include <logics/ArithLogic.h>
+
+namespace opensmt {
+
+class TermGCTest : public ::testing::Test {
+protected:
+    TermGCTest() : logic{Logic_t::QF_UFLRA} {
+        x = logic.mkRealVar("x");
+        y = logic.mkRealVar("y");
+        p = logic.mkBoolVar("p");
+        q = logic.mkBoolVar("q");
+    }
+
+    PTRef mkKept() {
+        return logic.mkAnd(logic.mkOr(p, logic.mkLeq(x, y)), logic.mkNot(logic.mkEq(logic.mkPlus(x, y), x)));
+    }
+
+    ArithLogic logic;
+    PTRef x, y, p, q;
+};
+
+TEST_F(TermGCTest, test_DropsUnreachableTerms) {
+    PTRef kept = mkKept();
+    std::string printed = logic.pp(kept);
+    for (int i = 0; i < 100; ++i) {
+        PTRef c = logic.mkRealConst(Number(i));
+        logic.mkOr(q, logic.mkLt(logic.mkTimes(c, x), y));
+    }
+    std::size_t before = logic.getNumberOfTerms();
+    vec<PTRef> roots{kept};
+    EXPECT_GT(logic.collectGarbage(roots), 0);
+    EXPECT_LT(logic.getNumberOfTerms(), before);
+    EXPECT_EQ(logic.pp(roots[0]), printed);
+
+    // The kept terms are still hash-consed, and the variables are found by name
+    x = logic.mkRealVar("x");
+    y = logic.mkRealVar("y");
+    p = logic.mkBoolVar("p");
+    EXPECT_EQ(mkKept(), roots[0]);
+    // The dropped terms can be built again
+    q = logic.mkBoolVar("q");
+    PTRef rebuilt = logic.mkOr(q, logic.mkLt(logic.mkTimes(logic.mkRealConst(Number(7)), x), y));
+    EXPECT_TRUE(logic.isOr(rebuilt));
+}
+
+TEST_F(TermGCTest, test_ChildrenHaveSmallerIds) {
+    logic.mkAnd(p, q);
+    vec<PTRef> roots{mkKept()};
+    logic.collectGarbage(roots);
+    std::vector<PTRef> queue{roots[0]};
+    while (not queue.empty()) {
+        PTRef tr = queue.back();
+        queue.pop_back();
+        for (PTRef child : logic.getPterm(tr)) {
+            ASSERT_LT(Idx(logic.getPterm(child).getId()), Idx(logic.getPterm(tr).getId()));
+            queue.push_back(child);
+        }
+    }
+}
+
+TEST_F(TermGCTest, test_ConstantsOfTheLogicSurvive) {
+    vec<PTRef> roots;
+    logic.collectGarbage(roots);
+    EXPECT_TRUE(logic.isTrue(logic.getTerm_true()));
+    EXPECT_TRUE(logic.isFalse(logic.getTerm_false()));
+    EXPECT_EQ(logic.mkRealConst(Number(0)), logic.getTerm_RealZero());
+    EXPECT_EQ(logic.mkRealConst(Number(1)), logic.getTerm_RealOne());
+    EXPECT_EQ(logic.mkNot(logic.getTerm_true()), logic.getTerm_false());
+}
+
+TEST_F(TermGCTest, test_IteAuxiliaryVariables) {
+    logic.mkAnd(p, q); // Garbage below the ite, so that its reference changes
+    PTRef ite = logic.mkIte(p, x, y);
+    PTRef fla = logic.mkLeq(ite, logic.mkRealConst(Number(3)));
+    PTRef rewritten = IteHandler(logic).rewrite(logic.mkAnd(fla, q));
+    std::string printed = logic.pp(logic.removeAuxVars(rewritten));
+    vec<PTRef> roots{rewritten};
+    logic.collectGarbage(roots);
+    EXPECT_EQ(logic.pp(logic.removeAuxVars(roots[0])), printed);
+}
+
+TEST_F(TermGCTest, test_IteAuxiliarySymbolsAreReused) {
+    logic.mkAnd(p, q); // Garbage below the ites, so that their references change
+    PTRef keptIte = logic.mkIte(p, x, y);
+    PTRef droppedIte = logic.mkIte(q, y, x);
+    PTRef kept = IteHandler(logic).rewrite(logic.mkLeq(keptIte, logic.mkRealConst(Number(3))));
+    IteHandler(logic).rewrite(logic.mkLeq(droppedIte, x));
+    std::string const keptName = std::string(IteHandler::itePrefix) + std::to_string(keptIte.x);
+    std::string const droppedName = std::string(IteHandler::itePrefix) + std::to_string(droppedIte.x);
+    ASSERT_TRUE(logic.hasSym(keptName.c_str()));
+    ASSERT_TRUE(logic.hasSym(droppedName.c_str()));
+    std::string printed = logic.pp(logic.removeAuxVars(kept));
+    std::size_t const symbols = logic.getNumberOfSymbols();
+
+    vec<PTRef> roots{kept};
+    for (int i = 0; i < 3; ++i) {
+        logic.collectGarbage(roots);
+        EXPECT_EQ(logic.getNumberOfSymbols(), symbols);
+        EXPECT_EQ(logic.pp(logic.removeAuxVars(roots[0])), printed);
+    }
+    // Only the surviving variable is found, under the name of its moved ite term
+    EXPECT_FALSE(logic.hasSym(droppedName.c_str()));
+    PTRef movedIte = logic.mkIte(p, x, y);
+    EXPECT_NE(movedIte, keptIte);
+    std::string const movedName = std::string(IteHandler::itePrefix) + std::to_string(movedIte.x);
+    EXPECT_TRUE(logic.hasSym(movedName.c_str()));
+    EXPECT_EQ(IteHandler(logic).rewrite(logic.mkLeq(movedIte, logic.mkRealConst(Number(3)))), roots[0]);
+}
+
+TEST_F(TermGCTest, test_NotDuringConcurrentConstruction) {
+    vec<PTRef> roots;
+    logic.beginConcurrentConstruction(10, 10);
+    EXPECT_THROW(logic.collectGarbage(roots), ApiException);
+    logic.endConcurrentConstruction();
+}
+
+} // namespace opensmt
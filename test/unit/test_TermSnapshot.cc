@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <api/MainSolver.h>
+#include <common/ApiException.h>
+#include <logics/ArithLogic.h>
+#include <logics/TermSnapshot.h>
+#include <options/SMTConfig.h>
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace opensmt {
+
+class TermSnapshotTest : public ::testing::Test {
+protected:
+    static void buildProblem(ArithLogic & logic, vec<PTRef> & frame0, vec<PTRef> & frame1) {
+        SRef U = logic.declareUninterpretedSort("U");
+        SymRef f = logic.declareFun("f", U, {U, U});
+        PTRef a = logic.mkVar(U, "a");
+        PTRef b = logic.mkVar(U, "b");
+        PTRef x = logic.mkRealVar("x");
+        PTRef y = logic.mkRealVar("y");
+        PTRef p = logic.mkBoolVar("p");
+        PTRef fab = logic.mkUninterpFun(f, {a, b});
+        PTRef fba = logic.mkUninterpFun(f, {b, a});
+        frame0.push(logic.mkOr(logic.mkEq(fab, a), logic.mkNot(p)));
+        frame0.push(logic.mkLeq(logic.mkPlus(x, logic.mkTimes(logic.mkRealConst(Number("1/3")), y)),
+                                logic.mkIte(p, x, logic.mkRealConst(2))));
+        frame1.push(logic.mkAnd(p, logic.mkNot(logic.mkEq(fba, a))));
+        frame1.push(logic.mkLt(x, logic.mkRealConst(Number("-1/2"))));
+    }
+
+    static std::string print(Logic const & logic, vec<PTRef> const & terms) {
+        std::string res;
+        for (PTRef tr : terms) {
+            res += logic.pp(tr) + '\n';
+        }
+        return res;
+    }
+};
+
+TEST_F(TermSnapshotTest, test_RoundTrip) {
+    ArithLogic logic{Logic_t::QF_UFLRA};
+    TermSnapshot::Groups groups(2);
+    buildProblem(logic, groups[0], groups[1]);
+    std::stringstream snapshot;
+    TermSnapshot::write(snapshot, logic, groups);
+
+    ArithLogic loaded{Logic_t::QF_UFLRA};
+    TermSnapshot::Groups loadedGroups = TermSnapshot::read(snapshot, loaded);
+    ASSERT_EQ(loadedGroups.size(), 2);
+    for (std::size_t i = 0; i < groups.size(); ++i) {
+        EXPECT_EQ(print(logic, groups[i]), print(loaded, loadedGroups[i]));
+    }
+    // The loaded terms are canonical: building them again gives the same references
+    vec<PTRef> frame0, frame1;
+    buildProblem(loaded, frame0, frame1);
+    for (int i = 0; i < frame0.size(); ++i) {
+        EXPECT_EQ(frame0[i], loadedGroups[0][i]);
+    }
+    for (int i = 0; i < frame1.size(); ++i) {
+        EXPECT_EQ(frame1[i], loadedGroups[1][i]);
+    }
+}
+
+TEST_F(TermSnapshotTest, test_MainSolverFrames) {
+    SMTConfig config;
+    ArithLogic logic{Logic_t::QF_UFLRA};
+    MainSolver solver(logic, config, "snapshot");
+    vec<PTRef> frame0, frame1;
+    buildProblem(logic, frame0, frame1);
+    for (PTRef fla : frame0) {
+        solver.insertFormula(fla);
+    }
+    solver.push();
+    for (PTRef fla : frame1) {
+        solver.insertFormula(fla);
+    }
+    std::stringstream snapshot;
+    solver.saveSnapshot(snapshot);
+    sstat res = solver.check();
+
+    SMTConfig loadedConfig;
+    ArithLogic loaded{Logic_t::QF_UFLRA};
+    MainSolver loadedSolver(loaded, loadedConfig, "loaded");
+    loadedSolver.loadSnapshot(snapshot);
+    EXPECT_EQ(loadedSolver.check(), res);
+    ASSERT_TRUE(loadedSolver.pop());
+    EXPECT_EQ(loadedSolver.check(), s_True);
+    EXPECT_FALSE(loadedSolver.pop());
+}
+
+TEST_F(TermSnapshotTest, test_Errors) {
+    ArithLogic logic{Logic_t::QF_UFLRA};
+    TermSnapshot::Groups groups(2);
+    buildProblem(logic, groups[0], groups[1]);
+    std::stringstream snapshot;
+    TermSnapshot::write(snapshot, logic, groups);
+    std::string data = snapshot.str();
+
+    ArithLogic other{Logic_t::QF_LRA};
+    std::stringstream in(data);
+    EXPECT_THROW(TermSnapshot::read(in, other), ApiException);
+
+    ArithLogic loaded{Logic_t::QF_UFLRA};
+    std::stringstream truncated(data.substr(0, data.size() - sizeof(uint32_t)));
+    EXPECT_THROW(TermSnapshot::read(truncated, loaded), ApiException);
+}
+
+TEST_F(TermSnapshotTest, test_TermsNotMatchingTheirSymbols) {
+    ArithLogic logic{Logic_t::QF_UFLRA};
+    TermSnapshot::Groups groups(2);
+    buildProblem(logic, groups[0], groups[1]);
+    std::stringstream snapshot;
+    TermSnapshot::write(snapshot, logic, groups);
+    std::string const data = snapshot.str();
+    std::vector<uint32_t> words(data.size() / sizeof(uint32_t));
+    std::memcpy(words.data(), data.data(), data.size());
+
+    // The layout of the header and the records, see TermSnapshot.cc
+    uint32_t const numSortSymbols = words[3], numSorts = words[4], numSymbols = words[5], numTerms = words[6];
+    std::size_t const symbolsStart = 10 + 3 * numSortSymbols + 3 * numSorts;
+    std::size_t const termsStart = symbolsStart + 5 * numSymbols;
+    char const * strings = reinterpret_cast<char const *>(words.data() + words.size() - words[9]);
+    auto symbolIndex = [&](std::string const & name) {
+        for (uint32_t i = 0; i < numSymbols; ++i) {
+            if (name == strings + words[symbolsStart + 5 * i]) { return i; }
+        }
+        return numSymbols;
+    };
+    uint32_t const f = symbolIndex("f");
+    uint32_t const plus = symbolIndex("+");
+    ASSERT_LT(f, numSymbols);
+    ASSERT_LT(plus, numSymbols);
+    std::size_t applicationOfF = termsStart;
+    while (applicationOfF < termsStart + 3 * numTerms and words[applicationOfF] != f) {
+        applicationOfF += 3;
+    }
+    ASSERT_LT(applicationOfF, termsStart + 3 * numTerms);
+    ASSERT_EQ(words[applicationOfF + 1], 2);
+
+    auto read = [](std::vector<uint32_t> const & malformed) {
+        ArithLogic loaded{Logic_t::QF_UFLRA};
+        TermSnapshot::read(malformed.data(), malformed.size(), loaded);
+    };
+    std::vector<uint32_t> wrongArity = words;
+    wrongArity[applicationOfF + 1] = 1;
+    EXPECT_THROW(read(wrongArity), ApiException);
+    std::vector<uint32_t> wrongSorts = words;
+    wrongSorts[applicationOfF] = plus;
+    EXPECT_THROW(read(wrongSorts), ApiException);
+    EXPECT_NO_THROW(read(words));
+}
+
+} // namespace opensmt
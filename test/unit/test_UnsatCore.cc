@@ -51,6 +51,22 @@ protected:
     }
 };
 
+template <typename LogicT>
+class AssumptionUnsatCoreTestBase {
+protected:
+    AssumptionUnsatCoreTestBase(Logic_t type) : logic{type} {}
+
+    LogicT logic;
+    SMTConfig config;
+
+    MainSolver makeSolver() {
+        const char* msg = "ok";
+        config.setOption(SMTConfig::o_produce_unsat_cores, SMTOption(true), msg);
+        config.setOption(SMTConfig::o_unsat_cores_from_assumptions, SMTOption(true), msg);
+        return {logic, config, "unsat_core"};
+    }
+};
+
 /// Pure propositional and uninterpreted functions
 template <template<typename> typename TestBaseT>
 class UFUnsatCoreTestTp : public ::testing::Test, public TestBaseT<Logic> {
@@ -85,6 +101,7 @@ protected:
 
 using UFUnsatCoreTest = UFUnsatCoreTestTp<UnsatCoreTestBase>;
 using MinUFUnsatCoreTest = UFUnsatCoreTestTp<MinUnsatCoreTestBase>;
+using AssumptionUFUnsatCoreTest = UFUnsatCoreTestTp<AssumptionUnsatCoreTestBase>;
 
 TEST_F(UFUnsatCoreTest, Bool_Simple) {
     MainSolver solver = makeSolver();
@@ -169,6 +186,132 @@ TEST_F(MinUFUnsatCoreTest, Min_Bool_Simple_Unnamed3) {
     EXPECT_FALSE(isInCore(nb1, coreTerms));
 }
 
+TEST_F(MinUFUnsatCoreTest, Min_Bool_Chain) {
+    // b1 -> b2 -> b3, which is refuted both by ~b3 and by ~b2 directly
+    PTRef c2 = logic.mkOr(nb1, b2);
+    PTRef c3 = logic.mkOr(nb2, b3);
+    for (int alg : {0, 1}) {
+        const char* msg = "ok";
+        config.setOption(SMTConfig::o_minimal_unsat_cores_alg, SMTOption(alg), msg);
+        MainSolver solver = makeSolver();
+        auto & termNames = solver.getTermNames();
+        int i = 0;
+        for (PTRef fla : {b1, c2, c3, nb3, nb2, b4}) {
+            solver.insertFormula(fla);
+            termNames.insert("a" + std::to_string(++i), fla);
+        }
+        ASSERT_EQ(solver.check(), s_False);
+        auto core = solver.getUnsatCore();
+        auto & coreTerms = core->getNamedTerms();
+        EXPECT_TRUE(isInCore(b1, coreTerms));
+        EXPECT_TRUE(isInCore(c2, coreTerms));
+        EXPECT_FALSE(isInCore(b4, coreTerms));
+        if (isInCore(nb2, coreTerms)) {
+            EXPECT_EQ(coreTerms.size(), 3);
+        } else {
+            EXPECT_EQ(coreTerms.size(), 4);
+        }
+    }
+}
+
+TEST_F(UFUnsatCoreTest, Bool_CheckAssuming) {
+    MainSolver solver = makeSolver();
+    solver.insertFormula(logic.mkOr(nb1, b2));
+    solver.insertFormula(logic.mkOr(nb2, b3));
+    ASSERT_EQ(solver.checkAssuming({b1, nb3, b4}), s_False);
+    auto const & unsatAssumptions = solver.getUnsatAssumptions();
+    EXPECT_EQ(unsatAssumptions.size(), 2);
+    EXPECT_TRUE(isInCore(b1, unsatAssumptions));
+    EXPECT_TRUE(isInCore(nb3, unsatAssumptions));
+    // The assertions themselves are still satisfiable
+    ASSERT_EQ(solver.checkAssuming({b1, b4}), s_True);
+    ASSERT_EQ(solver.checkAssuming({nb3, b1}), s_False);
+    EXPECT_EQ(solver.getUnsatAssumptions().size(), 2);
+    EXPECT_THROW(solver.checkAssuming({logic.mkOr(b1, b4)}), ApiException);
+}
+
+TEST_F(UFUnsatCoreTest, Bool_CheckAssumingMany) {
+    MainSolver solver = makeSolver();
+    solver.insertFormula(logic.mkOr(nb1, b2));
+    solver.insertFormula(logic.mkOr(nb2, b3));
+    vec<PTRef> assumptions;
+    for (int i = 0; i < 100; ++i) {
+        PTRef var = logic.mkBoolVar(("x" + std::to_string(i)).c_str());
+        assumptions.push(i % 2 == 0 ? var : logic.mkNot(var));
+        if (i == 30) { assumptions.push(nb3); }
+        if (i == 70) { assumptions.push(b1); }
+    }
+    ASSERT_EQ(solver.checkAssuming(assumptions), s_False);
+    auto const & unsatAssumptions = solver.getUnsatAssumptions();
+    EXPECT_EQ(unsatAssumptions.size(), 2);
+    EXPECT_TRUE(isInCore(b1, unsatAssumptions));
+    EXPECT_TRUE(isInCore(nb3, unsatAssumptions));
+}
+
+TEST_F(AssumptionUFUnsatCoreTest, Assumption_Bool_Simple) {
+    MainSolver solver = makeSolver();
+    EXPECT_FALSE(solver.getSMTSolver().logsResolutionProof());
+    solver.insertFormula(b1);
+    solver.insertFormula(b2);
+    solver.insertFormula(nb1);
+    ASSERT_EQ(solver.check(), s_False);
+    auto core = solver.getUnsatCore();
+    auto & coreTerms = core->getTerms();
+    ASSERT_EQ(coreTerms.size(), 2);
+    EXPECT_TRUE(isInCore(b1, coreTerms));
+    EXPECT_TRUE(isInCore(nb1, coreTerms));
+}
+
+TEST_F(AssumptionUFUnsatCoreTest, Assumption_Bool_PushPop) {
+    MainSolver solver = makeSolver();
+    PTRef c = logic.mkOr(nb1, b2);
+    solver.insertFormula(b1);
+    solver.insertFormula(b3);
+    solver.push();
+    solver.insertFormula(nb1);
+    ASSERT_EQ(solver.check(), s_False);
+    {
+        auto core = solver.getUnsatCore();
+        auto & coreTerms = core->getTerms();
+        ASSERT_EQ(coreTerms.size(), 2);
+        EXPECT_TRUE(isInCore(b1, coreTerms));
+        EXPECT_TRUE(isInCore(nb1, coreTerms));
+    }
+    solver.pop();
+    ASSERT_EQ(solver.check(), s_True);
+    solver.push();
+    solver.insertFormula(c);
+    solver.insertFormula(nb2);
+    ASSERT_EQ(solver.check(), s_False);
+    auto core = solver.getUnsatCore();
+    auto & coreTerms = core->getTerms();
+    ASSERT_EQ(coreTerms.size(), 3);
+    EXPECT_TRUE(isInCore(b1, coreTerms));
+    EXPECT_TRUE(isInCore(c, coreTerms));
+    EXPECT_TRUE(isInCore(nb2, coreTerms));
+}
+
+TEST_F(AssumptionUFUnsatCoreTest, Assumption_Min_Bool_Named) {
+    const char* msg = "ok";
+    config.setOption(SMTConfig::o_minimal_unsat_cores, SMTOption(true), msg);
+    MainSolver solver = makeSolver();
+    PTRef c2 = logic.mkOr(nb1, b2);
+    PTRef c3 = logic.mkOr(nb2, b3);
+    auto & termNames = solver.getTermNames();
+    int i = 0;
+    for (PTRef fla : {b1, c2, c3, nb3, nb2, b4}) {
+        solver.insertFormula(fla);
+        termNames.insert("a" + std::to_string(++i), fla);
+    }
+    ASSERT_EQ(solver.check(), s_False);
+    auto core = solver.getUnsatCore();
+    auto & coreTerms = core->getNamedTerms();
+    EXPECT_TRUE(isInCore(b1, coreTerms));
+    EXPECT_TRUE(isInCore(c2, coreTerms));
+    EXPECT_FALSE(isInCore(b4, coreTerms));
+    EXPECT_EQ(coreTerms.size(), isInCore(nb2, coreTerms) ? 3 : 4);
+}
+
 TEST_F(UFUnsatCoreTest, Bool_ReuseProofChain) {
     // We add three assertions
     // a1 := (b1 or b2) and (b1 or ~b2)